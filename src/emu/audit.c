@@ -12,17 +12,66 @@
 #include "emu.h"
 #include "emuopts.h"
 #include "hash.h"
+#include "hashcache.h"
+#include "unzip.h"
 #include "audit.h"
 #include "harddisk.h"
 #include "sound/samples.h"
 
 
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* how far the parallel audit may hash ahead of the driver being reported */
+#define AUDIT_MAX_FILES			64
+#define AUDIT_MAX_BYTES			(64 * 1024 * 1024)
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _audit_file audit_file;
+struct _audit_file
+{
+	audit_file *		next;				/* next file of the same driver */
+	const rom_entry *	rom;				/* ROM entry being audited */
+	audit_record *		record;				/* record to fill in */
+	emu_file *			file;				/* file being hashed */
+	const char *		validation;			/* hashes to compute */
+	osd_work_item *		workitem;			/* item hashing the file */
+};
+
+
+typedef struct _audit_job audit_job;
+struct _audit_job
+{
+	audit_job *			next;				/* next driver to report */
+	const game_driver *	gamedrv;			/* driver being audited */
+	audit_record *		records;			/* records for all of its images */
+	UINT8 *				fromdriver;			/* TRUE for records of the driver's own ROMs */
+	int					count;				/* number of records */
+	int					anyrequired;		/* TRUE if any of the driver's own ROMs is required */
+	int					allshared;			/* TRUE if all of them are shared with a parent */
+	audit_file *		files;				/* files still being hashed */
+	int					filecount;			/* number of them */
+	UINT64				filebytes;			/* and their total length */
+};
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
-static void audit_one_rom(core_options *options, const rom_entry *rom, const char *regiontag, const game_driver *gamedrv, const char *validation, audit_record *record);
+static void audit_start(core_options *options, const game_driver *gamedrv, const char *validation, osd_work_queue *queue, audit_job *job);
+static int audit_finish(audit_job *job, audit_record **audit);
+static void *audit_hash_callback(void *param, int threadid);
+static emu_file *audit_find_rom(core_options *options, const rom_entry *rom, const char *regiontag, const game_driver *gamedrv, audit_record *record);
+static void audit_rom_status(const rom_entry *rom, const game_driver *gamedrv, audit_record *record);
 static void audit_one_disk(core_options *options, const rom_entry *rom, const game_driver *gamedrv, const char *validation, audit_record *record);
 static int rom_used_by_parent(const game_driver *gamedrv, const hash_collection &romhashes, const game_driver **parent);
 
@@ -44,6 +93,35 @@ INLINE void set_status(audit_record *record, UINT8 status, UINT8 substatus)
 }
 
 
+/*-------------------------------------------------
+    audit_init_caches - set up the caches shared
+    by all audits
+-------------------------------------------------*/
+
+INLINE void audit_init_caches(core_options *options)
+{
+	/* reuse the hashes of files that haven't changed since they were last audited */
+	hashcache_init(*options);
+
+	/* keep the archives shared by parents, clones and BIOSes open between lookups */
+	zip_file_cache_set_limits(options_get_int(options, OPTION_ZIPCACHE), MAX(MIN(options_get_int(options, OPTION_ZIPCACHESIZE), 4095), 0) << 20);
+}
+
+
+/*-------------------------------------------------
+    audit_job_done - determine whether all the
+    files of a job have been hashed
+-------------------------------------------------*/
+
+INLINE int audit_job_done(audit_job *job)
+{
+	for (audit_file *entry = job->files; entry != NULL; entry = entry->next)
+		if (entry->workitem != NULL && !osd_work_item_wait(entry->workitem, 0))
+			return FALSE;
+	return TRUE;
+}
+
+
 
 /***************************************************************************
     CORE FUNCTIONS
@@ -55,18 +133,102 @@ INLINE void set_status(audit_record *record, UINT8 status, UINT8 substatus)
 -------------------------------------------------*/
 
 int audit_images(core_options *options, const game_driver *gamedrv, const char *validation, audit_record **audit)
+{
+	audit_job job;
+
+	audit_init_caches(options);
+
+	/* with no queue, everything is hashed in line */
+	audit_start(options, gamedrv, validation, NULL, &job);
+	return audit_finish(&job, audit);
+}
+
+
+/*-------------------------------------------------
+    audit_images_multi - validate the ROM and
+    disk images for a list of games, hashing
+    files on worker threads; each game is
+    summarized and handed to the callback in
+    the order of the list
+-------------------------------------------------*/
+
+void audit_images_multi(core_options *options, const game_driver * const *drivers, int count, const char *validation, int output, audit_callback callback, void *param)
+{
+	audit_job *head = NULL, **tailptr = &head;
+	int filecount = 0;
+	UINT64 filebytes = 0;
+
+	audit_init_caches(options);
+
+	/* files are found on this thread, since the ZIP cache isn't thread-safe; only the hashing is farmed out */
+	osd_work_queue *queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+
+	for (int drvnum = 0; drvnum < count || head != NULL; )
+	{
+		/* start the next driver, unless we're too far ahead already */
+		if (drvnum < count && (head == NULL || (filecount < AUDIT_MAX_FILES && filebytes < AUDIT_MAX_BYTES)))
+		{
+			audit_job *job = global_alloc(audit_job);
+			audit_start(options, drivers[drvnum++], validation, queue, job);
+			job->next = NULL;
+			*tailptr = job;
+			tailptr = &job->next;
+			filecount += job->filecount;
+			filebytes += job->filebytes;
+
+			/* keep starting drivers until the oldest one is ready to report */
+			if (drvnum < count && !audit_job_done(head))
+				continue;
+		}
+
+		/* report the oldest driver, waiting for its files if need be */
+		audit_job *job = head;
+		head = job->next;
+		if (head == NULL)
+			tailptr = &head;
+		filecount -= job->filecount;
+		filebytes -= job->filebytes;
+
+		audit_record *audit = NULL;
+		int records = audit_finish(job, &audit);
+
+		/* a set with nothing to audit counts as good, just as audit_images() leaves it */
+		int status = CORRECT;
+		if (records > 0 || job->anyrequired)
+			status = audit_summary(job->gamedrv, records, audit, output);
+		(*callback)(job->gamedrv, status, param);
+		if (records > 0)
+			global_free(audit);
+		global_free(job);
+	}
+
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+}
+
+
+/*-------------------------------------------------
+    audit_start - build the records for a game's
+    images, hashing the files that aren't known
+    from the hash cache on the queue (or in line
+    if there is none)
+-------------------------------------------------*/
+
+static void audit_start(core_options *options, const game_driver *gamedrv, const char *validation, osd_work_queue *queue, audit_job *job)
 {
 	machine_config config(*gamedrv);
 	const rom_entry *region, *rom;
 	const rom_source *source;
+	audit_file **tailptr;
 	audit_record *record;
-	int anyfound = FALSE;
-	int anyrequired = FALSE;
-	int allshared = TRUE;
-	int records;
+	UINT8 *fromdriver;
+
+	memset(job, 0, sizeof(*job));
+	job->gamedrv = gamedrv;
+	job->allshared = TRUE;
+	tailptr = &job->files;
 
 	/* determine the number of records we will generate */
-	records = 0;
 	bool source_is_gamedrv = true;
 	for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
 	{
@@ -79,69 +241,153 @@ int audit_images(core_options *options, const game_driver *gamedrv, const char *
 						hash_collection hashes(ROM_GETHASHDATA(rom));
 						if (!hashes.flag(hash_collection::FLAG_NO_DUMP))
 						{
-							anyrequired = TRUE;
+							job->anyrequired = TRUE;
 
-							if (allshared && !rom_used_by_parent(gamedrv, hashes, NULL))
-								allshared = FALSE;
+							if (job->allshared && !rom_used_by_parent(gamedrv, hashes, NULL))
+								job->allshared = FALSE;
 						}
 					}
-					records++;
+					job->count++;
 				}
 
 		source_is_gamedrv = false;
 	}
 
-	if (records > 0)
-	{
-		/* allocate memory for the records */
-		*audit = global_alloc_array_clear(audit_record, records);
-		record = *audit;
+	if (job->count == 0)
+		return;
 
-		/* iterate over ROM sources and regions */
-		bool source_is_gamedrv = true;
-		for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
+	/* allocate memory for the records */
+	job->records = record = global_alloc_array_clear(audit_record, job->count);
+	job->fromdriver = fromdriver = global_alloc_array_clear(UINT8, job->count);
+
+	/* iterate over ROM sources and regions */
+	source_is_gamedrv = true;
+	for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
+	{
+		for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
 		{
-			for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
+			const char *regiontag = ROMREGION_ISLOADBYNAME(region) ? ROM_GETNAME(region) : NULL;
+			for (rom = rom_first_file(region); rom; rom = rom_next_file(rom))
 			{
-				const char *regiontag = ROMREGION_ISLOADBYNAME(region) ? ROM_GETNAME(region) : NULL;
-				for (rom = rom_first_file(region); rom; rom = rom_next_file(rom))
+				/* audit a file */
+				if (ROMREGION_ISROMDATA(region))
 				{
-					/* audit a file */
-					if (ROMREGION_ISROMDATA(region))
-					{
-						audit_one_rom(options, rom, regiontag, gamedrv, validation, record);
-					}
+					emu_file *file = audit_find_rom(options, rom, regiontag, gamedrv, record);
 
-					/* audit a disk */
-					else if (ROMREGION_ISDISKDATA(region))
+					/* hash it in line if we have no queue or the hashes are already known */
+					if (file != NULL && (queue == NULL || file->cached_hashes(validation)))
 					{
-						audit_one_disk(options, rom, gamedrv, validation, record);
+						record->hashes = file->hashes(validation);
+						global_free(file);
+						file = NULL;
 					}
 
-					else
+					/* otherwise queue it, and fill in the status once it's hashed; the worker
+					   reads through the file's ZIP, so that archive stays out of the cache
+					   until audit_finish closes the file, and sets sharing it reopen it */
+					if (file != NULL)
 					{
-						continue;
+						audit_file *entry = global_alloc_clear(audit_file);
+						entry->rom = rom;
+						entry->record = record;
+						entry->file = file;
+						entry->validation = validation;
+						entry->workitem = osd_work_item_queue(queue, audit_hash_callback, entry, 0);
+						*tailptr = entry;
+						tailptr = &entry->next;
+						job->filecount++;
+						job->filebytes += record->length;
 					}
+					else
+						audit_rom_status(rom, gamedrv, record);
+				}
 
-					if (source_is_gamedrv && record->status != AUDIT_STATUS_NOT_FOUND && (allshared || !rom_used_by_parent(gamedrv, record->exphashes, NULL)))
-						anyfound = TRUE;
+				/* audit a disk */
+				else if (ROMREGION_ISDISKDATA(region))
+				{
+					audit_one_disk(options, rom, gamedrv, validation, record);
+				}
 
-					record++;
+				else
+				{
+					continue;
 				}
+
+				*fromdriver++ = source_is_gamedrv;
+				record++;
 			}
-			source_is_gamedrv = false;
 		}
+		source_is_gamedrv = false;
 	}
+}
+
+
+/*-------------------------------------------------
+    audit_finish - wait for a game's files to be
+    hashed and hand back its records
+-------------------------------------------------*/
+
+static int audit_finish(audit_job *job, audit_record **audit)
+{
+	int anyfound = FALSE;
+	int recnum;
+
+	/* fill in the status of each file once it's hashed */
+	while (job->files != NULL)
+	{
+		audit_file *entry = job->files;
+		job->files = entry->next;
+
+		if (entry->workitem != NULL)
+		{
+			while (!osd_work_item_wait(entry->workitem, 10 * osd_ticks_per_second())) ;
+			osd_work_item_release(entry->workitem);
+		}
+		entry->record->hashes = entry->file->hashes(entry->validation);
+		audit_rom_status(entry->rom, job->gamedrv, entry->record);
+
+		global_free(entry->file);
+		global_free(entry);
+	}
+
+	/* see whether we have any of the driver's own images */
+	for (recnum = 0; recnum < job->count; recnum++)
+	{
+		audit_record *record = &job->records[recnum];
+		if (job->fromdriver[recnum] && record->status != AUDIT_STATUS_NOT_FOUND && (job->allshared || !rom_used_by_parent(job->gamedrv, record->exphashes, NULL)))
+		{
+			anyfound = TRUE;
+			break;
+		}
+	}
+	if (job->fromdriver != NULL)
+		global_free(job->fromdriver);
 
 	/* if we found nothing, we don't have the set at all */
-	if (!anyfound && anyrequired)
+	if (!anyfound && job->anyrequired)
 	{
-		global_free(*audit);
+		if (job->records != NULL)
+			global_free(job->records);
 		*audit = NULL;
-		records = 0;
+		return 0;
 	}
 
-	return records;
+	if (job->count > 0)
+		*audit = job->records;
+	return job->count;
+}
+
+
+/*-------------------------------------------------
+    audit_hash_callback - hash a file on a worker
+    thread
+-------------------------------------------------*/
+
+static void *audit_hash_callback(void *param, int threadid)
+{
+	audit_file *entry = (audit_file *)param;
+	entry->file->hashes(entry->validation);
+	return NULL;
 }
 
 
@@ -317,10 +563,11 @@ int audit_summary(const game_driver *gamedrv, int count, const audit_record *rec
 ***************************************************************************/
 
 /*-------------------------------------------------
-    audit_one_rom - validate a single ROM entry
+    audit_find_rom - fill in the basics of a ROM
+    record and open its file, if we can find it
 -------------------------------------------------*/
 
-static void audit_one_rom(core_options *options, const rom_entry *rom, const char *regiontag, const game_driver *gamedrv, const char *validation, audit_record *record)
+static emu_file *audit_find_rom(core_options *options, const rom_entry *rom, const char *regiontag, const game_driver *gamedrv, audit_record *record)
 {
 	const game_driver *drv;
 	UINT32 crc = 0;
@@ -335,43 +582,46 @@ static void audit_one_rom(core_options *options, const rom_entry *rom, const cha
 	/* see if we have a CRC and extract it if so */
 	bool has_crc = record->exphashes.crc(crc);
 
-	/* find the file and checksum it, getting the file length along the way */
-	for (drv = gamedrv; drv != NULL; drv = driver_get_clone(drv))
+	/* find the file, getting the file length along the way */
+	emu_file *file = global_alloc(emu_file(*options, SEARCHPATH_ROM, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD));
+	file_error filerr = FILERR_NOT_FOUND;
+	for (drv = gamedrv; drv != NULL && filerr != FILERR_NONE; drv = driver_get_clone(drv))
 	{
-		emu_file file(*options, SEARCHPATH_ROM, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
-
-		/* open the file if we can */
-		file_error filerr;
 		if (has_crc)
-			filerr = file.open(drv->name, PATH_SEPARATOR, ROM_GETNAME(rom), crc);
+			filerr = file->open(drv->name, PATH_SEPARATOR, ROM_GETNAME(rom), crc);
 		else
-			filerr = file.open(drv->name, PATH_SEPARATOR, ROM_GETNAME(rom));
-		if (filerr == FILERR_NONE)
-		{
-			record->hashes = file.hashes(validation);
-			record->length = (UINT32)file.size();
-			break;
-		}
+			filerr = file->open(drv->name, PATH_SEPARATOR, ROM_GETNAME(rom));
 	}
 
 	/* if not found, check the region as a backup */
-	if (record->length == 0 && regiontag != NULL)
+	if ((filerr != FILERR_NONE || file->size() == 0) && regiontag != NULL)
 	{
-		emu_file file(*options, SEARCHPATH_ROM, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
-
-		/* open the file if we can */
-	    file_error filerr;
-	    if (has_crc)
-	    	filerr = file.open(regiontag, PATH_SEPARATOR, ROM_GETNAME(rom), crc);
-	    else
-	    	filerr = file.open(regiontag, PATH_SEPARATOR, ROM_GETNAME(rom));
-		if (filerr == FILERR_NONE)
-		{
-			record->hashes = file.hashes(validation);
-			record->length = (UINT32)file.size();
-		}
+		file->close();
+		if (has_crc)
+			filerr = file->open(regiontag, PATH_SEPARATOR, ROM_GETNAME(rom), crc);
+		else
+			filerr = file->open(regiontag, PATH_SEPARATOR, ROM_GETNAME(rom));
 	}
 
+	/* an empty file is as good as a missing one */
+	if (filerr == FILERR_NONE)
+		record->length = (UINT32)file->size();
+	if (record->length == 0)
+	{
+		global_free(file);
+		return NULL;
+	}
+	return file;
+}
+
+
+/*-------------------------------------------------
+    audit_rom_status - set the status of a ROM
+    record once its file has been hashed
+-------------------------------------------------*/
+
+static void audit_rom_status(const rom_entry *rom, const game_driver *gamedrv, audit_record *record)
+{
 	/* if we failed to find the file, set the appropriate status */
 	if (record->length == 0)
 	{
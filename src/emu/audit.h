@@ -88,12 +88,17 @@ struct _audit_record
 };
 
 
+/* callback for audit_images_multi, given one game's overall status */
+typedef void (*audit_callback)(const game_driver *gamedrv, int status, void *param);
+
+
 
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
 int audit_images(core_options *options, const game_driver *gamedrv, const char *validation, audit_record **audit);
+void audit_images_multi(core_options *options, const game_driver * const *drivers, int count, const char *validation, int output, audit_callback callback, void *param);
 int audit_samples(core_options *options, const game_driver *gamedrv, audit_record **audit);
 int audit_summary(const game_driver *gamedrv, int count, const audit_record *records, int output);
 
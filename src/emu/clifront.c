@@ -12,9 +12,11 @@
 #include "emu.h"
 #include "emuopts.h"
 #include "hash.h"
+#include "hashcache.h"
 #include "jedparse.h"
 #include "audit.h"
 #include "info.h"
+#include "infocache.h"
 #include "unzip.h"
 #include "validity.h"
 #include "sound/samples.h"
@@ -47,6 +49,15 @@ struct _romident_status
 };
 
 
+typedef struct _verifyroms_state verifyroms_state;
+struct _verifyroms_state
+{
+	int			correct;			/* romsets that are good or best available */
+	int			incorrect;			/* romsets that are bad */
+	int			notfound;			/* romsets that weren't found */
+};
+
+
 
 /***************************************************************************
     FUNCTION PROTOTYPES
@@ -64,6 +75,7 @@ static int info_listmedia(core_options *opts, const char *gamename);
 static int info_listsoftware(core_options *options, const char *gamename);
 
 /* utilities */
+static void verifyroms_callback(const game_driver *gamedrv, int status, void *param);
 static void romident(core_options *options, const char *filename, romident_status *status);
 static void identify_file(core_options *options, const char *name, romident_status *status);
 static void identify_data(core_options *options, const char *name, const UINT8 *data, int length, romident_status *status);
@@ -256,6 +268,10 @@ error:
 	global_free(drivers);
 #endif /* DRIVER_SWITCH */ 
 
+	/* write out any newly verified hashes */
+	hashcache_exit();
+	infocache_exit();
+
 	/* free our options and exit */
 	if (options != NULL)
 		options_free(options);
@@ -576,6 +592,8 @@ void setup_language(core_options *options)
 
 int cli_info_listxml(core_options *options, const char *gamename)
 {
+	/* a listing of more than one game builds the driver info cache if needed; it pays off from the next run on */
+	infocache_init(*options, strpbrk(gamename, "*?") != NULL);
 	print_mame_xml(stdout, drivers, gamename);
 	return MAMERR_NONE;
 }
@@ -927,74 +945,80 @@ int cli_info_listdevices(core_options *options, const char *gamename)
 
 
 /*-------------------------------------------------
-    info_verifyroms - verify the ROM sets of
-    one or more games
+    verifyroms_callback - report the audit of a
+    single romset
 -------------------------------------------------*/
 
-static int info_verifyroms(core_options *options, const char *gamename)
+static void verifyroms_callback(const game_driver *gamedrv, int status, void *param)
 {
-	int correct = 0;
-	int incorrect = 0;
-	int notfound = 0;
-	int drvindex;
+	verifyroms_state *state = (verifyroms_state *)param;
 
-	/* iterate over drivers */
-	for (drvindex = 0; drivers[drvindex] != NULL; drvindex++)
-		if (mame_strwildcmp(gamename, drivers[drvindex]->name) == 0)
-		{
-			audit_record *audit;
-			int audit_records;
-			int res;
+	/* if not found, count that and leave it at that */
+	if (status == NOTFOUND)
+		state->notfound++;
 
-			/* audit the ROMs in this set */
-			audit_records = audit_images(options, drivers[drvindex], AUDIT_VALIDATE_FAST, &audit);
-			res = audit_summary(drivers[drvindex], audit_records, audit, TRUE);
-			if (audit_records > 0)
-				global_free(audit);
+	/* else display information about what we discovered */
+	else
+	{
+		const game_driver *clone_of;
 
-			/* if not found, count that and leave it at that */
-			if (res == NOTFOUND)
-				notfound++;
+		/* output the name of the driver and its clone */
+		mame_printf_info(_("romset %s "), gamedrv->name);
+		clone_of = driver_get_clone(gamedrv);
+		if (clone_of != NULL)
+			mame_printf_info("[%s] ", clone_of->name);
 
-			/* else display information about what we discovered */
-			else
-			{
-				const game_driver *clone_of;
+		/* switch off of the result */
+		switch (status)
+		{
+			case INCORRECT:
+				mame_printf_info(_("is bad\n"));
+				state->incorrect++;
+				break;
+
+			case CORRECT:
+				mame_printf_info(_("is good\n"));
+				state->correct++;
+				break;
+
+			case BEST_AVAILABLE:
+				mame_printf_info(_("is best available\n"));
+				state->correct++;
+				break;
+		}
+	}
+}
 
-				/* output the name of the driver and its clone */
-				mame_printf_info(_("romset %s "), drivers[drvindex]->name);
-				clone_of = driver_get_clone(drivers[drvindex]);
-				if (clone_of != NULL)
-					mame_printf_info("[%s] ", clone_of->name);
 
-				/* switch off of the result */
-				switch (res)
-				{
-					case INCORRECT:
-						mame_printf_info(_("is bad\n"));
-						incorrect++;
-						break;
+/*-------------------------------------------------
+    info_verifyroms - verify the ROM sets of
+    one or more games
+-------------------------------------------------*/
 
-					case CORRECT:
-						mame_printf_info(_("is good\n"));
-						correct++;
-						break;
+static int info_verifyroms(core_options *options, const char *gamename)
+{
+	verifyroms_state state = { 0 };
+	const game_driver **matches;
+	int matchcount = 0;
+	int drvindex;
 
-					case BEST_AVAILABLE:
-						mame_printf_info(_("is best available\n"));
-						correct++;
-						break;
-				}
-			}
-		}
+	/* gather the matching drivers */
+	matches = global_alloc_array(const game_driver *, driver_list_get_count(drivers) + 1);
+	for (drvindex = 0; drivers[drvindex] != NULL; drvindex++)
+		if (mame_strwildcmp(gamename, drivers[drvindex]->name) == 0)
+			matches[matchcount++] = drivers[drvindex];
+
+	/* audit the ROMs in these sets, hashing in parallel but reporting in order */
+	audit_images_multi(options, matches, matchcount, AUDIT_VALIDATE_FAST, TRUE, verifyroms_callback, &state);
+	global_free(matches);
 
 	/* clear out any cached files */
 	zip_file_cache_clear();
 
 	/* if we didn't get anything at all, display a generic end message */
-	if (correct + incorrect == 0)
+	if (state.correct + state.incorrect == 0)
 	{
-		if (notfound > 0)
+		if (state.notfound > 0)
 			mame_printf_info(_("romset \"%s\" not found!\n"), gamename);
 		else
 			mame_printf_info(_("romset \"%s\" not supported!\n"), gamename);
@@ -1004,8 +1028,8 @@ static int info_verifyroms(core_options *options, const char *gamename)
 	/* otherwise, print a summary */
 	else
 	{
-		mame_printf_info(_("%d romsets found, %d were OK.\n"), correct + incorrect, correct);
-		return (incorrect > 0) ? MAMERR_MISSING_FILES : MAMERR_NONE;
+		mame_printf_info(_("%d romsets found, %d were OK.\n"), state.correct + state.incorrect, state.correct);
+		return (state.incorrect > 0) ? MAMERR_MISSING_FILES : MAMERR_NONE;
 	}
 }
 
@@ -1083,6 +1083,7 @@ void m68k_memory_interface::init8(address_space &space)
 	m_direct = &space.direct();
 	m_cpustate = get_safe_token(&space.device());
 	opcode_xor = 0;
+	opcode_direct = NULL;
 
 	readimm16 = m68k_readimm16_delegate(m68k_readimm16_proto_delegate::create_member(m68k_memory_interface, m68008_read_immediate_16), *this);
 	read8 = m68k_read8_delegate(m68k_read8_proto_delegate::create_member(address_space, read_byte), space);
@@ -1113,6 +1114,7 @@ void m68k_memory_interface::init16(address_space &space)
 	m_direct = &space.direct();
 	m_cpustate = get_safe_token(&space.device());
 	opcode_xor = 0;
+	opcode_direct = m_direct;
 
 	readimm16 = m68k_readimm16_delegate(m68k_readimm16_proto_delegate::create_member(m68k_memory_interface, simple_read_immediate_16), *this);
 	read8 = m68k_read8_delegate(m68k_read8_proto_delegate::create_member(address_space, read_byte), space);
@@ -1134,6 +1136,7 @@ void m68k_memory_interface::init32(address_space &space)
 	m_direct = &space.direct();
 	m_cpustate = get_safe_token(&space.device());
 	opcode_xor = WORD_XOR_BE(0);
+	opcode_direct = m_direct;
 
 	readimm16 = m68k_readimm16_delegate(m68k_readimm16_proto_delegate::create_member(m68k_memory_interface, read_immediate_16), *this);
 	read8 = m68k_read8_delegate(m68k_read8_proto_delegate::create_member(address_space, read_byte), space);
@@ -1352,6 +1355,7 @@ void m68k_memory_interface::init32mmu(address_space &space)
 	m_direct = &space.direct();
 	m_cpustate = get_safe_token(&space.device());
 	opcode_xor = WORD_XOR_BE(0);
+	opcode_direct = m_direct;
 
 	readimm16 = m68k_readimm16_delegate(m68k_readimm16_proto_delegate::create_member(m68k_memory_interface, read_immediate_16_mmu), *this);
 	read8 = m68k_read8_delegate(m68k_read8_proto_delegate::create_member(m68k_memory_interface, read_byte_32_mmu), *this);
@@ -1479,6 +1483,7 @@ void m68k_memory_interface::init32hmmu(address_space &space)
 	m_direct = &space.direct();
 	m_cpustate = get_safe_token(&space.device());
 	opcode_xor = WORD_XOR_BE(0);
+	opcode_direct = m_direct;
 
 	readimm16 = m68k_readimm16_delegate(m68k_readimm16_proto_delegate::create_member(m68k_memory_interface, read_immediate_16_hmmu), *this);
 	read8 = m68k_read8_delegate(m68k_read8_proto_delegate::create_member(m68k_memory_interface, read_byte_32_hmmu), *this);
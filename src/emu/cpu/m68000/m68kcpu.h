@@ -572,6 +572,7 @@ public:
 	void init32hmmu(address_space &space);
 
 	offs_t	opcode_xor;						// Address Calculation
+	direct_read_data *opcode_direct;		// Direct opcode access (NULL for 8-bit buses)
 	m68k_readimm16_delegate readimm16;		// Immediate read 16 bit
 	m68k_read8_delegate read8;
 	m68k_read16_delegate read16;
@@ -907,6 +908,17 @@ INLINE void m68ki_ic_clear(m68ki_cpu_core *m68k)
 	}
 }
 
+// read immediate word straight from the direct region when no MMU is
+// translating addresses, skipping the delegate call
+
+INLINE UINT32 m68ki_readimm16(m68ki_cpu_core *m68k, UINT32 address)
+{
+	if (m68k->memory.opcode_direct != NULL && !m68k->pmmu_enabled && !m68k->hmmu_enabled)
+		return m68k->memory.opcode_direct->read_decrypted_word(address, m68k->memory.opcode_xor);
+
+	return m68k->memory.readimm16(address);
+}
+
 // read immediate word using the instruction cache
 
 INLINE UINT32 m68ki_ic_readimm16(m68ki_cpu_core *m68k, UINT32 address)
@@ -920,7 +932,7 @@ INLINE UINT32 m68ki_ic_readimm16(m68ki_cpu_core *m68k, UINT32 address)
 		}
 		else
 		{
-			UINT32 data = m68k->memory.readimm16(address);
+			UINT32 data = m68ki_readimm16(m68k, address);
 			if (!m68k->mmu_tmp_buserror_occurred)
 			{
 				m68k->ic_data[ic_offset] = data;
@@ -931,7 +943,7 @@ INLINE UINT32 m68ki_ic_readimm16(m68ki_cpu_core *m68k, UINT32 address)
 	}
 	else
 	{
-		return m68k->memory.readimm16(address);
+		return m68ki_readimm16(m68k, address);
 	}
 }
 
@@ -195,6 +195,7 @@ OP_HANDLER( lbra )
 {
 	IMMWORD(EAP);
 	PC += EA;
+	IDLE_LOOP_BRANCH();
 
 	if ( EA == 0xfffd )  /* EHC 980508 speed up busy loop */
 		if ( m68_state->icount > 0)
@@ -372,6 +373,7 @@ OP_HANDLER( bra )
 	UINT8 t;
 	IMMBYTE(t);
 	PC += SIGNED(t);
+	IDLE_LOOP_BRANCH();
 	/* JB 970823 - speed up busy loops */
 	if( t == 0xfe )
 		if( m68_state->icount > 0 ) m68_state->icount = 0;
@@ -1239,6 +1241,7 @@ OP_HANDLER( jmp_ex )
 {
 	EXTENDED;
 	PCD = EAD;
+	IDLE_LOOP_BRANCH();
 }
 
 /* $7F CLR extended -0100 */
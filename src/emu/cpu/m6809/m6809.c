@@ -78,6 +78,15 @@
 
 #define LOG(x)	do { if (VERBOSE) logerror x; } while (0)
 
+/* skip over tight polling loops until the end of the timeslice */
+#ifndef IDLE_LOOP_DETECTION
+#define IDLE_LOOP_DETECTION	1
+#endif
+
+/* longest backward branch considered as an idle loop candidate */
+#define IDLE_LOOP_MAX_BYTES	16
+#define IDLE_LOOP_NONE		0xffffffff
+
 /* 6809 Registers */
 typedef struct _m68_state_t m68_state_t;
 struct _m68_state_t
@@ -105,6 +114,13 @@ struct _m68_state_t
 
 	UINT8	int_state;	/* SYNC and CWAI flags */
 	UINT8	nmi_state;
+
+	UINT32	idle_pc;		/* head of the loop being watched */
+	UINT32	idle_addr;		/* memory address read by the loop */
+	UINT32	idle_reads;		/* number of reads seen this pass */
+	int		idle_icount;	/* icount at the loop head */
+	UINT16	idle_regs[7];	/* register snapshot at the loop head */
+	UINT64	idle_skipped;	/* total cycles skipped in idle loops */
 };
 
 INLINE m68_state_t *get_safe_token(device_t *device)
@@ -117,6 +133,7 @@ INLINE m68_state_t *get_safe_token(device_t *device)
 
 static void check_irq_lines( m68_state_t *m68_state );
 static void IIError(m68_state_t *m68_state);
+static void idle_loop_branch(m68_state_t *m68_state);
 
 INLINE void fetch_effective_address( m68_state_t *m68_state );
 
@@ -165,15 +182,57 @@ INLINE void fetch_effective_address( m68_state_t *m68_state );
 #define M6809_LDS		32	/* set when LDS occured at least once */
 
 
+/****************************************************************************/
+/* Stop watching for an idle loop; used by anything that makes a pass       */
+/* through the loop depend on more than one memory read                     */
+/****************************************************************************/
+#if IDLE_LOOP_DETECTION
+#define IDLE_LOOP_CANCEL() do { m68_state->idle_pc = IDLE_LOOP_NONE; } while (0)
+#else
+#define IDLE_LOOP_CANCEL() do { } while (0)
+#endif
+
+/****************************************************************************/
+/* Check a taken branch for a short backward jump                           */
+/****************************************************************************/
+#if IDLE_LOOP_DETECTION
+#define IDLE_LOOP_BRANCH() do { 									\
+	if ((UINT16)(PPC - PC) <= IDLE_LOOP_MAX_BYTES)					\
+		idle_loop_branch(m68_state);								\
+} while (0)
+#else
+#define IDLE_LOOP_BRANCH() do { } while (0)
+#endif
+
 /****************************************************************************/
 /* Read a byte from given memory location                                   */
 /****************************************************************************/
-#define RM(Addr) ((unsigned)m68_state->program->read_byte(Addr))
+INLINE unsigned read_memory(m68_state_t *m68_state, UINT32 addr)
+{
+#if IDLE_LOOP_DETECTION
+	if (m68_state->idle_pc != IDLE_LOOP_NONE)
+	{
+		if (m68_state->idle_reads++ == 0)
+			m68_state->idle_addr = addr;
+		else if (addr != m68_state->idle_addr)
+			IDLE_LOOP_CANCEL();
+	}
+#endif
+	return m68_state->program->read_byte(addr);
+}
+
+#define RM(Addr) read_memory(m68_state, Addr)
 
 /****************************************************************************/
 /* Write a byte to given memory location                                    */
 /****************************************************************************/
-#define WM(Addr,Value) (m68_state->program->write_byte(Addr,Value))
+INLINE void write_memory(m68_state_t *m68_state, UINT32 addr, UINT8 value)
+{
+	IDLE_LOOP_CANCEL();
+	m68_state->program->write_byte(addr, value);
+}
+
+#define WM(Addr,Value) write_memory(m68_state, Addr, Value)
 
 /****************************************************************************/
 /* Z80_RDOP() is identical to Z80_RDMEM() except it is used for reading     */
@@ -272,6 +331,7 @@ INLINE void fetch_effective_address( m68_state_t *m68_state );
 	if( f ) 							\
 	{									\
 		PC += SIGNED(t);				\
+		IDLE_LOOP_BRANCH();				\
 	}									\
 }
 
@@ -282,6 +342,7 @@ INLINE void fetch_effective_address( m68_state_t *m68_state );
 	{									\
 		m68_state->icount -= 1;				\
 		PC += t.w.l;					\
+		IDLE_LOOP_BRANCH();				\
 	}									\
 }
 
@@ -381,6 +442,9 @@ static CPU_INIT( m6809 )
 	m68_state->program = device->space(AS_PROGRAM);
 	m68_state->direct = &m68_state->program->direct();
 
+	m68_state->idle_pc = IDLE_LOOP_NONE;
+	m68_state->idle_skipped = 0;
+
 	/* setup regtable */
 
 	device->save_item(NAME(PC));
@@ -421,7 +485,52 @@ static CPU_RESET( m6809 )
 
 static CPU_EXIT( m6809 )
 {
-	/* nothing to do ? */
+	m68_state_t *m68_state = get_safe_token(device);
+
+	if (m68_state->idle_skipped != 0)
+		logerror("M6809 '%s' skipped %" I64FMT "u cycles in idle loops\n", device->tag(), m68_state->idle_skipped);
+}
+
+/****************************************************************************
+ * Idle loop detection. A short backward branch marks the head of a
+ * candidate loop. If the next pass through the head finds every register
+ * unchanged, and the pass did nothing but read a single RAM/ROM location,
+ * the loop cannot exit until another device writes that location or an
+ * interrupt arrives. Neither can happen before the end of the current
+ * timeslice, so the iterations up to there are burned instead of run.
+ ****************************************************************************/
+static void idle_loop_branch(m68_state_t *m68_state)
+{
+	UINT16 regs[ARRAY_LENGTH(m68_state->idle_regs)];
+
+	regs[0] = D;
+	regs[1] = X;
+	regs[2] = Y;
+	regs[3] = U;
+	regs[4] = S;
+	regs[5] = DP | (CC << 8);
+	regs[6] = m68_state->int_state;
+
+	/* a second pass through the same head: see if it was a pure poll */
+	if (m68_state->idle_pc == PCD && memcmp(regs, m68_state->idle_regs, sizeof(regs)) == 0 &&
+		(m68_state->idle_reads == 0 || m68_state->program->get_read_ptr(m68_state->idle_addr) != NULL) &&
+		(m68_state->device->machine->debug_flags & DEBUG_FLAG_ENABLED) == 0)
+	{
+		int cycles = m68_state->idle_icount - m68_state->icount;
+
+		if (cycles > 0 && m68_state->icount > cycles)
+		{
+			int iterations = m68_state->icount / cycles;
+			m68_state->icount -= iterations * cycles;
+			m68_state->idle_skipped += iterations * cycles;
+		}
+	}
+
+	/* start watching a new pass from here */
+	m68_state->idle_pc = PCD;
+	m68_state->idle_reads = 0;
+	m68_state->idle_icount = m68_state->icount;
+	memcpy(m68_state->idle_regs, regs, sizeof(regs));
 }
 
 /****************************************************************************
@@ -483,6 +592,9 @@ static CPU_EXECUTE( m6809 )	/* NS 970908 */
 {
 	m68_state_t *m68_state = get_safe_token(device);
 
+	/* icount restarts with each timeslice, so restart idle loop tracking too */
+	IDLE_LOOP_CANCEL();
+
     m68_state->icount -= m68_state->extra_cycles;
 	m68_state->extra_cycles = 0;
 
@@ -211,6 +211,16 @@ static UINT16 memory_r(address_space *space, offs_t offset)
 	return space->read_word(offset);
 }
 
+/* return a pointer to a run of 'words' words of plain RAM starting at the
+   given byte offset, or NULL if any part of it goes through a handler; the
+   debugger must see every access, so never bypass the handlers under it */
+static UINT16 *memory_direct_ptr(address_space *space, offs_t offset, int words)
+{
+	if ((space->machine->debug_flags & DEBUG_FLAG_ENABLED) != 0)
+		return NULL;
+	return (UINT16 *)space->get_span_ptr(offset, offset + words * 2 - 1);
+}
+
 static void shiftreg_w(address_space *space, offs_t offset,UINT16 data)
 {
 	tms34010_state *tms = get_safe_token(space->cpu);
@@ -1111,80 +1121,102 @@ static void FUNCTION_NAME(pixblt)(tms34010_state *tms, int src_is_linear, int ds
 			UINT8 srcbit = saddr & 15;
 			UINT8 dstbit = daddr & 15;
 			UINT32 srcword, dstword = 0;
+			int fast = FALSE;
 
-			/* fetch the initial source word */
-			srcword = (*word_read)(tms->program, srcwordaddr++ << 1);
-			readwrites++;
-
-			/* fetch the initial dest word */
-			if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY || (daddr & 0x0f) != 0)
+			/* straight word-aligned copies between plain RAM can skip the pixel loop */
+			if (!PIXEL_OP_REQUIRES_SOURCE && !TRANSPARENCY && word_read == memory_r &&
+				srcbit == 0 && dstbit == 0 && ((dx * BITS_PER_PIXEL) & 15) == 0)
 			{
-				dstword = (*word_read)(tms->program, dstwordaddr << 1);
-				readwrites++;
+				int words = dx * BITS_PER_PIXEL / 16;
+				UINT16 *src = memory_direct_ptr(tms->program, srcwordaddr << 1, words);
+				UINT16 *dst = memory_direct_ptr(tms->program, dstwordaddr << 1, words);
+
+				/* the slow path interleaves reads and writes, so overlapping rows see
+				   partly copied data that memcpy can't reproduce; leave those to it */
+				if (src != NULL && dst != NULL && (dst + words <= src || src + words <= dst))
+				{
+					memcpy(dst, src, words * 2);
+					readwrites += words * 2;
+					fast = TRUE;
+				}
 			}
 
-			/* loop over pixels */
-			for (x = 0; x < dx; x++)
+			if (!fast)
 			{
-				UINT32 dstmask;
-				UINT32 pixel;
+				/* fetch the initial source word */
+				srcword = (*word_read)(tms->program, srcwordaddr++ << 1);
+				readwrites++;
 
-				/* fetch more words if necessary */
-				if (srcbit + BITS_PER_PIXEL > 16)
+				/* fetch the initial dest word */
+				if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY || (daddr & 0x0f) != 0)
 				{
-					srcword |= (*word_read)(tms->program, srcwordaddr++ << 1) << 16;
+					dstword = (*word_read)(tms->program, dstwordaddr << 1);
 					readwrites++;
 				}
 
-				/* extract pixel from source */
-				pixel = (srcword >> srcbit) & PIXEL_MASK;
-				srcbit += BITS_PER_PIXEL;
-				if (srcbit > 16)
+				/* loop over pixels */
+				for (x = 0; x < dx; x++)
 				{
-					srcbit -= 16;
-					srcword >>= 16;
-				}
+					UINT32 dstmask;
+					UINT32 pixel;
 
-				/* fetch additional destination word if necessary */
-				if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY)
-					if (dstbit + BITS_PER_PIXEL > 16)
+					/* fetch more words if necessary */
+					if (srcbit + BITS_PER_PIXEL > 16)
 					{
-						dstword |= (*word_read)(tms->program, (dstwordaddr + 1) << 1) << 16;
+						srcword |= (*word_read)(tms->program, srcwordaddr++ << 1) << 16;
 						readwrites++;
 					}
 
-				/* apply pixel operations */
-				pixel <<= dstbit;
-				dstmask = PIXEL_MASK << dstbit;
-				PIXEL_OP(dstword, dstmask, pixel);
-				if (!TRANSPARENCY || pixel != 0)
-					dstword = (dstword & ~dstmask) | pixel;
+					/* extract pixel from source */
+					pixel = (srcword >> srcbit) & PIXEL_MASK;
+					srcbit += BITS_PER_PIXEL;
+					if (srcbit > 16)
+					{
+						srcbit -= 16;
+						srcword >>= 16;
+					}
 
-				/* flush destination words */
-				dstbit += BITS_PER_PIXEL;
-				if (dstbit > 16)
-				{
-					(*word_write)(tms->program, dstwordaddr++ << 1, dstword);
-					readwrites++;
-					dstbit -= 16;
-					dstword >>= 16;
+					/* fetch additional destination word if necessary */
+					if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY)
+						if (dstbit + BITS_PER_PIXEL > 16)
+						{
+							dstword |= (*word_read)(tms->program, (dstwordaddr + 1) << 1) << 16;
+							readwrites++;
+						}
+
+					/* apply pixel operations */
+					pixel <<= dstbit;
+					dstmask = PIXEL_MASK << dstbit;
+					PIXEL_OP(dstword, dstmask, pixel);
+					if (!TRANSPARENCY || pixel != 0)
+						dstword = (dstword & ~dstmask) | pixel;
+
+					/* flush destination words */
+					dstbit += BITS_PER_PIXEL;
+					if (dstbit > 16)
+					{
+						(*word_write)(tms->program, dstwordaddr++ << 1, dstword);
+						readwrites++;
+						dstbit -= 16;
+						dstword >>= 16;
+					}
 				}
-			}
 
-			/* flush any remaining words */
-			if (dstbit > 0)
-			{
-				/* if we're right-partial, read and mask the remaining bits */
-				if (dstbit != 16)
+				/* flush any remaining words */
+				if (dstbit > 0)
 				{
-					UINT16 origdst = (*word_read)(tms->program, dstwordaddr << 1);
-					UINT16 mask = 0xffff << dstbit;
-					dstword = (dstword & ~mask) | (origdst & mask);
+					/* if we're right-partial, read and mask the remaining bits */
+					if (dstbit != 16)
+					{
+						UINT16 origdst = (*word_read)(tms->program, dstwordaddr << 1);
+						UINT16 mask = 0xffff << dstbit;
+						dstword = (dstword & ~mask) | (origdst & mask);
+						readwrites++;
+					}
+
+					(*word_write)(tms->program, dstwordaddr++ << 1, dstword);
 					readwrites++;
 				}
-
-				(*word_write)(tms->program, dstwordaddr++ << 1, dstword);
-				readwrites++;
 			}
 
 
@@ -1932,6 +1964,7 @@ static void FUNCTION_NAME(fill)(tms34010_state *tms, int dst_is_linear)
 		{
 			UINT16 dstword, dstmask, pixel;
 			UINT32 dwordaddr;
+			UINT16 *dstptr;
 
 			/* use byte addresses each row */
 			dwordaddr = daddr >> 4;
@@ -1963,31 +1996,58 @@ static void FUNCTION_NAME(fill)(tms34010_state *tms, int dst_is_linear)
 				(*word_write)(tms->program, dwordaddr++ << 1, dstword);
 			}
 
-			/* loop over full words */
-			for (words = 0; words < full_words; words++)
+			/* full words in plain RAM can be accessed directly */
+			dstptr = NULL;
+			if (full_words > 0 && word_write == memory_w)
+				dstptr = memory_direct_ptr(tms->program, dwordaddr << 1, full_words);
+
+			/* without a source or transparency every full word is the same; compute it once */
+			if (dstptr != NULL && !PIXEL_OP_REQUIRES_SOURCE && !TRANSPARENCY)
 			{
-				/* fetch the destination word (if necessary) */
-				if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY)
-					dstword = (*word_read)(tms->program, dwordaddr << 1);
-				else
-					dstword = 0;
+				dstword = 0;
 				dstmask = PIXEL_MASK;
-
-				/* loop over partials */
 				for (x = 0; x < PIXELS_PER_WORD; x++)
 				{
-					/* process the pixel */
 					pixel = COLOR1(tms) & dstmask;
 					PIXEL_OP(dstword, dstmask, pixel);
-					if (!TRANSPARENCY || pixel != 0)
-						dstword = (dstword & ~dstmask) | pixel;
-
-					/* update the destination */
+					dstword = (dstword & ~dstmask) | pixel;
 					dstmask <<= BITS_PER_PIXEL;
 				}
+				for (words = 0; words < full_words; words++)
+					dstptr[words] = dstword;
+				dwordaddr += full_words;
+			}
+			else
+			{
+				/* loop over full words */
+				for (words = 0; words < full_words; words++)
+				{
+					/* fetch the destination word (if necessary) */
+					if (PIXEL_OP_REQUIRES_SOURCE || TRANSPARENCY)
+						dstword = (dstptr != NULL) ? dstptr[words] : (*word_read)(tms->program, dwordaddr << 1);
+					else
+						dstword = 0;
+					dstmask = PIXEL_MASK;
 
-				/* write the result */
-				(*word_write)(tms->program, dwordaddr++ << 1, dstword);
+					/* loop over partials */
+					for (x = 0; x < PIXELS_PER_WORD; x++)
+					{
+						/* process the pixel */
+						pixel = COLOR1(tms) & dstmask;
+						PIXEL_OP(dstword, dstmask, pixel);
+						if (!TRANSPARENCY || pixel != 0)
+							dstword = (dstword & ~dstmask) | pixel;
+
+						/* update the destination */
+						dstmask <<= BITS_PER_PIXEL;
+					}
+
+					/* write the result */
+					if (dstptr != NULL)
+						dstptr[words] = dstword, dwordaddr++;
+					else
+						(*word_write)(tms->program, dwordaddr++ << 1, dstword);
+				}
 			}
 
 			/* handle the right partial word */
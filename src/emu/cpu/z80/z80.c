@@ -137,6 +137,15 @@
 #define BIG_SWITCH			1
 #endif
 
+/* skip over tight polling loops until the end of the timeslice */
+#ifndef IDLE_LOOP_DETECTION
+#define IDLE_LOOP_DETECTION	1
+#endif
+
+/* longest backward branch considered as an idle loop candidate */
+#define IDLE_LOOP_MAX_BYTES	16
+#define IDLE_LOOP_NONE		0xffffffff
+
 
 /****************************************************************************/
 /* The Z80 registers. halt is set to 1 when the CPU is halted, the refresh  */
@@ -169,6 +178,14 @@ struct _z80_state
 	const UINT8 *	cc_xy;
 	const UINT8 *	cc_xycb;
 	const UINT8 *	cc_ex;
+
+	UINT32			idle_pc;			/* head of the loop being watched */
+	UINT32			idle_addr;			/* memory address read by the loop */
+	UINT32			idle_reads;			/* number of reads seen this pass */
+	int				idle_icount;		/* icount at the loop head */
+	UINT8			idle_r;				/* r at the loop head */
+	UINT16			idle_regs[14];		/* register snapshot at the loop head */
+	UINT64			idle_skipped;		/* total cycles skipped in idle loops */
 };
 
 INLINE z80_state *get_safe_token(device_t *device)
@@ -357,6 +374,7 @@ static const UINT8 cc_ex[0x100] = {
 
 static void take_interrupt(z80_state *z80);
 static void take_interrupt_nsc800(z80_state *z80);
+static void idle_loop_branch(z80_state *z80);
 static CPU_BURN( z80 );
 
 typedef void (*funcptr)(z80_state *z80);
@@ -600,20 +618,62 @@ INLINE void BURNODD(z80_state *z80, int cycles, int opcodes, int cyclesum)
 	}															\
 } while (0)
 
+/***************************************************************
+ * Stop watching for an idle loop; used by anything that makes
+ * a pass through the loop depend on more than one memory read
+ ***************************************************************/
+#if IDLE_LOOP_DETECTION
+#define IDLE_LOOP_CANCEL(Z)	do { (Z)->idle_pc = IDLE_LOOP_NONE; } while (0)
+#else
+#define IDLE_LOOP_CANCEL(Z)	do { } while (0)
+#endif
+
+/***************************************************************
+ * Check a taken branch for a short backward jump
+ ***************************************************************/
+#if IDLE_LOOP_DETECTION
+#define IDLE_LOOP_BRANCH(Z) do {								\
+	if ((UINT16)((Z)->PRVPC - (Z)->PCD) <= IDLE_LOOP_MAX_BYTES)	\
+		idle_loop_branch(Z);									\
+} while (0)
+#else
+#define IDLE_LOOP_BRANCH(Z)	do { } while (0)
+#endif
+
 /***************************************************************
  * Input a byte from given I/O port
  ***************************************************************/
-#define IN(Z,port)  		(Z)->io->read_byte(port)
+INLINE UINT8 IN(z80_state *z80, UINT32 port)
+{
+	IDLE_LOOP_CANCEL(z80);
+	return z80->io->read_byte(port);
+}
 
 /***************************************************************
  * Output a byte to given I/O port
  ***************************************************************/
-#define OUT(Z,port,value)	(Z)->io->write_byte(port, value)
+INLINE void OUT(z80_state *z80, UINT32 port, UINT8 value)
+{
+	IDLE_LOOP_CANCEL(z80);
+	z80->io->write_byte(port, value);
+}
 
 /***************************************************************
  * Read a byte from given memory location
  ***************************************************************/
-#define RM(Z,addr)			(Z)->program->read_byte(addr)
+INLINE UINT8 RM(z80_state *z80, UINT32 addr)
+{
+#if IDLE_LOOP_DETECTION
+	if (z80->idle_pc != IDLE_LOOP_NONE)
+	{
+		if (z80->idle_reads++ == 0)
+			z80->idle_addr = addr;
+		else if (addr != z80->idle_addr)
+			IDLE_LOOP_CANCEL(z80);
+	}
+#endif
+	return z80->program->read_byte(addr);
+}
 
 /***************************************************************
  * Read a word from given memory location
@@ -627,7 +687,11 @@ INLINE void RM16(z80_state *z80, UINT32 addr, PAIR *r)
 /***************************************************************
  * Write a byte to given memory location
  ***************************************************************/
-#define WM(Z,addr,value)	(Z)->program->write_byte(addr, value)
+INLINE void WM(z80_state *z80, UINT32 addr, UINT8 value)
+{
+	IDLE_LOOP_CANCEL(z80);
+	z80->program->write_byte(addr, value);
+}
 
 /***************************************************************
  * Write a word to given memory location
@@ -693,6 +757,7 @@ INLINE UINT32 ARG16(z80_state *z80)
 #define JP(Z) do {												\
 	(Z)->PCD = ARG16(Z);										\
 	(Z)->WZ = (Z)->PCD;											\
+	IDLE_LOOP_BRANCH(Z);										\
 } while (0)
 
 /***************************************************************
@@ -703,6 +768,7 @@ INLINE UINT32 ARG16(z80_state *z80)
 	{															\
 		(Z)->PCD = ARG16(Z);									\
 		(Z)->WZ = (Z)->PCD;										\
+		IDLE_LOOP_BRANCH(Z);									\
 	}															\
 	else														\
 	{															\
@@ -717,6 +783,7 @@ INLINE UINT32 ARG16(z80_state *z80)
 	INT8 arg = (INT8)ARG(Z);	/* ARG() also increments PC */	\
 	(Z)->PC += arg;				/* so don't do PC += ARG() */	\
 	(Z)->WZ = (Z)->PC;											\
+	IDLE_LOOP_BRANCH(Z);										\
 } while (0)
 
 /***************************************************************
@@ -805,6 +872,7 @@ INLINE UINT32 ARG16(z80_state *z80)
  * LD   A,R
  ***************************************************************/
 #define LD_A_R(Z) do {											\
+	IDLE_LOOP_CANCEL(Z);										\
 	(Z)->A = ((Z)->r & 0x7f) | (Z)->r2;							\
 	(Z)->F = ((Z)->F & CF) | SZ[(Z)->A] | ((Z)->iff2 << 2);		\
 	(Z)->after_ldair = TRUE;									\
@@ -3335,6 +3403,57 @@ static void take_interrupt_nsc800(z80_state *z80)
 	z80->WZ=z80->PCD;
 }
 
+/****************************************************************************
+ * Idle loop detection. A short backward branch marks the head of a
+ * candidate loop. If the next pass through the head finds every register
+ * unchanged, and the pass did nothing but read a single RAM/ROM location,
+ * the loop cannot exit until another device writes that location or an
+ * interrupt arrives. Neither can happen before the end of the current
+ * timeslice, so the iterations up to there are burned instead of run.
+ ****************************************************************************/
+static void idle_loop_branch(z80_state *z80)
+{
+	UINT16 regs[ARRAY_LENGTH(z80->idle_regs)];
+
+	regs[0] = z80->AF;
+	regs[1] = z80->BC;
+	regs[2] = z80->DE;
+	regs[3] = z80->HL;
+	regs[4] = z80->IX;
+	regs[5] = z80->IY;
+	regs[6] = z80->SP;
+	regs[7] = z80->WZ;
+	regs[8] = z80->af2.w.l;
+	regs[9] = z80->bc2.w.l;
+	regs[10] = z80->de2.w.l;
+	regs[11] = z80->hl2.w.l;
+	regs[12] = z80->iff1 | (z80->iff2 << 1) | (z80->im << 2);
+	regs[13] = z80->i | (z80->r2 << 8);
+
+	/* a second pass through the same head: see if it was a pure poll */
+	if (z80->idle_pc == z80->PCD && memcmp(regs, z80->idle_regs, sizeof(regs)) == 0 &&
+		(z80->idle_reads == 0 || z80->program->get_read_ptr(z80->idle_addr) != NULL) &&
+		(z80->device->machine->debug_flags & DEBUG_FLAG_ENABLED) == 0)
+	{
+		int cycles = z80->idle_icount - z80->icount;
+
+		if (cycles > 0 && z80->icount > cycles)
+		{
+			int iterations = z80->icount / cycles;
+			z80->r += iterations * (UINT8)(z80->r - z80->idle_r);
+			z80->icount -= iterations * cycles;
+			z80->idle_skipped += iterations * cycles;
+		}
+	}
+
+	/* start watching a new pass from here */
+	z80->idle_pc = z80->PCD;
+	z80->idle_reads = 0;
+	z80->idle_icount = z80->icount;
+	z80->idle_r = z80->r;
+	memcpy(z80->idle_regs, regs, sizeof(regs));
+}
+
 /****************************************************************************
  * Processor initialization
  ****************************************************************************/
@@ -3476,6 +3595,8 @@ static CPU_INIT( z80 )
 	z80->after_ei = 0;
 	z80->after_ldair = 0;
 	z80->ea = 0;
+	z80->idle_pc = IDLE_LOOP_NONE;
+	z80->idle_skipped = 0;
 
 	if (device->baseconfig().static_config() != NULL)
 		z80->daisy.init(device, (const z80_daisy_config *)device->baseconfig().static_config());
@@ -3572,6 +3693,11 @@ static CPU_RESET( z80 )
 
 static CPU_EXIT( z80 )
 {
+	z80_state *z80 = get_safe_token(device);
+
+	if (z80->idle_skipped != 0)
+		logerror("Z80 '%s' skipped %" I64FMT "u cycles in idle loops\n", device->tag(), z80->idle_skipped);
+
 	global_free(SZHVC_add);
 	SZHVC_add = NULL;
 	global_free(SZHVC_sub);
@@ -3585,6 +3711,9 @@ static CPU_EXECUTE( z80 )
 {
 	z80_state *z80 = get_safe_token(device);
 
+	/* icount restarts with each timeslice, so restart idle loop tracking too */
+	IDLE_LOOP_CANCEL(z80);
+
 	/* check for NMIs on the way in; they can only be set externally */
 	/* via timers, and can't be dynamically enabled, so it is safe */
 	/* to just check here */
@@ -3633,6 +3762,9 @@ static CPU_EXECUTE( z80 )
 {
 	z80_state *z80 = get_safe_token(device);
 
+	/* icount restarts with each timeslice, so restart idle loop tracking too */
+	IDLE_LOOP_CANCEL(z80);
+
 	/* check for NMIs on the way in; they can only be set externally */
 	/* via timers, and can't be dynamically enabled, so it is safe */
 	/* to just check here */
@@ -724,8 +724,8 @@ void device_t::find_interfaces()
 
 void device_t::start()
 {
-	// populate the region field
-	m_region = m_machine.region(tag());
+	// populate the region field; with -faststart a sound device's region may still be loading
+	m_region = m_machine.region_noload(tag());
 
 	// find all the registered devices
 	for (auto_finder_base *autodev = m_auto_finder_list; autodev != NULL; autodev = autodev->m_next)
@@ -78,6 +78,7 @@ enum
 		DEVINFO_INT_ADDRBUS_SHIFT_2 = DEVINFO_INT_ADDRBUS_SHIFT + 2,
 		DEVINFO_INT_ADDRBUS_SHIFT_3 = DEVINFO_INT_ADDRBUS_SHIFT + 3,
 		DEVINFO_INT_ADDRBUS_SHIFT_LAST = DEVINFO_INT_ADDRBUS_SHIFT + ADDRESS_SPACES - 1,
+		DEVINFO_INT_ROM_ON_DEMAND,						// R/O: sound devices only; non-zero if the ROM can be loaded on first use
 
 	DEVINFO_INT_CLASS_SPECIFIC = 0x04000,				// R/W: device-specific values start here
 	DEVINFO_INT_DEVICE_SPECIFIC = 0x08000,				// R/W: device-specific values start here
@@ -500,6 +501,9 @@ class legacy_sound_device_config_base :	public legacy_device_config_base,
 protected:
 	// construction/destruction
 	legacy_sound_device_config_base(const machine_config &mconfig, device_type type, const char *tag, const device_config *owner, UINT32 clock, device_get_config_func get_config);
+
+	// device_config_sound_interface overrides
+	virtual bool sound_rom_on_demand() const { return (get_legacy_config_int(DEVINFO_INT_ROM_ON_DEMAND) != 0); }
 };
 
 
@@ -120,6 +120,7 @@ public:
 
 	// getters
 	const sound_route *first_route() const { return m_route_list.first(); }
+	bool rom_on_demand() const { return sound_rom_on_demand(); }
 
 	// static inline helpers
 	static void static_add_route(device_config *device, UINT32 output, const char *target, double gain, UINT32 input = AUTO_ALLOC_INPUT);
@@ -128,6 +129,7 @@ public:
 protected:
 	// optional operation overrides
 	virtual bool interface_validity_check(core_options &options, const game_driver &driver) const;
+	virtual bool sound_rom_on_demand() const { return false; }
 
 	// internal state
 	simple_list<sound_route> m_route_list;		// list of sound routes
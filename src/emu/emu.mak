@@ -73,8 +73,10 @@ EMUOBJS = \
 	$(EMUOBJ)/emupal.o \
 	$(EMUOBJ)/fileio.o \
 	$(EMUOBJ)/hash.o \
+	$(EMUOBJ)/hashcache.o \
 	$(EMUOBJ)/image.o \
 	$(EMUOBJ)/info.o \
+	$(EMUOBJ)/infocache.o \
 	$(EMUOBJ)/input.o \
 	$(EMUOBJ)/inputseq.o \
 	$(EMUOBJ)/inptport.o \
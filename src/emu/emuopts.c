@@ -92,7 +92,8 @@ const options_entry mame_core_options[] =
 #endif /* KAILLERA */
 	{ "mngwrite",                    NULL,        0,                 "optional filename to write a MNG movie of the current session" },
 	{ "aviwrite",                    NULL,        0,                 "optional filename to write an AVI movie of the current session" },
-	{ "wavwrite",                    NULL,        0,                 "optional filename to write a WAV file of the current session" },
+	{ "wavwrite",                    NULL,        0,                 "optional filename to write a WAV file of the current session (.flac for FLAC)" },
+	{ "soundlog",                    NULL,        0,                 "optional filename to log sound chip register writes for the soundbench tool" },
 	{ "snapname",                    "%g/%i",     0,                 "override of the default snapshot/movie naming; %g == gamename, %i == index" },
 	{ "snapsize",                    "auto",      0,                 "specify snapshot/movie resolution (<width>x<height>) or 'auto' to use minimal size " },
 	{ "snapview",                    "internal",  0,                 "specify snapshot/movie view or 'internal' to use internal pixel-aspect views" },
@@ -107,6 +108,8 @@ const options_entry mame_core_options[] =
 	{ "sleep",                       "1",         OPTION_BOOLEAN,    "enable sleeping, which gives time back to other applications when idle" },
 	{ "speed(0.01-100)",             "1.0",       0,                 "controls the speed of gameplay, relative to realtime; smaller numbers are slower" },
 	{ "refreshspeed;rs",             "0",         OPTION_BOOLEAN,    "automatically adjusts the speed of gameplay to keep the refresh rate lower than the screen" },
+	{ "faststart",                   "0",         OPTION_BOOLEAN,    "skip validity checks this build has already passed and load sample ROMs when they are first used" },
+	{ "bench_startup;bench-startup", "0",         OPTION_BOOLEAN,    "report the time taken to reach the first frame, then exit" },
 
 	/* rotation options */
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE ROTATION OPTIONS" },
@@ -148,6 +151,11 @@ const options_entry mame_core_options[] =
 	{ "samplerate;sr(1000-1000000)", "48000",     0,                 "set sound output sample rate" },
 	{ "samples",                     "1",         OPTION_BOOLEAN,    "enable the use of external samples if available" },
 	{ "volume;vol",                  "0",         0,                 "sound volume in decibels (-32 min, 0 max)" },
+	{ "sound_update_rate;sur(50-500)", "50",      0,                 "number of times per emulated second to send sound to the OSD (raise to reduce latency)" },
+	{ "soundthreads",                "0",         OPTION_BOOLEAN,    "generate independent sound streams in parallel" },
+	{ "polyphase",                   "0",         OPTION_BOOLEAN,    "use a polyphase filter when upsampling low-rate sound streams" },
+	{ "soundprofile",                "0",         OPTION_BOOLEAN,    "report time spent generating each sound stream on exit" },
+	{ "soundrenderthread",           "0",         OPTION_BOOLEAN,    "synthesize chips that log their register writes on a separate thread" },
 #ifdef USE_VOLUME_AUTO_ADJUST
 	{ "volume_adjust",               "0",         OPTION_BOOLEAN,    "enable/disable volume auto adjust" },
 #endif /* USE_VOLUME_AUTO_ADJUST */
@@ -212,6 +220,10 @@ const options_entry mame_core_options[] =
 	{ "ips",                         NULL,        0,                 "ips datafile name"},
 #endif /* USE_IPS */
 	{ "ramsize;ram",				 NULL,		  OPTION_DRIVER_ONLY,"size of RAM (if supported by driver)" },
+	{ "forcehash",                   "0",         OPTION_BOOLEAN,    "recompute ROM hashes instead of trusting the hash cache" },
+	{ "zipcache",                    "64",        0,                 "number of closed ZIP files to keep open for reuse" },
+	{ "zipcachesize",                "16",        0,                 "memory limit in MB for closed ZIP files kept open for reuse" },
+	{ "infocache",                   "1",         OPTION_BOOLEAN,    "keep a precompiled cache of driver information for -listxml and the front end" },
 #ifdef MAMEUIPLUSPLUS
 	{ "disp_autofire_status",        "1",         OPTION_BOOLEAN,    "display autofire status" },
 #endif /* MAMEUIPLUSPLUS */
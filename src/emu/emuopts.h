@@ -95,6 +95,7 @@
 #define OPTION_MNGWRITE				"mngwrite"
 #define OPTION_AVIWRITE				"aviwrite"
 #define OPTION_WAVWRITE				"wavwrite"
+#define OPTION_SOUNDLOG				"soundlog"
 #define OPTION_SNAPNAME				"snapname"
 #define OPTION_SNAPSIZE				"snapsize"
 #define OPTION_SNAPVIEW				"snapview"
@@ -108,6 +109,8 @@
 #define OPTION_SLEEP				"sleep"
 #define OPTION_SPEED				"speed"
 #define OPTION_REFRESHSPEED			"refreshspeed"
+#define OPTION_FASTSTART			"faststart"
+#define OPTION_BENCH_STARTUP		"bench_startup"
 
 /* core rotation options */
 #define OPTION_ROTATE				"rotate"
@@ -144,6 +147,11 @@
 #define OPTION_SAMPLERATE			"samplerate"
 #define OPTION_SAMPLES				"samples"
 #define OPTION_VOLUME				"volume"
+#define OPTION_SOUNDUPDATERATE		"sound_update_rate"
+#define OPTION_SOUNDTHREADS			"soundthreads"
+#define OPTION_POLYPHASE			"polyphase"
+#define OPTION_SOUNDPROFILE			"soundprofile"
+#define OPTION_SOUNDRENDERTHREAD	"soundrenderthread"
 #ifdef USE_VOLUME_AUTO_ADJUST
 #define OPTION_VOLUME_ADJUST		"volume_adjust"
 #endif /* USE_VOLUME_AUTO_ADJUST */
@@ -185,6 +193,10 @@
 #define OPTION_SKIP_GAMEINFO		"skip_gameinfo"
 #define OPTION_UI_FONT				"uifont"
 #define OPTION_RAMSIZE				"ramsize"
+#define OPTION_FORCEHASH			"forcehash"
+#define OPTION_ZIPCACHE				"zipcache"
+#define OPTION_ZIPCACHESIZE			"zipcachesize"
+#define OPTION_INFOCACHE			"infocache"
 #ifdef CONFIRM_QUIT
 #define OPTION_CONFIRM_QUIT			"confirm_quit"
 #endif /* CONFIRM_QUIT */
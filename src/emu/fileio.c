@@ -42,6 +42,7 @@
 #include "unzip.h"
 #include "options.h"
 #include "fileio.h"
+#include "hashcache.h"
 #include <windows.h>
 #include <stdio.h>
 #include <direct.h>
@@ -173,6 +174,8 @@ emu_file::emu_file(core_options &options, const char *searchpath, UINT32 openfla
 	  m_zipfile(NULL),
 	  m_zipdata(NULL),
 	  m_ziplength(0),
+	  m_mapping(NULL),
+	  m_mapbase(NULL),
 	  m_remove_on_close(false)
 {
 	// sanity check the open flags
@@ -209,45 +212,104 @@ emu_file::operator core_file *()
 
 
 //-------------------------------------------------
-//  hash - returns the hash for a file
+//  hash - returns the hash for a file; only the
+//  file's own state is touched (a ZIPped file is
+//  inflated but the ZIP stays open until the next
+//  access), so this is safe to call from a worker
+//  thread
 //-------------------------------------------------
 
 hash_collection &emu_file::hashes(const char *types)
 {
+	// files that haven't changed since they were last hashed can skip the work
+	if (cached_hashes(types))
+		return m_hashes;
+
 	// determine which hashes we need
 	astring needed;
 	for (const char *scan = types; *scan != 0; scan++)
 		if (m_hashes.hash(*scan) == NULL)
 			needed.cat(*scan);
 
-	// if we need nothing, skip it
-	if (!needed)
-		return m_hashes;
-
-	// load the ZIP file if needed
-	if (m_zipfile != NULL && load_zipped_file() != FILERR_NONE)
+	// load the ZIP data if needed; preloaded or mapped data is hashed in place
+	if (m_zipfile != NULL && m_file == NULL && decompress_zipped_file() != FILERR_NONE)
 		return m_hashes;
 	if (m_file == NULL)
 		return m_hashes;
 
 	// if we have ZIP data, just hash that directly
 	if (m_zipdata != NULL)
-	{
 		m_hashes.compute(m_zipdata, m_ziplength, needed);
-		return m_hashes;
-	}
 
-	// read the data if we can
-	const UINT8 *filedata = (const UINT8 *)core_fbuffer(m_file);
-	if (filedata == NULL)
-		return m_hashes;
+	// otherwise, read the data if we can
+	else
+	{
+		const UINT8 *filedata = (const UINT8 *)core_fbuffer(m_file);
+		if (filedata == NULL)
+			return m_hashes;
+		m_hashes.compute(filedata, core_fsize(m_file), needed);
+	}
 
-	// compute the hash
-	m_hashes.compute(filedata, core_fsize(m_file), needed);
+	// remember the results for next time
+	astring cachepath;
+	UINT64 cachelength, cachemodified;
+	if (hash_cache_key(cachepath, cachelength, cachemodified))
+		hashcache_store(cachepath, m_zipmember, cachelength, cachemodified, m_hashes);
 	return m_hashes;
 }
 
 
+//-------------------------------------------------
+//  cached_hashes - fill in whatever of the given
+//  hashes are known without reading the file;
+//  returns true if all of them are
+//-------------------------------------------------
+
+bool emu_file::cached_hashes(const char *types)
+{
+	// determine which hashes we need
+	astring needed;
+	for (const char *scan = types; *scan != 0; scan++)
+		if (m_hashes.hash(*scan) == NULL)
+			needed.cat(*scan);
+
+	// if we need nothing, we're done
+	if (!needed)
+		return true;
+
+	// otherwise ask the hash cache
+	astring cachepath;
+	UINT64 cachelength, cachemodified;
+	return (hash_cache_key(cachepath, cachelength, cachemodified) && hashcache_lookup(cachepath, m_zipmember, cachelength, cachemodified, needed, m_hashes));
+}
+
+
+//-------------------------------------------------
+//  hash_cache_key - determine the path, length
+//  and modification stamp the hash cache knows
+//  this file by
+//-------------------------------------------------
+
+bool emu_file::hash_cache_key(astring &path, UINT64 &length, UINT64 &modified)
+{
+	length = modified = 0;
+	if (m_fullpath.len() == 0 || (m_openflags & OPEN_FLAG_WRITE) != 0)
+		return false;
+
+	path.cpy(m_fullpath);
+	if (m_zipmember.len() > 0)
+		path.cat(".zip");
+	osd_directory_entry *entry = osd_stat(path);
+	if (entry != NULL)
+	{
+		modified = entry->modified;
+		length = (m_zipmember.len() > 0) ? m_ziplength : entry->size;
+		free(entry);
+	}
+	return true;
+}
+
+
 //-------------------------------------------------
 //  open - open a file by searching paths
 //-------------------------------------------------
@@ -411,6 +473,11 @@ void emu_file::close()
 		core_fclose(m_file);
 	m_file = NULL;
 
+	if (m_mapping != NULL)
+		osd_unmap(m_mapping);
+	m_mapping = NULL;
+	m_mapbase = NULL;
+
 	if (m_zipdata != NULL)
 		global_free(m_zipdata);
 	m_zipdata = NULL;
@@ -422,6 +489,102 @@ void emu_file::close()
 	// reset our hashes and path as well
 	m_hashes.reset();
 	m_fullpath.reset();
+	m_zipmember.reset();
+}
+
+
+//-------------------------------------------------
+//  preload - load the file's data and compute
+//  the given hashes up front; only the file's
+//  own state is touched (the ZIP is handed back
+//  to the shared cache on the next access), so
+//  this may run on a worker thread
+//-------------------------------------------------
+
+file_error emu_file::preload(const char *types)
+{
+	// map the data in place if we can, otherwise decompress a ZIPped file now
+	map();
+	if (m_zipfile != NULL && m_file == NULL)
+	{
+		file_error filerr = decompress_zipped_file();
+		if (filerr != FILERR_NONE)
+			return filerr;
+	}
+	if (m_file == NULL)
+		return FILERR_NOT_FOUND;
+
+	// pull plain files into memory, then compute (or look up) the hashes
+	if (m_zipdata == NULL && core_fbuffer(m_file) == NULL)
+		return FILERR_FAILURE;
+	hashes(types);
+	return FILERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  map - map the file's data into memory and read
+//  from there from now on; works for plain files
+//  and for ZIP members that are stored rather
+//  than compressed, as long as they haven't been
+//  loaded yet
+//-------------------------------------------------
+
+file_error emu_file::map()
+{
+	// nothing to do if we're already mapped
+	if (m_mapping != NULL)
+		return FILERR_NONE;
+
+	UINT64 length, offset = 0;
+	if (m_zipfile != NULL && m_file == NULL)
+	{
+		length = m_ziplength;
+		if (zip_file_map(m_zipfile, &m_mapping, &m_mapbase) != ZIPERR_NONE)
+			return FILERR_FAILURE;
+	}
+	else if (m_file != NULL && (m_openflags & OPEN_FLAG_WRITE) == 0)
+	{
+		length = core_fsize(m_file);
+		offset = core_ftell(m_file);
+		file_error filerr = core_fmap(m_file, &m_mapping, &m_mapbase);
+		if (filerr != FILERR_NONE)
+			return filerr;
+	}
+	else
+		return FILERR_FAILURE;
+
+	// swap in a RAM file over the mapped data
+	core_file *ramfile;
+	file_error filerr = core_fopen_ram(m_mapbase, length, m_openflags, &ramfile);
+	if (filerr != FILERR_NONE)
+	{
+		osd_unmap(m_mapping);
+		m_mapping = NULL;
+		m_mapbase = NULL;
+		return filerr;
+	}
+	core_fseek(ramfile, offset, SEEK_SET);
+	if (m_file != NULL)
+		core_fclose(m_file);
+	m_file = ramfile;
+	return FILERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  detach_mapping - hand the mapped data over to
+//  the caller, who becomes responsible for
+//  unmapping it; the file may be read until then
+//-------------------------------------------------
+
+osd_file_mapping *emu_file::detach_mapping(void *&base)
+{
+	osd_file_mapping *mapping = m_mapping;
+	base = m_mapbase;
+	m_mapping = NULL;
+	m_mapbase = NULL;
+	return mapping;
 }
 
 
@@ -673,20 +836,20 @@ file_error emu_file::attempt_zipped()
 
 		// see if we can find a file with the right name and (if available) crc
 		const zip_file_header *header;
-		for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
+		for (header = zip_file_first_named(zip, filename); header != NULL; header = zip_file_next_named(zip))
 			if (zip_filename_match(*header, filename) && (!(m_openflags & OPEN_FLAG_HAS_CRC) || header->crc == m_crc))
 				break;
 
 		// if that failed, look for a file with the right crc, but the wrong filename
 		if (header == NULL && (m_openflags & OPEN_FLAG_HAS_CRC))
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-				if (header->crc == m_crc && !zip_header_is_path(*header))
+			for (header = zip_file_first_crc(zip, m_crc); header != NULL; header = zip_file_next_crc(zip))
+				if (!zip_header_is_path(*header))
 					break;
 
 		// if that failed, look for a file with the right name; reporting a bad checksum
 		// is more helpful and less confusing than reporting "rom not found"
 		if (header == NULL)
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
+			for (header = zip_file_first_named(zip, filename); header != NULL; header = zip_file_next_named(zip))
 				if (zip_filename_match(*header, filename))
 					break;
 
@@ -695,6 +858,7 @@ file_error emu_file::attempt_zipped()
 		{
 			m_zipfile = zip;
 			m_ziplength = header->uncompressed_length;
+			m_zipmember.cpy(header->filename);
 
 			// build a hash with just the CRC
 			m_hashes.reset();
@@ -713,6 +877,30 @@ file_error emu_file::attempt_zipped()
 //-------------------------------------------------
 
 file_error emu_file::load_zipped_file()
+{
+	assert(m_zipfile != NULL);
+
+	// decompress the data unless preload() already loaded or mapped it
+	if (m_file == NULL)
+	{
+		file_error filerr = decompress_zipped_file();
+		if (filerr != FILERR_NONE)
+			return filerr;
+	}
+
+	// close out the ZIP file
+	zip_file_close(m_zipfile);
+	m_zipfile = NULL;
+	return FILERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  decompress_zipped_file - decompress a ZIPped
+//  file into a RAM file, leaving the ZIP open
+//-------------------------------------------------
+
+file_error emu_file::decompress_zipped_file()
 {
 	assert(m_file == NULL);
 	assert(m_zipdata == NULL);
@@ -738,10 +926,6 @@ file_error emu_file::load_zipped_file()
 		m_zipdata = NULL;
 		return FILERR_FAILURE;
 	}
-
-	// close out the ZIP file
-	zip_file_close(m_zipfile);
-	m_zipfile = NULL;
 	return FILERR_NONE;
 }
 
@@ -159,6 +159,7 @@ public:
 	const char *fullpath() const { return m_fullpath; }
 	UINT32 openflags() const { return m_openflags; }
 	hash_collection &hashes(const char *types);
+	bool cached_hashes(const char *types);
 
 	// setters
 	void remove_on_close() { m_remove_on_close = true; }
@@ -177,6 +178,14 @@ public:
 	file_error open_ram(const void *data, UINT32 length);
 	void close();
 
+	// preloading; safe to call from a worker thread
+	file_error preload(const char *types);
+
+	// mapping; a mapped file is read in place instead of being copied, and
+	// the mapping can be handed over to outlive the file
+	file_error map();
+	osd_file_mapping *detach_mapping(void *&base);
+
 	// control
 	file_error compress(int compress);
 	int seek(INT64 offset, int whence);
@@ -200,6 +209,8 @@ private:
 	// internal helpers
 	file_error attempt_zipped();
 	file_error load_zipped_file();
+	file_error decompress_zipped_file();
+	bool hash_cache_key(astring &path, UINT64 &length, UINT64 &modified);
 	bool zip_filename_match(const zip_file_header &header, const astring &filename);
 	bool zip_header_is_path(const zip_file_header &header);
 
@@ -214,6 +225,9 @@ private:
 	zip_file *		m_zipfile;						// ZIP file pointer
 	UINT8 *			m_zipdata;						// ZIP file data
 	UINT64			m_ziplength;					// ZIP file length
+	astring			m_zipmember;					// name of the file within the ZIP
+	osd_file_mapping *m_mapping;					// mapped view of the file's data
+	void *			m_mapbase;						// start of the mapped data
 	bool			m_remove_on_close;				// flag: remove the file when closing
 };
 
@@ -0,0 +1,305 @@
+/***************************************************************************
+
+    hashcache.c
+
+    Persistent cache of the hashes computed for ROM files.
+
+    Hashing a full ROM set means inflating and checksumming every file,
+    which dominates both -verifyroms and the start of a game. The cache
+    remembers the hashes computed for each file (or each member of a ZIP
+    archive) along with the length and last-modified stamp of the file
+    on disk, and hands them back for as long as neither changes.
+
+    The cache lives in the configuration directory as a text file, one
+    entry per line:
+
+        length <TAB> modified <TAB> hashes <TAB> path <TAB> member
+
+    where the hashes use the internal string form from hash.c and the
+    member is empty for plain files.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "emuopts.h"
+#include "hashcache.h"
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define HASHCACHE_FILENAME		"hashcache.dat"
+#define HASHCACHE_HEADER		"# MAME hash cache v1"
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _hashcache_entry hashcache_entry;
+struct _hashcache_entry
+{
+	hashcache_entry *	next;				/* next entry in the list */
+	UINT64				length;				/* length of the file's data */
+	UINT64				modified;			/* last-modified stamp of the file or archive */
+	astring				key;				/* path and member, separated by a tab */
+	astring				hashes;				/* hashes, in internal string form */
+};
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+static osd_lock *cache_lock;
+static hashcache_entry *cache_list;
+static tagmap_t<hashcache_entry *> cache_map;
+static astring cache_filename;
+static bool cache_force;
+static bool cache_dirty;
+
+
+
+/***************************************************************************
+    IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    make_key - build the lookup key for a file
+-------------------------------------------------*/
+
+INLINE const char *make_key(astring &key, const char *path, const char *member)
+{
+	return key.cpy(path).cat("\t").cat((member != NULL) ? member : "");
+}
+
+
+/*-------------------------------------------------
+    add_entry - add or replace an entry; the
+    lock must be held
+-------------------------------------------------*/
+
+static void add_entry(const char *key, UINT64 length, UINT64 modified, const char *hashes)
+{
+	hashcache_entry *entry = cache_map.find(key);
+
+	/* reuse the existing entry for this file, if any */
+	if (entry == NULL)
+	{
+		entry = global_alloc(hashcache_entry);
+		entry->key.cpy(key);
+		entry->next = cache_list;
+		cache_list = entry;
+		cache_map.add(entry->key, entry);
+	}
+	entry->length = length;
+	entry->modified = modified;
+	entry->hashes.cpy(hashes);
+}
+
+
+/*-------------------------------------------------
+    load_cache - read the cache file
+-------------------------------------------------*/
+
+static void load_cache(void)
+{
+	core_file *file;
+	char line[4096];
+
+	if (core_fopen(cache_filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return;
+
+	/* ignore files from other versions outright */
+	if (core_fgets(line, ARRAY_LENGTH(line), file) == NULL || strncmp(line, HASHCACHE_HEADER, strlen(HASHCACHE_HEADER)) != 0)
+	{
+		core_fclose(file);
+		return;
+	}
+
+	while (core_fgets(line, ARRAY_LENGTH(line), file) != NULL)
+	{
+		char *field[5];
+		int fieldnum;
+
+		/* split the line into its tab-separated fields */
+		field[0] = line;
+		for (fieldnum = 1; fieldnum < ARRAY_LENGTH(field); fieldnum++)
+		{
+			char *tab = strchr(field[fieldnum - 1], '\t');
+			if (tab == NULL)
+				break;
+			*tab = 0;
+			field[fieldnum] = tab + 1;
+		}
+		if (fieldnum != ARRAY_LENGTH(field))
+			continue;
+		field[4][strcspn(field[4], "\r\n")] = 0;
+
+		/* skip anything malformed */
+		UINT64 length, modified;
+		if (sscanf(field[0], "%" I64FMT "u", &length) != 1 || sscanf(field[1], "%" I64FMT "u", &modified) != 1)
+			continue;
+		if (!hash_collection().from_internal_string(field[2]))
+			continue;
+
+		astring key;
+		add_entry(make_key(key, field[3], field[4]), length, modified, field[2]);
+	}
+	core_fclose(file);
+}
+
+
+/*-------------------------------------------------
+    hashcache_init - load the cache, if it isn't
+    already
+-------------------------------------------------*/
+
+void hashcache_init(core_options &options)
+{
+	/* -forcehash recomputes everything, but still refreshes the cache */
+	cache_force = options_get_bool(&options, OPTION_FORCEHASH);
+
+	if (cache_lock != NULL)
+		return;
+	cache_lock = osd_lock_alloc();
+	if (cache_lock == NULL)
+		return;
+
+	cache_filename.cpy(options_get_string(&options, OPTION_CFG_DIRECTORY)).cat(PATH_SEPARATOR).cat(HASHCACHE_FILENAME);
+	cache_dirty = false;
+	load_cache();
+}
+
+
+/*-------------------------------------------------
+    hashcache_save - write the cache back out if
+    it has changed
+-------------------------------------------------*/
+
+void hashcache_save(void)
+{
+	core_file *file;
+
+	if (cache_lock == NULL)
+		return;
+	osd_lock_acquire(cache_lock);
+
+	if (cache_dirty && core_fopen(cache_filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file) == FILERR_NONE)
+	{
+		core_fprintf(file, "%s\n", HASHCACHE_HEADER);
+		for (hashcache_entry *entry = cache_list; entry != NULL; entry = entry->next)
+			core_fprintf(file, "%" I64FMT "u\t%" I64FMT "u\t%s\t%s\n", entry->length, entry->modified, entry->hashes.cstr(), entry->key.cstr());
+		core_fclose(file);
+		cache_dirty = false;
+	}
+
+	osd_lock_release(cache_lock);
+}
+
+
+/*-------------------------------------------------
+    hashcache_exit - save and free the cache
+-------------------------------------------------*/
+
+void hashcache_exit(void)
+{
+	if (cache_lock == NULL)
+		return;
+	hashcache_save();
+
+	cache_map.reset();
+	while (cache_list != NULL)
+	{
+		hashcache_entry *entry = cache_list;
+		cache_list = entry->next;
+		global_free(entry);
+	}
+
+	osd_lock_free(cache_lock);
+	cache_lock = NULL;
+}
+
+
+/*-------------------------------------------------
+    hashcache_lookup - add the cached hashes of
+    the requested types for a file
+-------------------------------------------------*/
+
+bool hashcache_lookup(const char *path, const char *member, UINT64 length, UINT64 modified, const char *types, hash_collection &hashes)
+{
+	/* a file without a modification stamp can't be trusted */
+	if (cache_lock == NULL || cache_force || modified == 0)
+		return false;
+
+	astring key, cached;
+	make_key(key, path, member);
+
+	osd_lock_acquire(cache_lock);
+	hashcache_entry *entry = cache_map.find(key);
+	bool found = (entry != NULL && entry->length == length && entry->modified == modified);
+	if (found)
+		cached.cpy(entry->hashes);
+	osd_lock_release(cache_lock);
+	if (!found)
+		return false;
+
+	/* every requested type must be there, and agree with anything already known (such as a ZIP's CRC) */
+	hash_collection cachedhashes(cached);
+	for (const char *scan = types; *scan != 0; scan++)
+		if (cachedhashes.hash(*scan) == NULL)
+			return false;
+	for (hash_base *hash = hashes.first(); hash != NULL; hash = hash->next())
+	{
+		hash_base *other = cachedhashes.hash(hash->id());
+		if (other != NULL && *other != *hash)
+			return false;
+	}
+
+	for (const char *scan = types; *scan != 0; scan++)
+	{
+		hash_base *hash = cachedhashes.hash(*scan);
+		hashes.add_from_buffer(*scan, hash->buffer(), hash->length());
+	}
+	return true;
+}
+
+
+/*-------------------------------------------------
+    hashcache_store - remember the hashes of a
+    file
+-------------------------------------------------*/
+
+void hashcache_store(const char *path, const char *member, UINT64 length, UINT64 modified, const hash_collection &hashes)
+{
+	if (cache_lock == NULL || modified == 0)
+		return;
+
+	astring key, string;
+	make_key(key, path, member);
+
+	osd_lock_acquire(cache_lock);
+	hashcache_entry *entry = cache_map.find(key);
+
+	/* keep any other types already cached for the same file */
+	hash_collection merged;
+	if (entry != NULL && entry->length == length && entry->modified == modified)
+		merged.from_internal_string(entry->hashes);
+	for (hash_base *hash = hashes.first(); hash != NULL; hash = hash->next())
+		merged.add_from_buffer(hash->id(), hash->buffer(), hash->length());
+	merged.internal_string(string);
+
+	if (entry == NULL || entry->length != length || entry->modified != modified || entry->hashes != string)
+	{
+		add_entry(key, length, modified, string);
+		cache_dirty = true;
+	}
+	osd_lock_release(cache_lock);
+}
@@ -0,0 +1,40 @@
+/***************************************************************************
+
+    hashcache.h
+
+    Persistent cache of the hashes computed for ROM files.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __HASHCACHE_H__
+#define __HASHCACHE_H__
+
+#include "hash.h"
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* load the cache from the configuration directory; until this is called, lookups miss and stores are dropped */
+void hashcache_init(core_options &options);
+
+/* write the cache back out if anything changed */
+void hashcache_save(void);
+
+/* save and free the cache */
+void hashcache_exit(void);
+
+/* fetch the cached hashes of the given types for a file, or a member of a ZIP archive; returns FALSE on a miss */
+bool hashcache_lookup(const char *path, const char *member, UINT64 length, UINT64 modified, const char *types, hash_collection &hashes);
+
+/* remember the hashes computed for a file */
+void hashcache_store(const char *path, const char *member, UINT64 length, UINT64 modified, const hash_collection &hashes);
+
+
+#endif	/* __HASHCACHE_H__ */
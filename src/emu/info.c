@@ -13,6 +13,7 @@
 #include "machine/ram.h"
 #include "sound/samples.h"
 #include "info.h"
+#include "infocache.h"
 #include "xmlfile.h"
 #include "hash.h"
 #include "config.h"
@@ -1035,14 +1036,13 @@ static void print_game_ramoptions(FILE *out, const game_driver *game, const mach
 }
 
 /*-------------------------------------------------
-    print_game_info - print the XML information
+    print_game_xml - print the XML information
     for one particular game driver
 -------------------------------------------------*/
 
-static void print_game_info(FILE *out, const game_driver *game)
+void print_game_xml(FILE *out, const game_driver *game, const machine_config &config)
 {
 	const game_driver *clone_of;
-	machine_config config(*game);
 	ioport_list portlist;
 	const char *start;
 
@@ -1275,7 +1275,14 @@ void print_mame_xml(FILE *out, const game_driver *const games[], const char *gam
 
 	for (drvnum = 0; games[drvnum] != NULL; drvnum++)
 		if (mame_strwildcmp(gamename, games[drvnum]->name) == 0)
-			print_game_info(out, games[drvnum]);
+		{
+			/* use the precompiled entry if we have one */
+			if (games == drivers && infocache_print_xml(out, drvnum))
+				continue;
+
+			machine_config config(*games[drvnum]);
+			print_game_xml(out, games[drvnum], config);
+		}
 
 	fprintf(out, "</" XML_ROOT ">\n");
 }
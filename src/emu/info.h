@@ -22,5 +22,8 @@
 /* print the MAME database in XML format */
 void print_mame_xml(FILE* out, const game_driver* const games[], const char *gamename);
 
+/* print the XML entry for a single game, given its machine configuration */
+void print_game_xml(FILE *out, const game_driver *game, const machine_config &config);
+
 
 #endif	/* __INFO_H__ */
@@ -0,0 +1,759 @@
+/***************************************************************************
+
+    infocache.c
+
+    Precompiled cache of driver information.
+
+    Everything -listxml and the front ends want to know about a driver
+    beyond its game_driver entry comes from instantiating its machine
+    configuration and input ports, which takes tens of seconds for the
+    full driver list. The cache does that once per build and keeps the
+    results in the configuration directory: a table of the commonly
+    queried values for each driver (screens, sound, inputs, ROMs and
+    disks) and a compressed copy of its -listxml entry.
+
+    The cache is keyed by the build stamp, which changes with every
+    link, and a CRC of the driver names and their ROM tables, so any
+    rebuild (machine configurations and input ports included) or a
+    different driver list (see -driver_config) rebuilds it. All values
+    are big-endian:
+
+    header:
+        [ 0] char   magic[8]        'MAMEinfo'
+        [ 8] UINT32 version         INFOCACHE_VERSION
+        [12] UINT32 key             CRC of the build and driver list
+        [16] UINT32 drivers         number of driver records
+        [20] UINT32 roms            number of ROM records
+        [24] UINT32 stringbytes     size of the string pool
+        [28] UINT32 xmlbytes        size of the compressed XML entries
+
+    driver record:
+        [ 0] UINT32 flags           INFOCACHE_FLAG_* flags
+        [ 4] UINT32 firstrom        index of its first ROM record
+        [ 8] UINT32 romcount        number of ROM records
+        [12] UINT32 samples         number of samples
+        [16] UINT32 refresh         refresh rate, as the bits of a float
+        [20] UINT16 width           visible width of the first screen
+        [22] UINT16 height          visible height of the first screen
+        [24] UINT8  screens, screentype, speakers, players
+        [28] UINT8  buttons, coins, 0, 0
+        [32] UINT32 xmloffset       offset of the compressed XML entry
+        [36] UINT32 xmlcompressed   its compressed length
+        [40] UINT32 xmllength       and its real length
+
+    ROM record:
+        [ 0] UINT32 name            string pool offsets
+        [ 4] UINT32 region
+        [ 8] UINT32 hashes
+        [12] UINT32 length
+        [16] UINT32 flags           INFOCACHE_ROM_* flags
+
+    followed by the string pool and the XML entries, each compressed
+    with zlib.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "emuopts.h"
+#include "info.h"
+#include "infocache.h"
+#include "sound/samples.h"
+#include <zlib.h>
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define INFOCACHE_FILENAME		"infocache.dat"
+#define INFOCACHE_TEMPNAME		"infocache.tmp"
+#define INFOCACHE_VERSION		1
+
+#define HEADER_SIZE				32
+#define DRIVER_SIZE				44
+#define ROM_SIZE				20
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+static infocache_driver *cache_drivers;		/* one entry per driver */
+static int cache_count;
+static infocache_rom *cache_roms;			/* ROM entries of all drivers */
+static char *cache_strings;					/* string pool, when loaded from disk */
+static UINT8 *cache_xml;					/* compressed XML entries, once loaded */
+static UINT32 cache_xmlbytes;
+static UINT64 cache_xmlstart;				/* where they start in the file */
+static UINT32 cache_key;					/* key of the build and driver list it belongs to */
+static astring cache_filename;
+static char *xml_buffer;					/* scratch space for inflating an entry */
+static UINT32 xml_buffer_size;
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    get/put_bigendian_* - pack and unpack values
+-------------------------------------------------*/
+
+INLINE UINT16 get_bigendian_uint16(const UINT8 *base)
+{
+	return (base[0] << 8) | base[1];
+}
+
+INLINE void put_bigendian_uint16(UINT8 *base, UINT16 value)
+{
+	base[0] = value >> 8;
+	base[1] = value;
+}
+
+INLINE UINT32 get_bigendian_uint32(const UINT8 *base)
+{
+	return (base[0] << 24) | (base[1] << 16) | (base[2] << 8) | base[3];
+}
+
+INLINE void put_bigendian_uint32(UINT8 *base, UINT32 value)
+{
+	base[0] = value >> 24;
+	base[1] = value >> 16;
+	base[2] = value >> 8;
+	base[3] = value;
+}
+
+
+/*-------------------------------------------------
+    grow_buffer - make room for 'needed' more
+    bytes at the end of a growing buffer
+-------------------------------------------------*/
+
+INLINE UINT8 *grow_buffer(UINT8 *buffer, UINT32 &alloc, UINT32 used, UINT32 needed)
+{
+	if (used + needed > alloc)
+	{
+		UINT32 newalloc = MAX(alloc * 2, used + needed);
+		UINT8 *newbuffer = global_alloc_array(UINT8, newalloc);
+		if (buffer != NULL)
+		{
+			memcpy(newbuffer, buffer, used);
+			global_free(buffer);
+		}
+		buffer = newbuffer;
+		alloc = newalloc;
+	}
+	return buffer;
+}
+
+
+
+/***************************************************************************
+    IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    compute_key - checksum the build and the
+    current driver list, including each driver's
+    own ROM table; the build stamp covers what
+    can't be checksummed without instantiating
+    every machine, like configs and input ports
+-------------------------------------------------*/
+
+static UINT32 compute_key(void)
+{
+	UINT32 key = crc32(0, (const Bytef *)build_version, strlen(build_version));
+	key = crc32(key, (const Bytef *)build_stamp, strlen(build_stamp));
+
+	for (int drvnum = 0; drivers[drvnum] != NULL; drvnum++)
+	{
+		const game_driver *gamedrv = drivers[drvnum];
+		key = crc32(key, (const Bytef *)gamedrv->name, strlen(gamedrv->name) + 1);
+
+		if (gamedrv->rom != NULL)
+			for (const rom_entry *rom = gamedrv->rom; !ROMENTRY_ISEND(rom); rom++)
+			{
+				UINT8 values[12];
+
+				if (rom->_name != NULL)
+					key = crc32(key, (const Bytef *)rom->_name, strlen(rom->_name));
+				if (rom->_hashdata != NULL)
+					key = crc32(key, (const Bytef *)rom->_hashdata, strlen(rom->_hashdata));
+				put_bigendian_uint32(&values[0], rom->_offset);
+				put_bigendian_uint32(&values[4], rom->_length);
+				put_bigendian_uint32(&values[8], rom->_flags);
+				key = crc32(key, values, sizeof(values));
+			}
+	}
+	return key;
+}
+
+
+/*-------------------------------------------------
+    free_cache - release everything we hold
+-------------------------------------------------*/
+
+static void free_cache(void)
+{
+	if (cache_drivers != NULL)
+		global_free(cache_drivers);
+	if (cache_roms != NULL)
+		global_free(cache_roms);
+	if (cache_strings != NULL)
+		global_free(cache_strings);
+	if (cache_xml != NULL)
+		global_free(cache_xml);
+	if (xml_buffer != NULL)
+		global_free(xml_buffer);
+	cache_drivers = NULL;
+	cache_count = 0;
+	cache_roms = NULL;
+	cache_strings = NULL;
+	cache_xml = NULL;
+	cache_xmlbytes = 0;
+	xml_buffer = NULL;
+	xml_buffer_size = 0;
+}
+
+
+/*-------------------------------------------------
+    load_cache - read the tables of the cache
+    file, leaving the XML entries until they are
+    asked for
+-------------------------------------------------*/
+
+static int load_cache(UINT32 key, int count)
+{
+	UINT8 header[HEADER_SIZE];
+	core_file *file;
+
+	if (core_fopen(cache_filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return FALSE;
+
+	/* anything from another build or driver list is useless */
+	if (core_fread(file, header, HEADER_SIZE) != HEADER_SIZE || memcmp(&header[0], "MAMEinfo", 8) != 0 ||
+		get_bigendian_uint32(&header[8]) != INFOCACHE_VERSION || get_bigendian_uint32(&header[12]) != key ||
+		get_bigendian_uint32(&header[16]) != (UINT32)count)
+	{
+		core_fclose(file);
+		return FALSE;
+	}
+	UINT32 romcount = get_bigendian_uint32(&header[20]);
+	UINT32 stringbytes = get_bigendian_uint32(&header[24]);
+	UINT32 xmlbytes = get_bigendian_uint32(&header[28]);
+	UINT64 tablebytes = (UINT64)count * DRIVER_SIZE + (UINT64)romcount * ROM_SIZE;
+	if (HEADER_SIZE + tablebytes + stringbytes + xmlbytes != core_fsize(file) || tablebytes > 0x7fffffff)
+	{
+		core_fclose(file);
+		return FALSE;
+	}
+
+	/* read the tables and the string pool */
+	UINT8 *tables = global_alloc_array(UINT8, tablebytes);
+	cache_strings = global_alloc_array(char, stringbytes + 1);
+	int success = (core_fread(file, tables, tablebytes) == tablebytes && core_fread(file, cache_strings, stringbytes) == stringbytes);
+	core_fclose(file);
+	cache_strings[stringbytes] = 0;
+
+	/* unpack the ROM records */
+	cache_roms = global_alloc_array_clear(infocache_rom, MAX(romcount, 1));
+	const UINT8 *data = tables + count * DRIVER_SIZE;
+	for (UINT32 romnum = 0; success && romnum < romcount; romnum++, data += ROM_SIZE)
+	{
+		infocache_rom *rom = &cache_roms[romnum];
+		UINT32 name = get_bigendian_uint32(&data[0]);
+		UINT32 region = get_bigendian_uint32(&data[4]);
+		UINT32 hashes = get_bigendian_uint32(&data[8]);
+
+		if (name > stringbytes || region > stringbytes || hashes > stringbytes)
+			success = FALSE;
+		else
+		{
+			rom->name = &cache_strings[name];
+			rom->region = &cache_strings[region];
+			rom->hashes = &cache_strings[hashes];
+			rom->length = get_bigendian_uint32(&data[12]);
+			rom->flags = get_bigendian_uint32(&data[16]);
+		}
+	}
+
+	/* unpack the driver records */
+	cache_drivers = global_alloc_array_clear(infocache_driver, MAX(count, 1));
+	data = tables;
+	for (int drvnum = 0; success && drvnum < count; drvnum++, data += DRIVER_SIZE)
+	{
+		infocache_driver *info = &cache_drivers[drvnum];
+		UINT32 firstrom = get_bigendian_uint32(&data[4]);
+		union { UINT32 i; float f; } refresh;
+
+		info->flags = get_bigendian_uint32(&data[0]);
+		info->romcount = get_bigendian_uint32(&data[8]);
+		info->roms = &cache_roms[MIN(firstrom, romcount)];
+		info->samples = get_bigendian_uint32(&data[12]);
+		refresh.i = get_bigendian_uint32(&data[16]);
+		info->refresh = refresh.f;
+		info->width = get_bigendian_uint16(&data[20]);
+		info->height = get_bigendian_uint16(&data[22]);
+		info->screens = data[24];
+		info->screentype = data[25];
+		info->speakers = data[26];
+		info->players = data[27];
+		info->buttons = data[28];
+		info->coins = data[29];
+		info->xmloffset = get_bigendian_uint32(&data[32]);
+		info->xmlcompressed = get_bigendian_uint32(&data[36]);
+		info->xmllength = get_bigendian_uint32(&data[40]);
+
+		if ((UINT64)firstrom + info->romcount > romcount || (UINT64)info->xmloffset + info->xmlcompressed > xmlbytes)
+			success = FALSE;
+	}
+	global_free(tables);
+
+	if (!success)
+	{
+		free_cache();
+		return FALSE;
+	}
+	cache_count = count;
+	cache_xmlstart = HEADER_SIZE + tablebytes + stringbytes;
+	cache_xmlbytes = xmlbytes;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    add_string - add a string to the pool being
+    written, returning its offset
+-------------------------------------------------*/
+
+static UINT32 add_string(UINT8 *&pool, UINT32 &alloc, UINT32 &used, const char *string)
+{
+	UINT32 offset = used;
+	UINT32 length = strlen(string) + 1;
+
+	pool = grow_buffer(pool, alloc, used, length);
+	memcpy(&pool[used], string, length);
+	used += length;
+	return offset;
+}
+
+
+/*-------------------------------------------------
+    save_cache - write the cache out
+-------------------------------------------------*/
+
+static void save_cache(UINT32 key, UINT32 romcount)
+{
+	UINT8 header[HEADER_SIZE];
+	core_file *file;
+
+	if (core_fopen(cache_filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file) != FILERR_NONE)
+		return;
+
+	/* pack the ROM records, building the string pool as we go; region tags repeat, so share those */
+	UINT32 tablebytes = cache_count * DRIVER_SIZE + romcount * ROM_SIZE;
+	UINT8 *tables = global_alloc_array_clear(UINT8, tablebytes);
+	UINT8 *pool = NULL;
+	UINT32 poolalloc = 0, poolbytes = 0;
+	const char *lastregion = NULL;
+	UINT32 lastregionoffset = 0;
+	UINT8 *data = tables + cache_count * DRIVER_SIZE;
+	for (UINT32 romnum = 0; romnum < romcount; romnum++, data += ROM_SIZE)
+	{
+		const infocache_rom *rom = &cache_roms[romnum];
+
+		if (rom->region != lastregion)
+		{
+			lastregion = rom->region;
+			lastregionoffset = add_string(pool, poolalloc, poolbytes, rom->region);
+		}
+		put_bigendian_uint32(&data[0], add_string(pool, poolalloc, poolbytes, rom->name));
+		put_bigendian_uint32(&data[4], lastregionoffset);
+		put_bigendian_uint32(&data[8], add_string(pool, poolalloc, poolbytes, rom->hashes));
+		put_bigendian_uint32(&data[12], rom->length);
+		put_bigendian_uint32(&data[16], rom->flags);
+	}
+
+	/* pack the driver records */
+	data = tables;
+	for (int drvnum = 0; drvnum < cache_count; drvnum++, data += DRIVER_SIZE)
+	{
+		const infocache_driver *info = &cache_drivers[drvnum];
+		union { UINT32 i; float f; } refresh;
+
+		refresh.f = info->refresh;
+		put_bigendian_uint32(&data[0], info->flags);
+		put_bigendian_uint32(&data[4], info->roms - cache_roms);
+		put_bigendian_uint32(&data[8], info->romcount);
+		put_bigendian_uint32(&data[12], info->samples);
+		put_bigendian_uint32(&data[16], refresh.i);
+		put_bigendian_uint16(&data[20], info->width);
+		put_bigendian_uint16(&data[22], info->height);
+		data[24] = info->screens;
+		data[25] = info->screentype;
+		data[26] = info->speakers;
+		data[27] = info->players;
+		data[28] = info->buttons;
+		data[29] = info->coins;
+		put_bigendian_uint32(&data[32], info->xmloffset);
+		put_bigendian_uint32(&data[36], info->xmlcompressed);
+		put_bigendian_uint32(&data[40], info->xmllength);
+	}
+
+	/* build the header */
+	memcpy(&header[0], "MAMEinfo", 8);
+	put_bigendian_uint32(&header[8], INFOCACHE_VERSION);
+	put_bigendian_uint32(&header[12], key);
+	put_bigendian_uint32(&header[16], cache_count);
+	put_bigendian_uint32(&header[20], romcount);
+	put_bigendian_uint32(&header[24], poolbytes);
+	put_bigendian_uint32(&header[28], cache_xmlbytes);
+
+	/* write it all out; a partial file is worse than none */
+	int success = (core_fwrite(file, header, HEADER_SIZE) == HEADER_SIZE && core_fwrite(file, tables, tablebytes) == tablebytes &&
+		core_fwrite(file, pool, poolbytes) == poolbytes && core_fwrite(file, cache_xml, cache_xmlbytes) == cache_xmlbytes);
+	core_fclose(file);
+	if (!success)
+		osd_rmfile(cache_filename);
+
+	global_free(tables);
+	if (pool != NULL)
+		global_free(pool);
+}
+
+
+/*-------------------------------------------------
+    gather_driver - fill in the information for
+    a driver from its machine configuration,
+    appending its ROMs to the ROM table
+-------------------------------------------------*/
+
+static void gather_driver(const game_driver *gamedrv, const machine_config &config, infocache_driver *info, UINT32 &romalloc, UINT32 &romcount)
+{
+	/* screens */
+	for (const screen_device_config *screen = config.first_screen(); screen != NULL; screen = screen->next_screen())
+	{
+		if (info->screens++ == 0)
+		{
+			info->screentype = screen->screen_type();
+			if (screen->screen_type() != SCREEN_TYPE_VECTOR)
+			{
+				const rectangle &visarea = screen->visible_area();
+				info->width = visarea.max_x - visarea.min_x + 1;
+				info->height = visarea.max_y - visarea.min_y + 1;
+			}
+			info->refresh = ATTOSECONDS_TO_HZ(screen->refresh());
+		}
+		if (screen->screen_type() == SCREEN_TYPE_VECTOR)
+			info->flags |= INFOCACHE_FLAG_VECTOR;
+	}
+
+	/* sound; speakers without any sound devices don't count */
+	const device_config_sound_interface *sound = NULL;
+	if (config.m_devicelist.first(sound))
+		info->speakers = config.m_devicelist.count(SPEAKER);
+
+	/* samples */
+	for (bool gotone = config.m_devicelist.first(sound); gotone; gotone = sound->next(sound))
+		if (sound->devconfig().type() == SAMPLES)
+		{
+			const samples_interface *intf = (const samples_interface *)sound->devconfig().static_config();
+			if (intf->samplenames != NULL)
+				for (int sampnum = 0; intf->samplenames[sampnum] != NULL; sampnum++)
+					if (intf->samplenames[sampnum][0] != '*')
+						info->samples++;
+		}
+	if (info->samples > 0)
+		info->flags |= INFOCACHE_FLAG_SAMPLES;
+
+	/* BIOS sets */
+	if (gamedrv->rom != NULL)
+		for (const rom_entry *rom = gamedrv->rom; !ROMENTRY_ISEND(rom); rom++)
+			if (ROMENTRY_ISSYSTEM_BIOS(rom))
+			{
+				info->flags |= INFOCACHE_FLAG_BIOS_SETS;
+				break;
+			}
+
+	/* ROMs and disks */
+	UINT32 firstrom = romcount;
+	for (const rom_source *source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
+		for (const rom_entry *region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
+		{
+			int is_disk = ROMREGION_ISDISKDATA(region);
+			if (is_disk)
+				info->flags |= INFOCACHE_FLAG_DISKS;
+
+			for (const rom_entry *rom = rom_first_file(region); rom != NULL; rom = rom_next_file(rom))
+			{
+				/* grow the table as needed */
+				if (romcount == romalloc)
+				{
+					UINT32 newalloc = MAX(romalloc * 2, 4096);
+					infocache_rom *newroms = global_alloc_array_clear(infocache_rom, newalloc);
+					if (cache_roms != NULL)
+					{
+						memcpy(newroms, cache_roms, romcount * sizeof(*newroms));
+						global_free(cache_roms);
+					}
+					cache_roms = newroms;
+					romalloc = newalloc;
+				}
+
+				infocache_rom *entry = &cache_roms[romcount++];
+				entry->name = ROM_GETNAME(rom);
+				entry->region = ROMREGION_GETTAG(region);
+				entry->hashes = ROM_GETHASHDATA(rom);
+				if (!is_disk)
+					entry->length = rom_file_size(rom);
+				if (is_disk)
+					entry->flags |= INFOCACHE_ROM_DISK;
+				if ((!is_disk && ROM_ISOPTIONAL(rom)) || (is_disk && DISK_ISOPTIONAL(rom)))
+					entry->flags |= INFOCACHE_ROM_OPTIONAL;
+				if (!is_disk && ROM_GETBIOSFLAGS(rom) != 0)
+					entry->flags |= INFOCACHE_ROM_BIOS;
+			}
+		}
+
+	/* the ROM table may have moved, so remember an index for now */
+	info->roms = (const infocache_rom *)(FPTR)firstrom;
+	info->romcount = romcount - firstrom;
+
+	/* inputs, counted the same way as -listxml does */
+	ioport_list portlist;
+	input_port_list_init(portlist, gamedrv->ipt, NULL, 0, FALSE, NULL);
+	for (device_config *cfg = config.m_devicelist.first(); cfg != NULL; cfg = cfg->next())
+		if (cfg->input_ports() != NULL)
+			input_port_list_init(portlist, cfg->input_ports(), NULL, 0, FALSE, cfg);
+
+	for (const input_port_config *port = portlist.first(); port != NULL; port = port->next())
+		for (const input_field_config *field = port->fieldlist; field != NULL; field = field->next)
+		{
+			info->players = MAX(info->players, field->player + 1);
+
+			if (field->type >= IPT_JOYSTICK_UP && field->type <= IPT_JOYSTICK_RIGHT)
+				info->flags |= INFOCACHE_FLAG_JOYSTICK;
+			else if (field->type >= IPT_JOYSTICKRIGHT_UP && field->type <= IPT_JOYSTICKLEFT_RIGHT)
+				info->flags |= INFOCACHE_FLAG_DOUBLEJOY;
+			else if (field->type >= IPT_BUTTON1 && field->type <= IPT_BUTTON16)
+				info->buttons = MAX(info->buttons, field->type - IPT_BUTTON1 + 1);
+			else if (field->type >= IPT_COIN1 && field->type <= IPT_COIN8)
+				info->coins = MAX(info->coins, field->type - IPT_COIN1 + 1);
+
+			switch (field->type)
+			{
+				case IPT_AD_STICK_X:
+				case IPT_AD_STICK_Y:
+				case IPT_AD_STICK_Z:	info->flags |= INFOCACHE_FLAG_AD_STICK;		break;
+				case IPT_DIAL:
+				case IPT_DIAL_V:		info->flags |= INFOCACHE_FLAG_DIAL;			break;
+				case IPT_TRACKBALL_X:
+				case IPT_TRACKBALL_Y:	info->flags |= INFOCACHE_FLAG_TRACKBALL;	break;
+				case IPT_PADDLE:
+				case IPT_PADDLE_V:		info->flags |= INFOCACHE_FLAG_PADDLE;		break;
+				case IPT_LIGHTGUN_X:
+				case IPT_LIGHTGUN_Y:	info->flags |= INFOCACHE_FLAG_LIGHTGUN;		break;
+				case IPT_PEDAL:
+				case IPT_PEDAL2:
+				case IPT_PEDAL3:		info->flags |= INFOCACHE_FLAG_PEDAL;		break;
+				case IPT_MOUSE_X:
+				case IPT_MOUSE_Y:		info->flags |= INFOCACHE_FLAG_MOUSE;		break;
+				case IPT_KEYPAD:		info->flags |= INFOCACHE_FLAG_KEYPAD;		break;
+				case IPT_KEYBOARD:		info->flags |= INFOCACHE_FLAG_KEYBOARD;		break;
+			}
+		}
+}
+
+
+/*-------------------------------------------------
+    build_cache - instantiate every driver's
+    configuration to build the cache, and save it
+-------------------------------------------------*/
+
+static int build_cache(UINT32 key, int count, const char *tempname)
+{
+	UINT32 romalloc = 0, romcount = 0;
+	UINT32 xmlalloc = 0;
+	core_file *probe;
+	FILE *temp;
+
+	/* the XML printers want a FILE, so entries are captured through a scratch file; core_fopen makes sure the directory exists */
+	if (core_fopen(tempname, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &probe) != FILERR_NONE)
+		return FALSE;
+	core_fclose(probe);
+	temp = fopen(tempname, "w+b");
+	if (temp == NULL)
+		return FALSE;
+
+	mame_printf_warning(_("Generating driver info cache...\n"));
+
+	int success = TRUE;
+	cache_drivers = global_alloc_array_clear(infocache_driver, MAX(count, 1));
+	for (int drvnum = 0; success && drvnum < count; drvnum++)
+	{
+		const game_driver *gamedrv = drivers[drvnum];
+		infocache_driver *info = &cache_drivers[drvnum];
+		machine_config config(*gamedrv);
+
+		gather_driver(gamedrv, config, info, romalloc, romcount);
+
+		/* capture the -listxml entry */
+		fseek(temp, 0, SEEK_SET);
+		print_game_xml(temp, gamedrv, config);
+		long length = ftell(temp);
+		if (length <= 0)
+			continue;
+		if ((UINT32)length > xml_buffer_size)
+		{
+			if (xml_buffer != NULL)
+				global_free(xml_buffer);
+			xml_buffer_size = length;
+			xml_buffer = global_alloc_array(char, xml_buffer_size);
+		}
+		fseek(temp, 0, SEEK_SET);
+		if (fread(xml_buffer, 1, length, temp) != (size_t)length)
+		{
+			success = FALSE;
+			break;
+		}
+
+		/* and keep it compressed */
+		uLongf compressed = compressBound(length);
+		cache_xml = grow_buffer(cache_xml, xmlalloc, cache_xmlbytes, compressed);
+		if (compress2(&cache_xml[cache_xmlbytes], &compressed, (const Bytef *)xml_buffer, length, Z_DEFAULT_COMPRESSION) != Z_OK)
+		{
+			success = FALSE;
+			break;
+		}
+		info->xmloffset = cache_xmlbytes;
+		info->xmlcompressed = compressed;
+		info->xmllength = length;
+		cache_xmlbytes += compressed;
+	}
+	fclose(temp);
+	osd_rmfile(tempname);
+	if (!success)
+	{
+		free_cache();
+		return FALSE;
+	}
+
+	/* now that the ROM table is complete, point each driver into it */
+	if (cache_roms == NULL)
+		cache_roms = global_alloc_array_clear(infocache_rom, 1);
+	for (int drvnum = 0; drvnum < count; drvnum++)
+		cache_drivers[drvnum].roms = &cache_roms[(FPTR)cache_drivers[drvnum].roms];
+	cache_count = count;
+
+	save_cache(key, romcount);
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    infocache_init - load the cache, building it
+    if asked to and it's missing or stale
+-------------------------------------------------*/
+
+void infocache_init(core_options &options, int build)
+{
+	/* -noinfocache always works from the drivers themselves */
+	if (!options_get_bool(&options, OPTION_INFOCACHE))
+	{
+		free_cache();
+		return;
+	}
+
+	int count = driver_list_get_count(drivers);
+	UINT32 key = compute_key();
+
+	/* the driver list can change under -driver_config, so start over if it has */
+	if (cache_drivers != NULL && cache_count == count && cache_key == key)
+		return;
+	free_cache();
+	cache_key = key;
+
+	astring tempname;
+	cache_filename.cpy(options_get_string(&options, OPTION_CFG_DIRECTORY)).cat(PATH_SEPARATOR).cat(INFOCACHE_FILENAME);
+	tempname.cpy(options_get_string(&options, OPTION_CFG_DIRECTORY)).cat(PATH_SEPARATOR).cat(INFOCACHE_TEMPNAME);
+
+	if (!load_cache(key, count) && build)
+		build_cache(key, count, tempname);
+}
+
+
+/*-------------------------------------------------
+    infocache_exit - free the cache
+-------------------------------------------------*/
+
+void infocache_exit(void)
+{
+	free_cache();
+}
+
+
+/*-------------------------------------------------
+    infocache_get - return the information for
+    a driver
+-------------------------------------------------*/
+
+const infocache_driver *infocache_get(int drvindex)
+{
+	if (drvindex < 0 || drvindex >= cache_count)
+		return NULL;
+	return &cache_drivers[drvindex];
+}
+
+
+/*-------------------------------------------------
+    infocache_print_xml - write the -listxml
+    entry for a driver
+-------------------------------------------------*/
+
+int infocache_print_xml(FILE *out, int drvindex)
+{
+	const infocache_driver *info = infocache_get(drvindex);
+	if (info == NULL)
+		return FALSE;
+
+	/* entries that print nothing, such as devices, are still answered */
+	if (info->xmllength == 0)
+		return TRUE;
+
+	/* read in the compressed entries the first time they're wanted */
+	if (cache_xml == NULL)
+	{
+		core_file *file;
+		if (core_fopen(cache_filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+			return FALSE;
+		cache_xml = global_alloc_array(UINT8, cache_xmlbytes);
+		if (core_fseek(file, cache_xmlstart, SEEK_SET) != 0 || core_fread(file, cache_xml, cache_xmlbytes) != cache_xmlbytes)
+		{
+			global_free(cache_xml);
+			cache_xml = NULL;
+		}
+		core_fclose(file);
+		if (cache_xml == NULL)
+			return FALSE;
+	}
+
+	/* inflate and write it */
+	if (info->xmllength > xml_buffer_size)
+	{
+		if (xml_buffer != NULL)
+			global_free(xml_buffer);
+		xml_buffer_size = info->xmllength;
+		xml_buffer = global_alloc_array(char, xml_buffer_size);
+	}
+	uLongf length = info->xmllength;
+	if (uncompress((Bytef *)xml_buffer, &length, &cache_xml[info->xmloffset], info->xmlcompressed) != Z_OK || length != info->xmllength)
+		return FALSE;
+	fwrite(xml_buffer, 1, length, out);
+	return TRUE;
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+
+    infocache.h
+
+    Precompiled cache of driver information.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __INFOCACHE_H__
+#define __INFOCACHE_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* flags for infocache_driver.flags */
+#define INFOCACHE_FLAG_DISKS		0x00000001	/* needs one or more disk images */
+#define INFOCACHE_FLAG_BIOS_SETS	0x00000002	/* has selectable BIOS sets */
+#define INFOCACHE_FLAG_SAMPLES		0x00000004	/* uses samples */
+#define INFOCACHE_FLAG_VECTOR		0x00000008	/* has a vector screen */
+#define INFOCACHE_FLAG_JOYSTICK		0x00000100	/* inputs include a joystick */
+#define INFOCACHE_FLAG_DOUBLEJOY	0x00000200	/* ... a pair of joysticks */
+#define INFOCACHE_FLAG_AD_STICK		0x00000400	/* ... an analog stick */
+#define INFOCACHE_FLAG_DIAL			0x00000800	/* ... a dial */
+#define INFOCACHE_FLAG_TRACKBALL	0x00001000	/* ... a trackball */
+#define INFOCACHE_FLAG_PADDLE		0x00002000	/* ... a paddle */
+#define INFOCACHE_FLAG_LIGHTGUN		0x00004000	/* ... a light gun */
+#define INFOCACHE_FLAG_PEDAL		0x00008000	/* ... a pedal */
+#define INFOCACHE_FLAG_MOUSE		0x00010000	/* ... a mouse */
+#define INFOCACHE_FLAG_KEYPAD		0x00020000	/* ... a keypad */
+#define INFOCACHE_FLAG_KEYBOARD		0x00040000	/* ... a keyboard */
+
+/* flags for infocache_rom.flags */
+#define INFOCACHE_ROM_DISK			0x01		/* entry is a disk image */
+#define INFOCACHE_ROM_OPTIONAL		0x02		/* entry is optional */
+#define INFOCACHE_ROM_BIOS			0x04		/* entry belongs to a BIOS set */
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _infocache_rom infocache_rom;
+struct _infocache_rom
+{
+	const char *		name;				/* name of the file */
+	const char *		region;				/* tag of the region it loads into */
+	const char *		hashes;				/* expected hashes, in internal string form */
+	UINT32				length;				/* length of the file (0 for disks) */
+	UINT32				flags;				/* INFOCACHE_ROM_* flags */
+};
+
+
+typedef struct _infocache_driver infocache_driver;
+struct _infocache_driver
+{
+	UINT32				flags;				/* INFOCACHE_FLAG_* flags */
+	UINT8				screens;			/* number of screens */
+	UINT8				screentype;			/* SCREEN_TYPE_* of the first screen */
+	UINT16				width;				/* visible width of the first screen */
+	UINT16				height;				/* visible height of the first screen */
+	float				refresh;			/* refresh rate of the first screen, in Hz */
+	UINT8				speakers;			/* number of speakers, or 0 without sound */
+	UINT8				players;			/* number of players */
+	UINT8				buttons;			/* number of buttons per player */
+	UINT8				coins;				/* number of coin slots */
+	int					samples;			/* number of samples */
+	int					romcount;			/* number of ROM and disk entries */
+	const infocache_rom *roms;				/* ROM and disk entries, in the order of their sources and regions */
+
+	/* internal */
+	UINT32				xmloffset;			/* offset of the compressed XML entry */
+	UINT32				xmlcompressed;		/* its compressed length */
+	UINT32				xmllength;			/* and its real length */
+};
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* load the cache for the current build and driver list; if it's missing or stale, rebuild it when 'build' is set */
+void infocache_init(core_options &options, int build);
+
+/* free the cache */
+void infocache_exit(void);
+
+/* return the cached information for drivers[drvindex], or NULL if there is no cache */
+const infocache_driver *infocache_get(int drvindex);
+
+/* write the cached -listxml entry for drivers[drvindex]; returns FALSE if there is no cache */
+int infocache_print_xml(FILE *out, int drvindex);
+
+
+#endif	/* __INFOCACHE_H__ */
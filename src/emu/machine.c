@@ -379,6 +379,7 @@ void running_machine::start()
 
 	// disallow save state registrations starting here
 	m_state.allow_registration(false);
+	mame_startup_mark(STARTUP_PHASE_MACHINE);
 }
 
 
@@ -657,10 +658,12 @@ void running_machine::resume()
 
 
 //-------------------------------------------------
-//  region_alloc - allocates memory for a region
+//  region_alloc - allocates memory for a region,
+//  or wraps a file mapping that the region then
+//  owns
 //-------------------------------------------------
 
-memory_region *running_machine::region_alloc(const char *name, UINT32 length, UINT32 flags)
+memory_region *running_machine::region_alloc(const char *name, UINT32 length, UINT32 flags, osd_file_mapping *mapping, void *base)
 {
     // make sure we don't have a region of the same name; also find the end of the list
     memory_region *info = m_regionlist.find(name);
@@ -668,7 +671,23 @@ memory_region *running_machine::region_alloc(const char *name, UINT32 length, UI
 		fatalerror("region_alloc called with duplicate region name \"%s\"\n", name);
 
 	// allocate the region
-	return &m_regionlist.append(name, *auto_alloc(this, memory_region(*this, name, length, flags)));
+	return &m_regionlist.append(name, *auto_alloc(this, memory_region(*this, name, length, flags, mapping, base)));
+}
+
+
+//-------------------------------------------------
+//  region - find a region by tag, finishing the
+//  load of one held back by -faststart on first
+//  use
+//-------------------------------------------------
+
+const memory_region *running_machine::region(const char *tag)
+{
+	const memory_region *region = m_regionlist.find(tag);
+
+	if (region != NULL && region->deferred())
+		rom_load_deferred(this);
+	return region;
 }
 
 
@@ -847,6 +866,9 @@ void running_machine::handle_saveload()
 	filerr = file.open(m_saveload_pending_file);
 	if (filerr == FILERR_NONE)
 	{
+		// sound render threads must not touch chip state while it is saved or loaded
+		m_sound->sync_write_logs();
+
 		// read/write the save state
 		state_save_error staterr = (m_saveload_schedule == SLS_LOAD) ? m_state.read_file(file) : m_state.write_file(file);
 
@@ -937,14 +959,19 @@ void running_machine::logfile_callback(running_machine &machine, const char *buf
 //  memory_region - constructor
 //-------------------------------------------------
 
-memory_region::memory_region(running_machine &machine, const char *name, UINT32 length, UINT32 flags)
+memory_region::memory_region(running_machine &machine, const char *name, UINT32 length, UINT32 flags, osd_file_mapping *mapping, void *base)
 	: m_machine(machine),
 	  m_next(NULL),
 	  m_name(name),
 	  m_length(length),
-	  m_flags(flags)
+	  m_flags(flags),
+	  m_mapping(mapping),
+	  m_deferred(false)
 {
-	m_base.u8 = auto_alloc_array(&machine, UINT8, length);
+	if (m_mapping != NULL)
+		m_base.v = base;
+	else
+		m_base.u8 = auto_alloc_array(&machine, UINT8, length);
 }
 
 
@@ -954,7 +981,10 @@ memory_region::memory_region(running_machine &machine, const char *name, UINT32
 
 memory_region::~memory_region()
 {
-	auto_free(&m_machine, m_base.v);
+	if (m_mapping != NULL)
+		osd_unmap(m_mapping);
+	else
+		auto_free(&m_machine, m_base.v);
 }
 
 
@@ -214,7 +214,7 @@ class memory_region
 	friend resource_pool_object<memory_region>::~resource_pool_object();
 
 	// construction/destruction
-	memory_region(running_machine &machine, const char *name, UINT32 length, UINT32 flags);
+	memory_region(running_machine &machine, const char *name, UINT32 length, UINT32 flags, osd_file_mapping *mapping, void *base);
 	~memory_region();
 
 public:
@@ -225,6 +225,10 @@ public:
 	UINT32 bytes() const { return (this != NULL) ? m_length : 0; }
 	const char *name() const { return m_name; }
 	UINT32 flags() const { return m_flags; }
+	bool deferred() const { return m_deferred; }
+
+	// setters
+	void set_deferred(bool deferred) { m_deferred = deferred; }
 
 	// flag expansion
 	endianness_t endianness() const { return ((m_flags & ROMREGION_ENDIANMASK) == ROMREGION_LE) ? ENDIANNESS_LITTLE : ENDIANNESS_BIG; }
@@ -256,6 +260,8 @@ private:
 	generic_ptr				m_base;
 	UINT32					m_length;
 	UINT32					m_flags;
+	osd_file_mapping *		m_mapping;			// file mapping backing the data, or NULL if allocated
+	bool					m_deferred;			// contents not loaded yet (-faststart)
 };
 
 
@@ -330,7 +336,8 @@ public:
 	inline device_t *device(const char *tag);
 	template<class T> inline T *device(const char *tag) { return downcast<T *>(device(tag)); }
 	inline const input_port_config *port(const char *tag);
-	inline const memory_region *region(const char *tag);
+	const memory_region *region(const char *tag);
+	inline const memory_region *region_noload(const char *tag);
 
 	// configuration helpers
 	UINT32 total_colors() const { return m_config.m_total_colors; }
@@ -376,7 +383,7 @@ public:
 	void current_datetime(system_time &systime);
 
 	// regions
-	memory_region *region_alloc(const char *name, UINT32 length, UINT32 flags);
+	memory_region *region_alloc(const char *name, UINT32 length, UINT32 flags, osd_file_mapping *mapping = NULL, void *base = NULL);
 	void region_free(const char *name);
 
 	// managers
@@ -648,8 +655,9 @@ inline const input_port_config *running_machine::port(const char *tag)
 	return m_portlist.find(tag);
 }
 
-inline const memory_region *running_machine::region(const char *tag)
+inline const memory_region *running_machine::region_noload(const char *tag)
 {
+	// only for holding on to a region's pointer while it may still be loading
 	return m_regionlist.find(tag);
 }
 
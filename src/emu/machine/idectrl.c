@@ -789,11 +789,24 @@ static TIMER_CALLBACK( read_sector_done_callback )
 }
 
 
+static void start_async_read(ide_state *ide)
+{
+	/* let the host decompress the sector while the emulated drive seeks; read_sector_done collects it */
+	if (ide->disk && !ide->gnetreadlock)
+		hard_disk_read_async(ide->disk, lba_address(ide));
+}
+
+
 static void read_first_sector(ide_state *ide)
 {
 	/* mark ourselves busy */
 	ide->status |= IDE_STATUS_BUSY;
 
+	/* the command tells us how far the transfer will run, so prefetch all of it */
+	if (ide->disk && !ide->gnetreadlock)
+		hard_disk_prefetch(ide->disk, lba_address(ide), ide->sector_count);
+	start_async_read(ide);
+
 	/* just set a timer */
 	if (ide->command == IDE_COMMAND_READ_MULTIPLE_BLOCK)
 	{
@@ -824,12 +837,18 @@ static void read_next_sector(ide_state *ide)
 			/* make ready now */
 			read_sector_done(ide);
 		else
+		{
 			/* just set a timer */
+			start_async_read(ide);
 			ide->device->machine->scheduler().timer_set(attotime::from_usec(1), FUNC(read_sector_done_callback), 0, ide);
+		}
 	}
 	else
+	{
 		/* just set a timer */
+		start_async_read(ide);
 		ide->device->machine->scheduler().timer_set(TIME_PER_SECTOR, FUNC(read_sector_done_callback), 0, ide);
+	}
 }
 
 
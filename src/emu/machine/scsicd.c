@@ -24,6 +24,21 @@ typedef struct
 	bool is_file;
 } SCSICd;
 
+
+// scsicd_start_read
+//
+// Start decompressing a READ's sectors on the host
+// before the initiator asks for the data.
+
+static void scsicd_start_read( SCSICd *our_this )
+{
+	if ((our_this->cdrom) && (our_this->blocks))
+	{
+		cdrom_prefetch(our_this->cdrom, our_this->lba, our_this->blocks);
+		cdrom_read_async(our_this->cdrom, our_this->lba);
+	}
+}
+
 static void phys_frame_to_msf(int phys_frame, int *m, int *s, int *f)
 {
 	*m = phys_frame / (60*75);
@@ -109,6 +124,7 @@ static int scsicd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
 				cdda_stop_audio(cdda);
 			}
 
+			scsicd_start_read( our_this );
 			SCSISetPhase( scsiInstance, SCSI_PHASE_DATAIN );
 			return our_this->blocks * our_this->bytes_per_sector;
 
@@ -288,6 +304,7 @@ static int scsicd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
 				cdda_stop_audio(cdda);
 			}
 
+			scsicd_start_read( our_this );
 			SCSISetPhase( scsiInstance, SCSI_PHASE_DATAIN );
 			return our_this->blocks * our_this->bytes_per_sector;
 
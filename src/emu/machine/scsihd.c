@@ -19,6 +19,21 @@ typedef struct
 } SCSIHd;
 
 
+// scsihd_start_read
+//
+// Start decompressing a READ's blocks on the host
+// before the initiator asks for the data.
+
+static void scsihd_start_read( SCSIHd *our_this )
+{
+	if ((our_this->disk) && (our_this->blocks))
+	{
+		hard_disk_prefetch(our_this->disk, our_this->lba, our_this->blocks);
+		hard_disk_read_async(our_this->disk, our_this->lba);
+	}
+}
+
+
 // scsihd_exec_command
 
 static int scsihd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
@@ -44,6 +59,7 @@ static int scsihd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
 
 			logerror("SCSIHD: READ at LBA %x for %x blocks\n", our_this->lba, our_this->blocks);
 
+			scsihd_start_read( our_this );
 			SCSISetPhase( scsiInstance, SCSI_PHASE_DATAIN );
 			return our_this->blocks * 512;
 
@@ -79,6 +95,7 @@ static int scsihd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
 
 			logerror("SCSIHD: READ at LBA %x for %x blocks\n", our_this->lba, our_this->blocks);
 
+			scsihd_start_read( our_this );
 			SCSISetPhase( scsiInstance, SCSI_PHASE_DATAIN );
 			return our_this->blocks * 512;
 
@@ -98,6 +115,7 @@ static int scsihd_exec_command( SCSIInstance *scsiInstance, UINT8 *statusCode )
 
 			logerror("SCSIHD: READ at LBA %x for %x blocks\n", our_this->lba, our_this->blocks);
 
+			scsihd_start_read( our_this );
 			SCSISetPhase( scsiInstance, SCSI_PHASE_DATAIN );
 			return our_this->blocks * 512;
 
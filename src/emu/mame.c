@@ -107,6 +107,10 @@ static bool print_verbose = false;
 
 static running_machine *global_machine;
 
+/* startup timing for -bench_startup; zero marks a phase not reached yet */
+static osd_ticks_t startup_origin;
+static osd_ticks_t startup_ticks[STARTUP_PHASE_COUNT];
+
 /* output channels */
 static output_callback_func output_cb[OUTPUT_CHANNEL_COUNT];
 static void *output_cb_param[OUTPUT_CHANNEL_COUNT];
@@ -148,6 +152,60 @@ int mame_is_valid_machine(running_machine *machine)
 }
 
 
+/*-------------------------------------------------
+    mame_startup_mark - note that a startup phase
+    has finished
+-------------------------------------------------*/
+
+bool mame_startup_mark(int phase)
+{
+	assert(phase >= 0 && phase < STARTUP_PHASE_COUNT);
+
+	if (startup_ticks[phase] != 0)
+		return false;
+	startup_ticks[phase] = osd_ticks();
+	return true;
+}
+
+
+/*-------------------------------------------------
+    startup_report - print how long each phase of
+    the startup took
+-------------------------------------------------*/
+
+static void startup_report(const game_driver *driver)
+{
+	static const char *const phasename[STARTUP_PHASE_COUNT] =
+	{
+		"validity checks",
+		"ROM loading",
+		"machine start",
+		"first frame"
+	};
+	osd_ticks_t tps = osd_ticks_per_second();
+	osd_ticks_t last = startup_origin;
+
+	if (startup_ticks[STARTUP_PHASE_FIRST_FRAME] == 0)
+	{
+		mame_printf_info("Startup of %s did not reach the first frame\n", driver->name);
+		return;
+	}
+
+	mame_printf_info("Startup of %s: %.3f seconds to the first frame\n", driver->name, (double)(startup_ticks[STARTUP_PHASE_FIRST_FRAME] - startup_origin) / (double)tps);
+	for (int phase = 0; phase < STARTUP_PHASE_COUNT; phase++)
+	{
+		/* phases that were skipped took no time */
+		if (startup_ticks[phase] == 0)
+		{
+			mame_printf_info("  %-16s skipped\n", phasename[phase]);
+			continue;
+		}
+		mame_printf_info("  %-16s %.3f\n", phasename[phase], (double)(startup_ticks[phase] - last) / (double)tps);
+		last = startup_ticks[phase];
+	}
+}
+
+
 /*-------------------------------------------------
     mame_execute - run the core emulation
 -------------------------------------------------*/
@@ -166,6 +224,10 @@ int mame_execute(osd_interface &osd, core_options *options)
 	int error = MAMERR_NONE;
 	while (error == MAMERR_NONE && !exit_pending)
 	{
+		// restart the startup clock for each game
+		startup_origin = osd_ticks();
+		memset(startup_ticks, 0, sizeof(startup_ticks));
+
 		// convert the specified gamename to a driver
 		astring gamename;
 		core_filename_extract_base(&gamename, options_get_string(options, OPTION_GAMENAME), true);
@@ -183,6 +245,8 @@ int mame_execute(osd_interface &osd, core_options *options)
 #if !defined(KAILLERA) && !defined(MAMEUIPLUSPLUS)
 		else if (mame_validitychecks(*options, driver) != 0)
 			return MAMERR_FAILED_VALIDITY;
+		else
+			mame_startup_mark(STARTUP_PHASE_VALIDITY);
 #endif
 
 		firstgame = false;
@@ -214,6 +278,10 @@ int mame_execute(osd_interface &osd, core_options *options)
 #endif /* KAILLERA */
 		firstrun = false;
 
+		// report the startup timing if asked
+		if (options_get_bool(options, OPTION_BENCH_STARTUP))
+			startup_report(driver);
+
 		// check the state of the machine
 		if (machine->new_driver_pending())
 		{
@@ -42,6 +42,17 @@ enum
 };
 
 
+// startup phases timed by -bench_startup
+enum
+{
+	STARTUP_PHASE_VALIDITY = 0,		/* validity checks done */
+	STARTUP_PHASE_ROMS,				/* ROMs loaded */
+	STARTUP_PHASE_MACHINE,			/* machine and devices started */
+	STARTUP_PHASE_FIRST_FRAME,		/* first frame of the running game shown */
+	STARTUP_PHASE_COUNT
+};
+
+
 // MESS vs. MAME abstractions
 #ifndef MESS
 #define APPNAME					"MAME"
@@ -85,6 +96,7 @@ typedef void (*output_callback_func)(void *param, const char *format, va_list ar
 extern const char mame_disclaimer[];
 
 extern const char build_version[];
+extern const char build_stamp[];
 
 
 
@@ -101,6 +113,9 @@ int mame_execute(osd_interface &osd, core_options *options);
 /* return true if the given machine is valid */
 int mame_is_valid_machine(running_machine *machine);
 
+/* note that a startup phase has finished; returns true the first time for each game */
+bool mame_startup_mark(int phase);
+
 
 
 /* ----- output management ----- */
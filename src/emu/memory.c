@@ -709,6 +709,7 @@ public:
 			entry = m_live_lookup[level2_index(entry, byteaddress)];
 		return entry;
 	}
+	bool live_range_is(offs_t bytestart, offs_t byteend, UINT8 entry) const;
 
 	// enable watchpoints by swapping in the watchpoint table
 	void enable_watchpoints(bool enable = true) { m_live_lookup = enable ? s_watchpoint_table : m_table; }
@@ -1092,6 +1093,33 @@ public:
 		return handler.ramptr(handler.byteoffset(byteaddress));
 	}
 
+	// return a pointer to a range of bytes that are all read and written
+	// directly in the same bank, or NULL if any of them aren't
+	virtual void *get_span_ptr(offs_t bytestart, offs_t byteend)
+	{
+		// perform the lookups
+		bytestart &= m_bytemask;
+		byteend &= m_bytemask;
+		if (byteend < bytestart)
+			return NULL;
+		UINT32 entry = read_lookup(bytestart);
+		if (entry >= STATIC_RAM || write_lookup(bytestart) != entry)
+			return NULL;
+
+		// every byte must go the same way, which also rules out watchpoints
+		if (!m_read.live_range_is(bytestart, byteend, entry) || !m_write.live_range_is(bytestart, byteend, entry))
+			return NULL;
+
+		// a mirrored bank is still one entry, so the span must also be
+		// contiguous in the memory behind it, not wrap around a mirror
+		const handler_entry_read &handler = m_read.handler_read(entry);
+		const handler_entry_write &whandler = m_write.handler_write(entry);
+		if (handler.byteoffset(byteend) - handler.byteoffset(bytestart) != byteend - bytestart ||
+			whandler.byteoffset(byteend) - whandler.byteoffset(bytestart) != byteend - bytestart)
+			return NULL;
+		return handler.ramptr(handler.byteoffset(bytestart));
+	}
+
 	// native read
 	_NativeType read_native(offs_t offset, _NativeType mask)
 	{
@@ -1935,7 +1963,7 @@ inline void address_space::adjust_addresses(offs_t &start, offs_t &end, offs_t &
 
 void address_space::prepare_map()
 {
-	const memory_region *devregion = (m_spacenum == ADDRESS_SPACE_0) ? m_machine.region(m_device.tag()) : NULL;
+	const memory_region *devregion = (m_spacenum == ADDRESS_SPACE_0) ? m_machine.region_noload(m_device.tag()) : NULL;
 	UINT32 devregionsize = (devregion != NULL) ? devregion->bytes() : 0;
 
 	// allocate the address map
@@ -1978,10 +2006,14 @@ void address_space::prepare_map()
 			}
 		}
 
+		// only the device's own region may stay unloaded; anyone else could read it directly
+		const memory_region *region = NULL;
+		if (entry->m_region != NULL)
+			region = (strcmp(entry->m_region, m_device.tag()) == 0) ? m_machine.region_noload(entry->m_region) : m_machine.region(entry->m_region);
+
 		// validate adjusted addresses against implicit regions
 		if (entry->m_region != NULL && entry->m_share == NULL && entry->m_baseptr == NULL)
 		{
-			const memory_region *region = m_machine.region(entry->m_region);
 			if (region == NULL)
 				fatalerror("Error: device '%s' %s space memory map entry %X-%X references non-existant region \"%s\"", m_device.tag(), m_name, entry->m_addrstart, entry->m_addrend, entry->m_region);
 
@@ -1992,7 +2024,7 @@ void address_space::prepare_map()
 
 		// convert any region-relative entries to their memory pointers
 		if (entry->m_region != NULL)
-			entry->m_memory = m_machine.region(entry->m_region)->base() + entry->m_rgnoffs;
+			entry->m_memory = region->base() + entry->m_rgnoffs;
 	}
 
 	// now loop over all the handlers and enforce the address mask
@@ -3020,7 +3052,7 @@ bool address_space::needs_backing_store(const address_map_entry *entry)
 		return true;
 
 	// if we're reading from RAM or from ROM outside of address space 0 or its region, then yes, we do need backing
-	const memory_region *region = m_machine.region(m_device.tag());
+	const memory_region *region = m_machine.region_noload(m_device.tag());
 	if (entry->m_read.m_type == AMH_RAM ||
 		(entry->m_read.m_type == AMH_ROM && (m_spacenum != ADDRESS_SPACE_0 || region == NULL || entry->m_addrstart >= region->bytes())))
 		return true;
@@ -3454,6 +3486,42 @@ UINT8 address_table::derive_range(offs_t byteaddress, offs_t &bytestart, offs_t
 }
 
 
+//-------------------------------------------------
+//  live_range_is - return true if every byte in
+//  the given range currently looks up the given
+//  entry; with watchpoints enabled, none do
+//-------------------------------------------------
+
+bool address_table::live_range_is(offs_t bytestart, offs_t byteend, UINT8 entry) const
+{
+	offs_t l2mask = (1 << level2_bits()) - 1;
+
+	for (offs_t byteaddress = bytestart; ; byteaddress++)
+	{
+		// a whole L1 entry can be checked at once unless it has a subtable
+		offs_t chunkend = MIN(byteaddress | l2mask, byteend);
+		UINT8 l1entry = m_live_lookup[level1_index(byteaddress)];
+		if (l1entry < SUBTABLE_BASE)
+		{
+			if (l1entry != entry)
+				return false;
+			byteaddress = chunkend;
+		}
+		else
+			for ( ; ; byteaddress++)
+			{
+				if (m_live_lookup[level2_index(l1entry, byteaddress)] != entry)
+					return false;
+				if (byteaddress == chunkend)
+					break;
+			}
+
+		if (byteaddress == byteend)
+			return true;
+	}
+}
+
+
 //-------------------------------------------------
 //  mask_all_handlers - apply a mask to all
 //  address handlers
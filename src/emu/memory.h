@@ -381,6 +381,7 @@ public:
 	virtual void accessors(data_accessors &accessors) const = 0;
 	virtual void *get_read_ptr(offs_t byteaddress) = 0;
 	virtual void *get_write_ptr(offs_t byteaddress) = 0;
+	virtual void *get_span_ptr(offs_t bytestart, offs_t byteend) = 0;
 
 	// read accessors
 	virtual UINT8 read_byte(offs_t byteaddress) = 0;
@@ -0,0 +1,145 @@
+/***************************************************************************
+
+    mixutil.h
+
+    Sample buffer helpers for the sound core: gain, accumulate and final
+    clamp. Each has a portable version and an SSE2 version that produces
+    identical results.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#ifndef __MIXUTIL__
+#define __MIXUTIL__
+
+#include "osdcomm.h"
+
+/* use SSE on 64-bit implementations, where it can be assumed */
+#if (defined(__SSE2__) && defined(PTR64))
+#define MIXUTIL_SSE2	1
+#include <emmintrin.h>
+#else
+#define MIXUTIL_SSE2	0
+#endif
+
+
+
+/***************************************************************************
+    PORTABLE VERSIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    mix_scale_generic - dest = (src * gain) >> 8
+-------------------------------------------------*/
+
+INLINE void mix_scale_generic(INT32 *dest, const INT32 *src, INT32 gain, int count)
+{
+	while (count--)
+		*dest++ = (*src++ * gain) >> 8;
+}
+
+
+/*-------------------------------------------------
+    mix_add_generic - dest += src
+-------------------------------------------------*/
+
+INLINE void mix_add_generic(INT32 *dest, const INT32 *src, int count)
+{
+	while (count--)
+		*dest++ += *src++;
+}
+
+
+/*-------------------------------------------------
+    mix_clamp_interleave_generic - clamp left and
+    right to 16 bits and interleave them
+-------------------------------------------------*/
+
+INLINE void mix_clamp_interleave_generic(INT16 *dest, const INT32 *left, const INT32 *right, int count)
+{
+	while (count--)
+	{
+		INT32 samp = *left++;
+		*dest++ = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+		samp = *right++;
+		*dest++ = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+	}
+}
+
+
+
+/***************************************************************************
+    SSE2 VERSIONS
+***************************************************************************/
+
+#if MIXUTIL_SSE2
+
+/*-------------------------------------------------
+    mix_mullo_epi32 - 32x32->32 multiply of each
+    lane; SSE2 has no 32-bit low multiply, so do
+    the even and odd lanes with pmuludq (the low
+    32 bits are the same whether signed or
+    unsigned)
+-------------------------------------------------*/
+
+INLINE __m128i mix_mullo_epi32(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+}
+
+
+/*-------------------------------------------------
+    mix_scale - dest = (src * gain) >> 8
+-------------------------------------------------*/
+
+INLINE void mix_scale(INT32 *dest, const INT32 *src, INT32 gain, int count)
+{
+	__m128i vgain = _mm_set1_epi32(gain);
+	for ( ; count >= 4; count -= 4, src += 4, dest += 4)
+		_mm_storeu_si128((__m128i *)dest, _mm_srai_epi32(mix_mullo_epi32(_mm_loadu_si128((const __m128i *)src), vgain), 8));
+	mix_scale_generic(dest, src, gain, count);
+}
+
+
+/*-------------------------------------------------
+    mix_add - dest += src
+-------------------------------------------------*/
+
+INLINE void mix_add(INT32 *dest, const INT32 *src, int count)
+{
+	for ( ; count >= 4; count -= 4, src += 4, dest += 4)
+		_mm_storeu_si128((__m128i *)dest, _mm_add_epi32(_mm_loadu_si128((const __m128i *)dest), _mm_loadu_si128((const __m128i *)src)));
+	mix_add_generic(dest, src, count);
+}
+
+
+/*-------------------------------------------------
+    mix_clamp_interleave - clamp left and right to
+    16 bits and interleave them; packssdw is
+    exactly the clamp we want
+-------------------------------------------------*/
+
+INLINE void mix_clamp_interleave(INT16 *dest, const INT32 *left, const INT32 *right, int count)
+{
+	for ( ; count >= 4; count -= 4, left += 4, right += 4, dest += 8)
+	{
+		__m128i l = _mm_loadu_si128((const __m128i *)left);
+		__m128i r = _mm_loadu_si128((const __m128i *)right);
+		_mm_storeu_si128((__m128i *)dest, _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+	}
+	mix_clamp_interleave_generic(dest, left, right, count);
+}
+
+#else
+
+#define mix_scale				mix_scale_generic
+#define mix_add					mix_add_generic
+#define mix_clamp_interleave	mix_clamp_interleave_generic
+
+#endif /* MIXUTIL_SSE2 */
+
+#endif /* __MIXUTIL__ */
@@ -12,6 +12,8 @@
 #include "emu.h"
 #include "emuopts.h"
 #include "hash.h"
+#include "hashcache.h"
+#include "unzip.h"
 #include "png.h"
 #include "harddisk.h"
 #include "config.h"
@@ -31,6 +33,10 @@
 
 #define TEMPBUFFER_MAX_SIZE		(1024 * 1024 * 1024)
 
+/* how far ahead of the loader files are opened, decompressed and hashed */
+#define PRELOAD_MAX_FILES		32
+#define PRELOAD_MAX_BYTES		(64 * 1024 * 1024)
+
 
 
 /***************************************************************************
@@ -79,11 +85,34 @@ struct _romload_private
 #endif
 
 
+/* a ROM file opened ahead of the loader; a worker thread decompresses and
+   hashes it while earlier files are copied into their regions */
+struct _rom_preload
+{
+	const rom_entry *	romp;				/* ROM entry the file is for */
+	const char *		regiontag;			/* tag of the region, if loaded by name */
+	emu_file *			file;				/* opened file, or NULL if not found */
+	osd_work_item *		workitem;			/* item loading and hashing the file */
+	file_error			result;				/* result of the load */
+};
+
+
+/* a region -faststart loads on first use; its files go at the end of the
+   preload list and keep loading while the machine starts */
+struct _rom_deferred
+{
+	const rom_entry *	region;				/* region entry */
+	memory_region *		memregion;			/* the region, allocated up front */
+};
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
 static void rom_exit(running_machine &machine);
+static void preload_free(rom_load_data *romdata);
 
 /***************************************************************************
     HELPERS (also used by devimage.c)
@@ -107,9 +136,9 @@ file_error common_process_file(core_options &options, const char *location, cons
 	return filerr;
 }
 
-file_error common_process_file(core_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file)
+file_error common_process_file(core_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file, UINT32 openflags)
 {
-	*image_file = global_alloc(emu_file(options, SEARCHPATH_IMAGE, OPEN_FLAG_READ));
+	*image_file = global_alloc(emu_file(options, SEARCHPATH_IMAGE, openflags));
 	file_error filerr;
 
 	if (has_crc)
@@ -532,6 +561,10 @@ static void display_loading_rom_message(rom_load_data *romdata, const char *name
 {
 	char buffer[200];
 
+	/* deferred regions can finish loading while the game runs; stay quiet then */
+	if (romdata->machine->phase() > MACHINE_PHASE_INIT)
+		return;
+
 	// 2010-04, FP - FIXME: in MESS, load_software_part_region sometimes calls this with romstotalsize = 0!
 	// as a temp workaround, I added a check for romstotalsize !=0.
 	if (name != NULL && romdata->romstotalsize)
@@ -577,12 +610,12 @@ static void display_rom_load_results(rom_load_data *romdata)
 
 static void region_post_process(rom_load_data *romdata, const char *rgntag)
 {
-	const memory_region *region = romdata->machine->region(rgntag);
+	const memory_region *region = romdata->machine->region_noload(rgntag);
 	UINT8 *base;
 	int i, j;
 
-	// do nothing if no region
-	if (region == NULL)
+	// do nothing if no region, or if it hasn't been loaded yet
+	if (region == NULL || region->deferred())
 		return;
 
 	LOG(("+ datawidth=%d little=%d\n", region->width(), region->endianness() == ENDIANNESS_LITTLE));
@@ -612,42 +645,29 @@ static void region_post_process(rom_load_data *romdata, const char *rgntag)
 
 
 /*-------------------------------------------------
-    open_rom_file - open a ROM file, searching
-    up the parent and loading by checksum
+    find_rom_file - find and open a ROM file,
+    searching up the parent and loading by
+    checksum
 -------------------------------------------------*/
 
-static int open_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp)
+static file_error find_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp, emu_file **file, UINT32 openflags)
 {
 	file_error filerr = FILERR_NOT_FOUND;
-	UINT32 romsize = rom_file_size(romp);
 	const game_driver *drv;
 
-	/* update status display */
-	display_loading_rom_message(romdata, ROM_GETNAME(romp));
-
 	/* extract CRC to use for searching */
 	UINT32 crc = 0;
 	bool has_crc = hash_collection(ROM_GETHASHDATA(romp)).crc(crc);
 
 	/* attempt reading up the chain through the parents. It automatically also
      attempts any kind of load by checksum supported by the archives. */
-	romdata->file = NULL;
-	for (drv = romdata->machine->gamedrv; romdata->file == NULL && drv != NULL; drv = driver_get_clone(drv))
+	*file = NULL;
+	for (drv = romdata->machine->gamedrv; *file == NULL && drv != NULL; drv = driver_get_clone(drv))
 		if (drv->name != NULL && *drv->name != 0)
-#ifdef USE_IPS
-			{
-#endif /* USE_IPS */
-			filerr = common_process_file(romdata->machine->options(), drv->name, has_crc, crc, romp, &romdata->file);
-
-#ifdef USE_IPS
-			romdata->patch = assign_ips_patch(romp);
-			if (romdata->patch)
-				LOG(("ROM %s: has ips\n", ROM_GETNAME(romp)));
-			}
-#endif /* USE_IPS */
+			filerr = common_process_file(romdata->machine->options(), drv->name, has_crc, crc, romp, file, openflags);
 
 	/* if the region is load by name, load the ROM from there */
-	if (romdata->file == NULL && regiontag != NULL)
+	if (*file == NULL && regiontag != NULL)
 	{
 		// check if we are dealing with softwarelists. if so, locationtag
 		// is actually a concatenation of: listname + setname + parentname
@@ -694,23 +714,273 @@ static int open_rom_file(rom_load_data *romdata, const char *regiontag, const ro
 		// - if we are not using lists, we have regiontag only;
 		// - if we are using lists, we have: list/clonename, list/parentname, clonename, parentname
 		if (!is_list)
-			filerr = common_process_file(romdata->machine->options(), tag1.cstr(), has_crc, crc, romp, &romdata->file);
+			filerr = common_process_file(romdata->machine->options(), tag1.cstr(), has_crc, crc, romp, file, openflags);
 		else
 		{
 			// try to load from list/setname
-			if ((romdata->file == NULL) && (tag2.cstr() != NULL))
-				filerr = common_process_file(romdata->machine->options(), tag2.cstr(), has_crc, crc, romp, &romdata->file);
+			if ((*file == NULL) && (tag2.cstr() != NULL))
+				filerr = common_process_file(romdata->machine->options(), tag2.cstr(), has_crc, crc, romp, file, openflags);
 			// try to load from list/parentname
-			if ((romdata->file == NULL) && has_parent && (tag3.cstr() != NULL))
-				filerr = common_process_file(romdata->machine->options(), tag3.cstr(), has_crc, crc, romp, &romdata->file);
+			if ((*file == NULL) && has_parent && (tag3.cstr() != NULL))
+				filerr = common_process_file(romdata->machine->options(), tag3.cstr(), has_crc, crc, romp, file, openflags);
 			// try to load from setname
-			if ((romdata->file == NULL) && (tag4.cstr() != NULL))
-				filerr = common_process_file(romdata->machine->options(), tag4.cstr(), has_crc, crc, romp, &romdata->file);
+			if ((*file == NULL) && (tag4.cstr() != NULL))
+				filerr = common_process_file(romdata->machine->options(), tag4.cstr(), has_crc, crc, romp, file, openflags);
 			// try to load from parentname
-			if ((romdata->file == NULL) && has_parent && (tag5.cstr() != NULL))
-				filerr = common_process_file(romdata->machine->options(), tag5.cstr(), has_crc, crc, romp, &romdata->file);
+			if ((*file == NULL) && has_parent && (tag5.cstr() != NULL))
+				filerr = common_process_file(romdata->machine->options(), tag5.cstr(), has_crc, crc, romp, file, openflags);
+		}
+	}
+
+	return filerr;
+}
+
+
+/*-------------------------------------------------
+    region_deferrable - return TRUE if a region
+    can be loaded on first use: it must belong to
+    a sound device that only reads it to generate
+    sound, and nothing may copy from it
+-------------------------------------------------*/
+
+static int region_deferrable(rom_load_data *romdata, const char *regiontag, const rom_entry *region)
+{
+	const device_config_sound_interface *sound;
+	device_t *device = romdata->machine->device(regiontag);
+
+	if (!ROMREGION_ISROMDATA(region) || device == NULL || !device->baseconfig().interface(sound) || !sound->rom_on_demand())
+		return FALSE;
+
+	for (const rom_source *source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
+		for (const rom_entry *scan = rom_first_region(*source); scan != NULL; scan = rom_next_region(scan))
+			for (const rom_entry *romp = scan + 1; !ROMENTRY_ISREGIONEND(romp); romp++)
+				if (ROMENTRY_ISCOPY(romp) && strcmp(ROM_GETNAME(romp), regiontag) == 0)
+					return FALSE;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    defer_alloc - with -faststart, list the
+    regions to be loaded on first use
+-------------------------------------------------*/
+
+static void defer_alloc(rom_load_data *romdata)
+{
+	const rom_source *source;
+	const rom_entry *region;
+	astring regiontag;
+	int count = 0;
+
+	if (!options_get_bool(&romdata->machine->options(), OPTION_FASTSTART))
+		return;
+
+	for (source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
+		for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
+			count++;
+	romdata->deferred = auto_alloc_array_clear(romdata->machine, rom_deferred, MAX(count, 1));
+
+	for (source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
+		for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
+			if (region_deferrable(romdata, rom_region_name(regiontag, romdata->machine->gamedrv, source, region), region))
+				romdata->deferred[romdata->deferredcount++].region = region;
+}
+
+
+/*-------------------------------------------------
+    region_is_deferred - return TRUE if a region
+    is to be loaded on first use
+-------------------------------------------------*/
+
+static int region_is_deferred(rom_load_data *romdata, const rom_entry *region)
+{
+	for (int entry = 0; entry < romdata->deferredcount; entry++)
+		if (romdata->deferred[entry].region == region)
+			return TRUE;
+	return FALSE;
+}
+
+
+/*-------------------------------------------------
+    preload_callback - load and hash a file on a
+    worker thread
+-------------------------------------------------*/
+
+static void *preload_callback(void *param, int threadid)
+{
+	rom_preload *preload = (rom_preload *)param;
+	astring tempstr;
+
+	preload->result = preload->file->preload(hash_collection(ROM_GETHASHDATA(preload->romp)).hash_types(tempstr));
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    preload_alloc - list the files of all ROM
+    regions so they can be loaded ahead of time
+-------------------------------------------------*/
+
+static void preload_alloc(rom_load_data *romdata)
+{
+	const rom_source *source;
+	const rom_entry *region, *rom;
+	int count = 0;
+
+	/* without worker threads, everything is loaded in line */
+	romdata->preloadqueue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	if (romdata->preloadqueue == NULL)
+		return;
+
+	/* count and then list the files the loader will open, in its order; deferred regions come last */
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+			romdata->preload = auto_alloc_array_clear(romdata->machine, rom_preload, MAX(count, 1));
+		count = 0;
+		for (int deferred = FALSE; deferred <= TRUE; deferred++)
+			for (source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
+				for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
+					if (ROMREGION_ISROMDATA(region) && region_is_deferred(romdata, region) == deferred)
+						for (rom = rom_first_file(region); rom != NULL; rom = rom_next_file(rom))
+							if (ROM_GETBIOSFLAGS(rom) == 0 || ROM_GETBIOSFLAGS(rom) == romdata->system_bios)
+							{
+								if (pass == 1)
+								{
+									romdata->preload[count].romp = rom;
+									romdata->preload[count].regiontag = ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL;
+								}
+								count++;
+							}
+	}
+	romdata->preloadtotal = count;
+}
+
+
+/*-------------------------------------------------
+    preload_open - open a file from the preload
+    list and queue it for loading and hashing
+-------------------------------------------------*/
+
+static void preload_open(rom_load_data *romdata, rom_preload *preload)
+{
+	/* opening walks the search paths and the shared ZIP cache, so stays on this thread */
+	find_rom_file(romdata, preload->regiontag, preload->romp, &preload->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
+	if (preload->file == NULL)
+		return;
+	romdata->preloadbytes += rom_file_size(preload->romp);
+	preload->workitem = osd_work_item_queue(romdata->preloadqueue, preload_callback, preload, 0);
+}
+
+
+/*-------------------------------------------------
+    preload_fill - open files ahead of the loader
+    and queue them for loading and hashing, up to
+    the file and memory limits
+-------------------------------------------------*/
+
+static void preload_fill(rom_load_data *romdata)
+{
+	while (romdata->preloadopened < romdata->preloadtotal &&
+			romdata->preloadopened - romdata->preloadtaken < PRELOAD_MAX_FILES &&
+			(romdata->preloadopened == romdata->preloadtaken || romdata->preloadbytes < PRELOAD_MAX_BYTES))
+		preload_open(romdata, &romdata->preload[romdata->preloadopened++]);
+}
+
+
+/*-------------------------------------------------
+    preload_take - hand the next preloaded file to
+    the loader
+-------------------------------------------------*/
+
+static file_error preload_take(rom_load_data *romdata, const char *regiontag, const rom_entry *romp, emu_file **file)
+{
+	rom_preload *preload = &romdata->preload[romdata->preloadtaken++];
+
+	/* wait for the load to finish */
+	if (preload->workitem != NULL)
+	{
+		while (!osd_work_item_wait(preload->workitem, 10 * osd_ticks_per_second())) ;
+		osd_work_item_release(preload->workitem);
+		preload->workitem = NULL;
+	}
+	if (preload->file != NULL)
+		romdata->preloadbytes -= rom_file_size(preload->romp);
+
+	/* keep the pipeline full */
+	preload_fill(romdata);
+
+	/* hand over the file, if there was one */
+	*file = preload->file;
+	preload->file = NULL;
+	if (*file == NULL)
+		return FILERR_NOT_FOUND;
+
+	/* if it could not be read, search again the normal way so other paths get their chance */
+	if (preload->result != FILERR_NONE)
+	{
+		global_free(*file);
+		return find_rom_file(romdata, regiontag, romp, file, OPEN_FLAG_READ);
+	}
+	return FILERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    preload_free - release any files still loaded
+    ahead of time
+-------------------------------------------------*/
+
+static void preload_free(rom_load_data *romdata)
+{
+	/* wait for outstanding work and close whatever was not taken */
+	for (int entry = romdata->preloadtaken; entry < romdata->preloadopened; entry++)
+	{
+		rom_preload *preload = &romdata->preload[entry];
+		if (preload->workitem != NULL)
+		{
+			while (!osd_work_item_wait(preload->workitem, 10 * osd_ticks_per_second())) ;
+			osd_work_item_release(preload->workitem);
 		}
+		if (preload->file != NULL)
+			global_free(preload->file);
 	}
+	if (romdata->preload != NULL)
+		auto_free(romdata->machine, romdata->preload);
+	if (romdata->preloadqueue != NULL)
+		osd_work_queue_free(romdata->preloadqueue);
+
+	romdata->preload = NULL;
+	romdata->preloadqueue = NULL;
+	romdata->preloadtotal = romdata->preloadopened = romdata->preloadtaken = 0;
+	romdata->preloadbytes = 0;
+}
+
+
+/*-------------------------------------------------
+    open_rom_file - open a ROM file, taking it
+    from the preload list when it is there
+-------------------------------------------------*/
+
+static int open_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp, UINT32 openflags)
+{
+	UINT32 romsize = rom_file_size(romp);
+	file_error filerr;
+
+	/* update status display */
+	display_loading_rom_message(romdata, ROM_GETNAME(romp));
+
+	/* the preload list follows the loader's order; anything else is opened here */
+	if (romdata->preloadtaken < romdata->preloadtotal && romdata->preload[romdata->preloadtaken].romp == romp)
+		filerr = preload_take(romdata, regiontag, romp, &romdata->file);
+	else
+		filerr = find_rom_file(romdata, regiontag, romp, &romdata->file, openflags);
+
+#ifdef USE_IPS
+	romdata->patch = assign_ips_patch(romp);
+	if (romdata->patch)
+		LOG(("ROM %s: has ips\n", ROM_GETNAME(romp)));
+#endif /* USE_IPS */
 
 	/* update counters */
 	romdata->romsloaded++;
@@ -964,7 +1234,7 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 
 			/* open the file if it is a non-BIOS or matches the current BIOS */
 			LOG(("Opening ROM file: %s\n", ROM_GETNAME(romp)));
-			if (!irrelevantbios && !open_rom_file(romdata, regiontag, romp))
+			if (!irrelevantbios && !open_rom_file(romdata, regiontag, romp, OPEN_FLAG_READ))
 				handle_missing_file(romdata, romp);
 
 			/* loop until we run out of reloads */
@@ -1466,6 +1736,159 @@ void load_software_part_region(device_t *device, char *swlist, char *swname, rom
 }
 
 
+/*-------------------------------------------------
+    alloc_rom_region - allocate a ROM region and
+    clear it as requested
+-------------------------------------------------*/
+
+static void alloc_rom_region(rom_load_data *romdata, const char *regiontag, const rom_entry *region, UINT32 regionflags)
+{
+	/* remember the base and length */
+	romdata->region = romdata->machine->region_alloc(regiontag, ROMREGION_GETLENGTH(region), regionflags);
+	LOG(("Allocated %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
+
+	/* clear the region if it's requested */
+	if (ROMREGION_ISERASE(region))
+		memset(romdata->region->base(), ROMREGION_GETERASEVAL(region), romdata->region->bytes());
+
+	/* or if it's sufficiently small (<= 4MB) */
+	else if (romdata->region->bytes() <= 0x400000)
+		memset(romdata->region->base(), 0, romdata->region->bytes());
+
+#ifdef MAME_DEBUG
+	/* if we're debugging, fill region with random data to catch errors */
+	else
+		fill_random(romdata->machine, romdata->region->base(), romdata->region->bytes());
+#endif
+}
+
+
+/*-------------------------------------------------
+    mappable_rom - return the ROM if a region
+    holds nothing else, the ROM fills it, and
+    neither needs any rearranging; such a region
+    can use the file's pages directly
+-------------------------------------------------*/
+
+static const rom_entry *mappable_rom(rom_load_data *romdata, const rom_entry *region, UINT32 regionflags)
+{
+	const rom_entry *romp = region + 1;
+
+	/* inverted and byte-swapped regions get rewritten after loading */
+	if (regionflags & ROMREGION_INVERTMASK)
+		return NULL;
+	if ((regionflags & ROMREGION_WIDTHMASK) != ROMREGION_8BIT &&
+			((regionflags & ROMREGION_ENDIANMASK) == ROMREGION_LE) != (ENDIANNESS_NATIVE == ENDIANNESS_LITTLE))
+		return NULL;
+
+	/* exactly one file, which must be relevant to the current BIOS */
+	if (!ROMENTRY_ISFILE(romp) || !ROMENTRY_ISREGIONEND(romp + 1))
+		return NULL;
+	if (ROM_GETBIOSFLAGS(romp) != 0 && ROM_GETBIOSFLAGS(romp) != romdata->system_bios)
+		return NULL;
+
+	/* loaded whole, in order, over the full region */
+	if (ROM_GETOFFSET(romp) != 0 || ROM_GETLENGTH(romp) != ROMREGION_GETLENGTH(region))
+		return NULL;
+	if (ROM_INHERITSFLAGS(romp) || ROM_GETBITWIDTH(romp) != 8 || ROM_GETSKIPCOUNT(romp) != 0 || (ROM_GETGROUPSIZE(romp) != 1 && ROM_ISREVERSED(romp)))
+		return NULL;
+	return romp;
+}
+
+
+/*-------------------------------------------------
+    process_mapped_region - load a region holding
+    a single plain ROM by mapping its file, so
+    unmodified pages are shared with every other
+    instance using the same file; falls back to
+    reading it in when the file can't be mapped
+-------------------------------------------------*/
+
+static void process_mapped_region(rom_load_data *romdata, const char *regiontag, const rom_entry *region, UINT32 regionflags, const rom_entry *romp)
+{
+	UINT32 length = ROM_GETLENGTH(romp);
+	osd_file_mapping *mapping = NULL;
+	void *base = NULL;
+
+	/* leave ZIPs unloaded so stored members can be mapped */
+	LOG(("Opening ROM file: %s\n", ROM_GETNAME(romp)));
+	if (!open_rom_file(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, romp, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD))
+		handle_missing_file(romdata, romp);
+	else if (romdata->file->size() == length && romdata->file->map() == FILERR_NONE)
+		mapping = romdata->file->detach_mapping(base);
+
+	/* verify now, while the file still reads the same pages unmodified */
+	verify_length_and_hash(romdata, ROM_GETNAME(romp), length, hash_collection(ROM_GETHASHDATA(romp)));
+
+	/* allocated regions are aligned for any access width, and drivers rely on that
+	   even for 8-bit regions; a ZIP member stored at an odd offset isn't, so it is
+	   read into a normal region instead (the file reads the mapping until then) */
+	if (mapping != NULL && ((FPTR)base & (sizeof(UINT64) - 1)) != 0)
+	{
+		LOG(("Mapping at %p is misaligned, reading instead\n", base));
+		alloc_rom_region(romdata, regiontag, region, regionflags);
+		read_rom_data(romdata, romp);
+		osd_unmap(mapping);
+	}
+
+	/* the region takes over the mapping; writes to it are private copies */
+	else if (mapping != NULL)
+	{
+		romdata->region = romdata->machine->region_alloc(regiontag, length, regionflags, mapping, base);
+		LOG(("Mapped %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
+#ifdef USE_IPS
+		if (romdata->patch)
+			apply_ips_patch(romdata->patch, romdata->region->base(), length);
+#endif /* USE_IPS */
+	}
+
+	/* otherwise read it in the usual way */
+	else
+	{
+		alloc_rom_region(romdata, regiontag, region, regionflags);
+		read_rom_data(romdata, romp);
+	}
+
+	/* close the file */
+	if (romdata->file != NULL)
+	{
+		LOG(("Closing ROM file\n"));
+		global_free(romdata->file);
+		romdata->file = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+    load_deferred_regions - load the regions held
+    back for first use, taking their files from
+    the end of the preload list
+-------------------------------------------------*/
+
+static void load_deferred_regions(rom_load_data *romdata)
+{
+	/* clear the marks first, as the regions are looked up while loading */
+	int count = romdata->deferredcount;
+	romdata->deferredcount = 0;
+	for (int entry = 0; entry < count; entry++)
+		romdata->deferred[entry].memregion->set_deferred(false);
+
+	/* load them in the order they were listed for preloading */
+	for (int entry = 0; entry < count; entry++)
+	{
+		const rom_entry *region = romdata->deferred[entry].region;
+
+		LOG(("Loading deferred region \"%s\"\n", romdata->deferred[entry].memregion->name()));
+		romdata->region = romdata->deferred[entry].memregion;
+		process_rom_entries(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, region + 1);
+	}
+	preload_free(romdata);
+
+	for (int entry = 0; entry < count; entry++)
+		region_post_process(romdata, ROMREGION_GETTAG(romdata->deferred[entry].region));
+}
+
+
 /*-------------------------------------------------
     process_region_list - process a region list
 -------------------------------------------------*/
@@ -1476,6 +1899,14 @@ static void process_region_list(rom_load_data *romdata)
 	const rom_source *source;
 	const rom_entry *region;
 
+	/* start opening, decompressing and hashing files ahead of the loader; without
+	   worker threads to load them meanwhile, deferring regions gains nothing */
+	defer_alloc(romdata);
+	preload_alloc(romdata);
+	if (romdata->preloadqueue == NULL)
+		romdata->deferredcount = 0;
+	preload_fill(romdata);
+
 	/* loop until we hit the end */
 	for (source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
 		for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
@@ -1495,35 +1926,54 @@ static void process_region_list(rom_load_data *romdata)
 				if (romdata->machine->device(regiontag) != NULL)
 					regionflags = normalize_flags_for_device(romdata->machine, regionflags, regiontag);
 
-				/* remember the base and length */
-				romdata->region = romdata->machine->region_alloc(regiontag, regionlength, regionflags);
-				LOG(("Allocated %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
-
-				/* clear the region if it's requested */
-				if (ROMREGION_ISERASE(region))
-					memset(romdata->region->base(), ROMREGION_GETERASEVAL(region), romdata->region->bytes());
+				/* a region loaded on first use is only allocated for now, so its device can hold on to it */
+				const rom_entry *romp = mappable_rom(romdata, region, regionflags);
+				if (region_is_deferred(romdata, region))
+				{
+					alloc_rom_region(romdata, regiontag, region, regionflags);
+					romdata->region->set_deferred(true);
+					for (int entry = 0; entry < romdata->deferredcount; entry++)
+						if (romdata->deferred[entry].region == region)
+							romdata->deferred[entry].memregion = romdata->region;
+				}
 
-				/* or if it's sufficiently small (<= 4MB) */
-				else if (romdata->region->bytes() <= 0x400000)
-					memset(romdata->region->base(), 0, romdata->region->bytes());
+				/* a region holding just one plain ROM can use the file's pages directly */
+				else if (romp != NULL)
+					process_mapped_region(romdata, regiontag, region, regionflags, romp);
 
-#ifdef MAME_DEBUG
-				/* if we're debugging, fill region with random data to catch errors */
+				/* otherwise allocate it and process the entries */
 				else
-					fill_random(romdata->machine, romdata->region->base(), romdata->region->bytes());
-#endif
-
-				/* now process the entries in the region */
-				process_rom_entries(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, region + 1);
+				{
+					alloc_rom_region(romdata, regiontag, region, regionflags);
+					process_rom_entries(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, region + 1);
+				}
 			}
 			else if (ROMREGION_ISDISKDATA(region))
 				process_disk_entries(romdata, ROMREGION_GETTAG(region), region + 1, NULL);
 		}
 
-	/* now go back and post-process all the regions */
+	if (romdata->deferredcount == 0)
+		preload_free(romdata);
+
+	/* now go back and post-process all the regions loaded so far */
 	for (source = rom_first_source(*romdata->machine->config); source != NULL; source = rom_next_source(*source))
 		for (region = rom_first_region(*source); region != NULL; region = rom_next_region(region))
 			region_post_process(romdata, ROMREGION_GETTAG(region));
+
+	/* open the deferred regions' files now so they load while the machine starts;
+	   if any are missing, load them right away so that gets reported */
+	if (romdata->deferredcount != 0)
+	{
+		int missing = FALSE;
+
+		while (romdata->preloadopened < romdata->preloadtotal)
+			preload_open(romdata, &romdata->preload[romdata->preloadopened++]);
+		for (int entry = romdata->preloadtaken; entry < romdata->preloadtotal; entry++)
+			if (romdata->preload[entry].file == NULL)
+				missing = TRUE;
+		if (missing)
+			load_deferred_regions(romdata);
+	}
 }
 
 
@@ -1548,6 +1998,12 @@ void rom_init(running_machine *machine)
 	/* reset the romdata struct */
 	romdata->machine = machine;
 
+	/* files whose hashes were verified before needn't be hashed again */
+	hashcache_init(machine->options());
+
+	/* keep the archives shared by parents, clones and BIOSes open between lookups */
+	zip_file_cache_set_limits(options_get_int(&machine->options(), OPTION_ZIPCACHE), MAX(MIN(options_get_int(&machine->options(), OPTION_ZIPCACHESIZE), 4095), 0) << 20);
+
 	/* figure out which BIOS we are using */
 	determine_bios_rom(romdata);
 
@@ -1569,8 +2025,9 @@ void rom_init(running_machine *machine)
 	}
 #endif /* USE_IPS */
 
-	/* process the ROM entries we were passed */
+	/* process the ROM entries we were passed, then keep whatever was hashed */
 	process_region_list(romdata);
+	hashcache_save();
 
 #ifdef USE_IPS
 	if (patchname && *patchname)
@@ -1585,6 +2042,31 @@ void rom_init(running_machine *machine)
 
 	/* display the results and exit */
 	display_rom_load_results(romdata);
+	mame_startup_mark(STARTUP_PHASE_ROMS);
+}
+
+
+/*-------------------------------------------------
+    rom_load_deferred - finish loading the regions
+    -faststart held back; called on their first
+    use
+-------------------------------------------------*/
+
+void rom_load_deferred(running_machine *machine)
+{
+	rom_load_data *romdata = machine->romload_data;
+
+	if (romdata == NULL || romdata->deferredcount == 0)
+		return;
+
+	/* report any trouble the way the initial load does */
+	int warnings = romdata->warnings;
+	int knownbad = romdata->knownbad;
+	romdata->errorstring.reset();
+	load_deferred_regions(romdata);
+	hashcache_save();
+	if (romdata->errors != 0 || romdata->warnings != warnings || romdata->knownbad != knownbad)
+		display_rom_load_results(romdata);
 }
 
 
@@ -1596,6 +2078,9 @@ static void rom_exit(running_machine &machine)
 {
 	open_chd *curchd;
 
+	/* release anything left behind by a failed load */
+	preload_free(machine.romload_data);
+
 	/* close all hard drives */
 	for (curchd = machine.romload_data->chd_list; curchd != NULL; curchd = curchd->next)
 	{
@@ -153,6 +153,9 @@ struct _open_chd
 };
 
 
+typedef struct _rom_preload rom_preload;
+typedef struct _rom_deferred rom_deferred;
+
 typedef struct _romload_private rom_load_data;
 struct _romload_private
 {
@@ -177,6 +180,16 @@ struct _romload_private
 
 	memory_region *	region;				/* info about current region */
 
+	rom_preload *	preload;			/* list of files loaded ahead of time */
+	int				preloadtotal;		/* number of entries in the list */
+	int				preloadopened;		/* entries opened and queued so far */
+	int				preloadtaken;		/* entries handed to the loader so far */
+	UINT32			preloadbytes;		/* bytes opened but not yet taken */
+	osd_work_queue *preloadqueue;		/* queue that loads and hashes the files */
+
+	rom_deferred *	deferred;			/* regions loaded on first use */
+	int				deferredcount;		/* number of them still to load */
+
 	astring			errorstring;		/* error string */
 };
 
@@ -310,6 +323,9 @@ struct _romload_private
 /* load the ROMs and open the disk images associated with the given machine */
 void rom_init(running_machine *machine);
 
+/* finish loading any regions held back by -faststart */
+void rom_load_deferred(running_machine *machine);
+
 /* return the number of warnings we generated */
 int rom_load_warnings(running_machine *machine);
 
@@ -320,7 +336,7 @@ int rom_load_knownbad(running_machine *machine);
 /* ----- Helpers ----- */
 
 file_error common_process_file(core_options &options, const char *location, const char *ext, const rom_entry *romp, emu_file **image_file);
-file_error common_process_file(core_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file);
+file_error common_process_file(core_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file, UINT32 openflags = OPEN_FLAG_READ);
 
 
 /* ----- ROM iteration ----- */
@@ -42,7 +42,9 @@
 #include "osdepend.h"
 #include "config.h"
 #include "profiler.h"
+#include "mixutil.h"
 #include "sound/wavwrite.h"
+#include "sound/soundlog.h"
 
 #ifdef MAME_AVI
 #include "Wav.h"
@@ -104,6 +106,8 @@ void AVI_AudioStream_WriteWaveData(char* lpwav, int len);	// Implemented in avi.
 
 const attotime sound_manager::STREAMS_UPDATE_ATTOTIME = attotime::from_hz(STREAMS_UPDATE_FREQUENCY);
 
+INT32 sound_stream::s_polyphase[1 << POLYPHASE_PHASE_BITS][POLYPHASE_TAPS];
+
 
 
 //**************************************************************************
@@ -133,7 +137,18 @@ sound_stream::sound_stream(device_t &device, int inputs, int outputs, int sample
 	  m_output_update_sampindex(0),
 	  m_output_base_sampindex(0),
 	  m_callback(callback),
-	  m_param(param)
+	  m_param(param),
+	  m_graph_level(0),
+	  m_profile_ticks(0),
+	  m_profile_samples(0),
+	  m_profile_calls(0),
+	  m_write_handler(NULL),
+	  m_render_queue(NULL),
+	  m_write_lock(NULL),
+	  m_write_log(NULL),
+	  m_write_first(0),
+	  m_write_count(0),
+	  m_render_pending(false)
 {
 	// get the device's sound interface
 	device_sound_interface *sound;
@@ -290,6 +305,9 @@ void sound_stream::set_input(int index, sound_stream *input_stream, int output_i
 
 	// update sample rates now that we know the input
 	recompute_sample_rate_data();
+
+	// the graph changed, so the parallel schedule must be rebuilt
+	m_device.machine->sound().m_schedule_dirty = true;
 #ifdef MAME_AVI
 	mame_mixer_wave_loging = 0;
 #endif /* MAME_AVI */
@@ -303,37 +321,150 @@ void sound_stream::set_input(int index, sound_stream *input_stream, int output_i
 
 void sound_stream::update()
 {
-	// determine the number of samples since the start of this second
-	attotime time = m_device.machine->time();
-	INT32 update_sampindex = INT32(time.attoseconds / m_attoseconds_per_sample);
+	g_profiler.start(PROFILER_SOUND);
+	update_to_current_time();
+	g_profiler.stop();
+}
 
-	// if we're ahead of the last update, then adjust upwards
-	attotime last_update = m_device.machine->sound().last_update();
-	if (time.seconds > last_update.seconds)
-	{
-		assert(time.seconds == last_update.seconds + 1);
-		update_sampindex += m_sample_rate;
-	}
 
-	// if we're behind the last update, then adjust downwards
-	if (time.seconds < last_update.seconds)
-	{
-		assert(time.seconds == last_update.seconds - 1);
-		update_sampindex -= m_sample_rate;
-	}
+//-------------------------------------------------
+//  update_to_current_time - generate samples up
+//  to the current emulated time; this does not
+//  touch the profiler so it is safe to call from
+//  the parallel stream scheduler
+//-------------------------------------------------
+
+void sound_stream::update_to_current_time()
+{
+	// a device whose ROM -faststart held back needs it from here on
+	if (m_device.region() != NULL && m_device.region()->deferred())
+		rom_load_deferred(m_device.machine);
+
+	// let the render thread catch up on any logged writes first
+	if (m_render_queue != NULL)
+		sync_write_log();
 
 	// generate samples to get us up to the appropriate time
-	g_profiler.start(PROFILER_SOUND);
+	INT32 update_sampindex = current_sampindex();
 	assert(m_output_sampindex - m_output_base_sampindex >= 0);
 	assert(update_sampindex - m_output_base_sampindex <= m_output_bufalloc);
 	generate_samples(update_sampindex - m_output_sampindex);
-	g_profiler.stop();
 
 	// remember this info for next time
 	m_output_sampindex = update_sampindex;
 }
 
 
+//-------------------------------------------------
+//  set_write_handler - route register writes
+//  through a log so that a render thread can
+//  synthesize the stream while emulation
+//  continues; only streams without inputs whose
+//  output depends solely on the written state
+//  can do this
+//-------------------------------------------------
+
+void sound_stream::set_write_handler(stream_write_func handler)
+{
+	m_write_handler = handler;
+
+	// without a render thread, or with inputs to pull from other streams, writes are applied inline
+	if (!m_device.machine->sound().m_render_thread || m_inputs != 0 || m_render_queue != NULL)
+		return;
+
+	m_render_queue = osd_work_queue_alloc(0);
+	if (m_render_queue == NULL)
+		return;
+	m_write_lock = osd_lock_alloc();
+	m_write_log = auto_alloc_array(m_device.machine, logged_write, WRITE_LOG_SIZE);
+}
+
+
+//-------------------------------------------------
+//  write - apply a register write at the current
+//  emulated time; with a render thread it is
+//  logged and the thread brings the stream up to
+//  that time before applying it
+//-------------------------------------------------
+
+void sound_stream::write(offs_t offset, UINT32 data)
+{
+	assert(m_write_handler != NULL);
+
+	// no render thread: bring the stream up to date and apply it now
+	if (m_render_queue == NULL)
+	{
+		update();
+		(*m_write_handler)(&m_device, this, m_param, offset, data);
+		return;
+	}
+
+	// if the log is full, wait for the render thread to drain it
+	osd_lock_acquire(m_write_lock);
+	bool full = (m_write_count == WRITE_LOG_SIZE);
+	osd_lock_release(m_write_lock);
+	if (full)
+		sync_write_log();
+
+	// append the write, stamped with the sample it takes effect at
+	osd_lock_acquire(m_write_lock);
+	logged_write &entry = m_write_log[(m_write_first + m_write_count) % WRITE_LOG_SIZE];
+	entry.m_sampindex = current_sampindex();
+	entry.m_offset = offset;
+	entry.m_data = data;
+	m_write_count++;
+	bool kick = !m_render_pending;
+	m_render_pending = true;
+	osd_lock_release(m_write_lock);
+
+	// wake the render thread if it went idle
+	if (kick)
+		osd_work_item_queue(m_render_queue, render_callback, this, WORK_ITEM_FLAG_AUTO_RELEASE);
+}
+
+
+//-------------------------------------------------
+//  sync_write_log - wait until the render thread
+//  has applied every logged write; afterwards the
+//  emulation thread owns the chip state again
+//  until the next write
+//-------------------------------------------------
+
+void sound_stream::sync_write_log()
+{
+	if (m_render_queue == NULL)
+		return;
+
+	// the render thread may still be inside the chip; keep waiting however
+	// long it takes rather than touch the chip state alongside it
+	while (!osd_work_queue_wait(m_render_queue, osd_ticks_per_second() * 10))
+		;
+
+	// the queue is idle now, so anything left (a kick that failed to
+	// queue) can be applied here without racing the render thread
+	render_write_log();
+}
+
+
+//-------------------------------------------------
+//  stop_render_thread - drain the log and release
+//  the render thread; writes are applied inline
+//  from now on
+//-------------------------------------------------
+
+void sound_stream::stop_render_thread()
+{
+	if (m_render_queue == NULL)
+		return;
+
+	sync_write_log();
+	osd_work_queue_free(m_render_queue);
+	osd_lock_free(m_write_lock);
+	m_render_queue = NULL;
+	m_write_lock = NULL;
+}
+
+
 //-------------------------------------------------
 //  output_since_last_update - return a pointer to
 //  the output buffer and the number of samples
@@ -484,8 +615,10 @@ STREAM_UPDATE( sound_stream::device_stream_update_stub )
 
 void sound_stream::recompute_sample_rate_data()
 {
-	// recompute the timing parameters
-	attoseconds_t update_attoseconds = m_device.machine->sound().update_attoseconds();
+	// recompute the timing parameters; buffers are always sized for the default
+	// update rate, so that the history kept between updates still covers the
+	// input latency when updates are more frequent
+	attoseconds_t update_attoseconds = sound_manager::STREAMS_UPDATE_ATTOTIME.attoseconds;
 	m_attoseconds_per_sample = ATTOSECONDS_PER_SECOND / m_sample_rate;
 	m_max_samples_per_update = (update_attoseconds + m_attoseconds_per_sample - 1) / m_attoseconds_per_sample;
 
@@ -506,9 +639,21 @@ void sound_stream::recompute_sample_rate_data()
 			attoseconds_t latency = MAX(new_attosecs_per_sample, m_attoseconds_per_sample);
 
 			// if the input stream's sample rate is lower, we will use linear interpolation
-			// this requires an extra sample from the source
+			// this requires an extra sample from the source; the polyphase filter needs
+			// half its taps ahead instead, so only use it if that still fits comfortably
+			// within an update
+			input.m_polyphase = false;
 			if (input.m_source->m_stream->m_sample_rate < m_sample_rate)
-				latency += new_attosecs_per_sample;
+			{
+				attoseconds_t polyphase_latency = latency + (POLYPHASE_TAPS / 2) * new_attosecs_per_sample;
+				if (m_device.machine->sound().m_polyphase && polyphase_latency < update_attoseconds / 2)
+				{
+					latency = polyphase_latency;
+					input.m_polyphase = true;
+				}
+				else
+					latency += new_attosecs_per_sample;
+			}
 
 			// if our sample rates match exactly, we don't need any latency
 			else if (input.m_source->m_stream->m_sample_rate == m_sample_rate)
@@ -588,6 +733,9 @@ void sound_stream::allocate_output_buffers()
 
 void sound_stream::postload()
 {
+	// the log was drained before loading, so nothing can be pending
+	assert(m_write_count == 0);
+
 	// recompute the same rate information
 	recompute_sample_rate_data();
 
@@ -602,6 +750,36 @@ void sound_stream::postload()
 }
 
 
+//-------------------------------------------------
+//  current_sampindex - return the index of the
+//  sample at the current emulated time, relative
+//  to the second of the last global update
+//-------------------------------------------------
+
+INT32 sound_stream::current_sampindex() const
+{
+	// determine the number of samples since the start of this second
+	attotime time = m_device.machine->time();
+	INT32 sampindex = INT32(time.attoseconds / m_attoseconds_per_sample);
+
+	// if we're ahead of the last update, then adjust upwards
+	attotime last_update = m_device.machine->sound().last_update();
+	if (time.seconds > last_update.seconds)
+	{
+		assert(time.seconds == last_update.seconds + 1);
+		sampindex += m_sample_rate;
+	}
+
+	// if we're behind the last update, then adjust downwards
+	if (time.seconds < last_update.seconds)
+	{
+		assert(time.seconds == last_update.seconds - 1);
+		sampindex -= m_sample_rate;
+	}
+	return sampindex;
+}
+
+
 //-------------------------------------------------
 //  generate_samples - generate the requested
 //  number of samples for a stream, making sure
@@ -623,7 +801,7 @@ void sound_stream::generate_samples(int samples)
 		// update the stream to the current time
 		stream_input &input = m_input[inputnum];
 		if (input.m_source != NULL)
-			input.m_source->m_stream->update();
+			input.m_source->m_stream->update_to_current_time();
 
 		// generate the resampled data
 		m_input_array[inputnum] = generate_resampled_data(input, samples);
@@ -638,11 +816,60 @@ void sound_stream::generate_samples(int samples)
 
 	// run the callback
 	VPRINTF(("  callback(%p, %d)\n", this, samples));
-	(*m_callback)(&m_device, this, m_param, m_input_array, m_output_array, samples);
+	if (m_device.machine->sound().m_profiling)
+	{
+		osd_ticks_t start = osd_ticks();
+		(*m_callback)(&m_device, this, m_param, m_input_array, m_output_array, samples);
+		m_profile_ticks += osd_ticks() - start;
+		m_profile_samples += samples;
+		m_profile_calls++;
+	}
+	else
+		(*m_callback)(&m_device, this, m_param, m_input_array, m_output_array, samples);
 	VPRINTF(("  callback done\n"));
 }
 
 
+//-------------------------------------------------
+//  render_write_log - apply logged writes in
+//  order, generating the samples up to each one
+//  first; exactly what update() followed by the
+//  write would have done on the emulation thread
+//-------------------------------------------------
+
+void sound_stream::render_write_log()
+{
+	osd_lock_acquire(m_write_lock);
+	while (m_write_count > 0)
+	{
+		logged_write entry = m_write_log[m_write_first];
+		osd_lock_release(m_write_lock);
+
+		generate_samples(entry.m_sampindex - m_output_sampindex);
+		m_output_sampindex = entry.m_sampindex;
+		(*m_write_handler)(&m_device, this, m_param, entry.m_offset, entry.m_data);
+
+		osd_lock_acquire(m_write_lock);
+		m_write_first = (m_write_first + 1) % WRITE_LOG_SIZE;
+		m_write_count--;
+	}
+	m_render_pending = false;
+	osd_lock_release(m_write_lock);
+}
+
+
+//-------------------------------------------------
+//  render_callback - work item callback for the
+//  render thread
+//-------------------------------------------------
+
+void *sound_stream::render_callback(void *param, int threadid)
+{
+	reinterpret_cast<sound_stream *>(param)->render_write_log();
+	return NULL;
+}
+
+
 //-------------------------------------------------
 //  generate_resampled_data - generate the
 //  resample buffer for a given input
@@ -688,12 +915,25 @@ stream_sample_t *sound_stream::generate_resampled_data(stream_input &input, UINT
 
 	// if we have equal sample rates, we just need to copy
 	if (step == FRAC_ONE)
+		mix_scale(dest, source, gain, numsamples);
+
+	// input is undersampled and we want quality: run the polyphase filter centered
+	// between source[0] and source[1]
+	else if (step < FRAC_ONE && input.m_polyphase)
 	{
+		source -= POLYPHASE_TAPS / 2 - 1;
 		while (numsamples--)
 		{
-			// compute the sample
-			stream_sample_t sample = *source++;
-			*dest++ = (sample * gain) >> 8;
+			const INT32 *coeff = s_polyphase[basefrac >> (FRAC_BITS - POLYPHASE_PHASE_BITS)];
+			INT64 sample = 0;
+			for (int tap = 0; tap < POLYPHASE_TAPS; tap++)
+				sample += (INT64)source[tap] * coeff[tap];
+			*dest++ = ((stream_sample_t)(sample >> POLYPHASE_COEFF_BITS) * gain) >> 8;
+
+			// advance
+			basefrac += step;
+			source += basefrac >> FRAC_BITS;
+			basefrac &= FRAC_MASK;
 		}
 	}
 
@@ -763,6 +1003,50 @@ stream_sample_t *sound_stream::generate_resampled_data(stream_input &input, UINT
 }
 
 
+//-------------------------------------------------
+//  build_polyphase_table - compute the filter
+//  coefficients for each phase: a Blackman-
+//  windowed sinc, normalized so that each phase
+//  has exactly unity gain
+//-------------------------------------------------
+
+void sound_stream::build_polyphase_table()
+{
+	const int phases = 1 << POLYPHASE_PHASE_BITS;
+	const double halfwidth = POLYPHASE_TAPS / 2;
+
+	for (int phase = 0; phase < phases; phase++)
+	{
+		double frac = (double)phase / (double)phases;
+		double coeff[POLYPHASE_TAPS];
+		double total = 0;
+
+		// tap N sits at source[N - (TAPS/2 - 1)], so its distance from the
+		// interpolation point is (N - (TAPS/2 - 1)) - frac
+		for (int tap = 0; tap < POLYPHASE_TAPS; tap++)
+		{
+			double x = (double)(tap - (POLYPHASE_TAPS / 2 - 1)) - frac;
+			double sinc = (x == 0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+			double window = 0.42 + 0.5 * cos(M_PI * x / halfwidth) + 0.08 * cos(2.0 * M_PI * x / halfwidth);
+			coeff[tap] = sinc * window;
+			total += coeff[tap];
+		}
+
+		// quantize, then fold the rounding error into the largest tap
+		INT32 sum = 0;
+		int largest = 0;
+		for (int tap = 0; tap < POLYPHASE_TAPS; tap++)
+		{
+			s_polyphase[phase][tap] = (INT32)floor(coeff[tap] / total * (1 << POLYPHASE_COEFF_BITS) + 0.5);
+			sum += s_polyphase[phase][tap];
+			if (s_polyphase[phase][tap] > s_polyphase[phase][largest])
+				largest = tap;
+		}
+		s_polyphase[phase][largest] += (1 << POLYPHASE_COEFF_BITS) - sum;
+	}
+}
+
+
 
 //**************************************************************************
 //  STREAM INPUT
@@ -778,6 +1062,7 @@ sound_stream::stream_input::stream_input()
 	  m_bufsize(0),
 	  m_bufalloc(0),
 	  m_latency_attoseconds(0),
+	  m_polyphase(false),
 	  m_gain(0x100),
 	  m_initial_gain(0x100)
 {
@@ -821,9 +1106,20 @@ sound_manager::sound_manager(running_machine &machine)
 	  m_attenuation(0),
 	  m_nosound_mode(!options_get_bool(&machine.options(), OPTION_SOUND)),
 	  m_wavfile(NULL),
+	  m_soundlog(NULL),
+	  m_soundlog_devices(0),
 	  m_stream_list(machine.m_respool),
-	  m_update_attoseconds(STREAMS_UPDATE_ATTOTIME.attoseconds),
-	  m_last_update(attotime::zero)
+	  m_update_attoseconds(update_period_from_options(machine)),
+	  m_last_update(attotime::zero),
+	  m_update_queue(NULL),
+	  m_schedule_dirty(true),
+	  m_schedule(NULL),
+	  m_task(NULL),
+	  m_level_task(NULL),
+	  m_levels(0),
+	  m_profiling(options_get_bool(&machine.options(), OPTION_SOUNDPROFILE)),
+	  m_polyphase(options_get_bool(&machine.options(), OPTION_POLYPHASE)),
+	  m_render_thread(options_get_bool(&machine.options(), OPTION_SOUNDRENDERTHREAD))
 {
 	// get filename for WAV file or AVI file if specified
 	const char *wavfile = options_get_string(&machine.options(), OPTION_WAVWRITE);
@@ -836,20 +1132,43 @@ sound_manager::sound_manager(running_machine &machine)
 	// count the speakers
 	VPRINTF(("total speakers = %d\n", machine.m_devicelist.count(SPEAKER)));
 
+	// compute the polyphase filter before any streams need it
+	if (m_polyphase)
+		sound_stream::build_polyphase_table();
+
 	// allocate memory for mix buffers
 	m_leftmix = auto_alloc_array(&machine, INT32, machine.sample_rate);
 	m_rightmix = auto_alloc_array(&machine, INT32, machine.sample_rate);
 	m_finalmix = auto_alloc_array(&machine, INT16, machine.sample_rate);
 
-	// open the output WAV file if specified
+	// open the output WAV file if specified; a .flac extension selects FLAC
 	if (wavfile[0] != 0)
-		m_wavfile = wav_open(wavfile, machine.sample_rate, 2);
+	{
+		const char *ext = strrchr(wavfile, '.');
+		UINT32 flags = (ext != NULL && core_stricmp(ext, ".flac") == 0) ? WAV_STREAM_FLAC : 0;
+		m_wavfile = wav_open_stream(wavfile, machine.sample_rate, 2, flags);
+	}
+
+	// open the register write log if specified
+	const char *soundlog = options_get_string(&machine.options(), OPTION_SOUNDLOG);
+	if (soundlog[0] != 0 && core_fopen(soundlog, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE, &m_soundlog) == FILERR_NONE)
+	{
+		UINT8 header[SOUNDLOG_HEADER_SIZE];
+		memcpy(header, SOUNDLOG_MAGIC, 8);
+		soundlog_put_32(&header[8], SOUNDLOG_VERSION);
+		core_fwrite(m_soundlog, header, sizeof(header));
+	}
 
 	// register callbacks
 	config_register(&machine, "mixer", &sound_manager::config_load, &sound_manager::config_save);
 	machine.add_notifier(MACHINE_NOTIFY_PAUSE, &sound_manager::pause);
 	machine.add_notifier(MACHINE_NOTIFY_RESUME, &sound_manager::resume);
 	machine.add_notifier(MACHINE_NOTIFY_RESET, &sound_manager::reset);
+	machine.add_notifier(MACHINE_NOTIFY_EXIT, &sound_manager::exit);
+
+	// allocate a queue for generating independent streams in parallel
+	if (options_get_bool(&machine.options(), OPTION_SOUNDTHREADS))
+		m_update_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
 
 	// register global states
 	state_save_register_global(&machine, m_last_update);
@@ -858,7 +1177,28 @@ sound_manager::sound_manager(running_machine &machine)
 	set_attenuation(options_get_int(&machine.options(), OPTION_VOLUME));
 
 	// start the periodic update flushing timer
-	m_update_timer->adjust(STREAMS_UPDATE_ATTOTIME, 0, STREAMS_UPDATE_ATTOTIME);
+	attotime update_period(0, m_update_attoseconds);
+	m_update_timer->adjust(update_period, 0, update_period);
+}
+
+
+//-------------------------------------------------
+//  update_period_from_options - compute the
+//  period of global updates; more frequent
+//  updates send sound to the OSD with less delay
+//  at the cost of more overhead. Streams size
+//  their buffers from this, so it can't be slower
+//  than the default.
+//-------------------------------------------------
+
+attoseconds_t sound_manager::update_period_from_options(running_machine &machine)
+{
+	int frequency = options_get_int(&machine.options(), OPTION_SOUNDUPDATERATE);
+	if (frequency < STREAMS_UPDATE_FREQUENCY)
+		frequency = STREAMS_UPDATE_FREQUENCY;
+	else if (frequency > STREAMS_UPDATE_FREQUENCY_MAX)
+		frequency = STREAMS_UPDATE_FREQUENCY_MAX;
+	return HZ_TO_ATTOSECONDS(frequency);
 }
 
 
@@ -872,6 +1212,11 @@ sound_manager::~sound_manager()
 	if (m_wavfile != NULL)
 		wav_close(m_wavfile);
 	m_wavfile = NULL;
+
+	// and the register write log, if the exit notifier didn't get to it
+	if (m_soundlog != NULL)
+		core_fclose(m_soundlog);
+	m_soundlog = NULL;
 }
 
 
@@ -942,6 +1287,7 @@ INLINE INT16 calc_volume_mixer(INT32 sample)
 
 sound_stream *sound_manager::stream_alloc(device_t &device, int inputs, int outputs, int sample_rate, void *param, sound_stream::stream_update_func callback)
 {
+	m_schedule_dirty = true;
 	if (callback != NULL)
 		return &m_stream_list.append(*auto_alloc(device.machine, sound_stream(device, inputs, outputs, sample_rate, param, callback)));
 	else
@@ -1032,6 +1378,277 @@ void sound_manager::resume(running_machine &machine)
 }
 
 
+//-------------------------------------------------
+//  exit - report stream timing and release the
+//  update queue
+//-------------------------------------------------
+
+void sound_manager::exit(running_machine &machine)
+{
+	sound_manager &sound = machine.sound();
+
+	if (sound.m_profiling)
+		sound.display_stream_profiling();
+
+	if (sound.m_update_queue != NULL)
+		osd_work_queue_free(sound.m_update_queue);
+	sound.m_update_queue = NULL;
+
+	// shut down any render threads
+	for (sound_stream *stream = sound.m_stream_list.first(); stream != NULL; stream = stream->next())
+		stream->stop_render_thread();
+
+	// terminate the register write log
+	sound.close_soundlog();
+}
+
+
+//-------------------------------------------------
+//  write_soundlog - append a chip register write
+//  to the log, naming the device first if this
+//  is its first write
+//-------------------------------------------------
+
+void sound_manager::write_soundlog(device_t &device, offs_t offset, UINT8 data)
+{
+	UINT8 record[SOUNDLOG_WRITE_SIZE];
+	int index;
+
+	// find the device, or add it
+	for (index = 0; index < m_soundlog_devices; index++)
+		if (m_soundlog_device[index] == &device)
+			break;
+	if (index == m_soundlog_devices)
+	{
+		const char *name = device.name();
+		const char *tag = device.tag();
+		UINT8 namelen = MIN(strlen(name), 255);
+		UINT8 taglen = MIN(strlen(tag), 255);
+
+		// drop writes to chips beyond the limit
+		if (m_soundlog_devices == MAX_SOUNDLOG_DEVICES)
+			return;
+		m_soundlog_device[m_soundlog_devices++] = &device;
+
+		record[0] = SOUNDLOG_RECORD_DEVICE;
+		record[1] = index;
+		record[2] = namelen;
+		record[3] = taglen;
+		soundlog_put_32(&record[4], device.clock());
+		core_fwrite(m_soundlog, record, SOUNDLOG_DEVICE_SIZE);
+		core_fwrite(m_soundlog, name, namelen);
+		core_fwrite(m_soundlog, tag, taglen);
+	}
+
+	// then the write itself, stamped with the current emulated time
+	attotime time = m_machine.time();
+	record[0] = SOUNDLOG_RECORD_WRITE;
+	record[1] = index;
+	record[2] = data;
+	record[3] = 0;
+	soundlog_put_32(&record[4], offset);
+	soundlog_put_32(&record[8], time.seconds);
+	soundlog_put_64(&record[12], time.attoseconds);
+	core_fwrite(m_soundlog, record, SOUNDLOG_WRITE_SIZE);
+}
+
+
+//-------------------------------------------------
+//  close_soundlog - mark the end of the session
+//  in the register write log and close it
+//-------------------------------------------------
+
+void sound_manager::close_soundlog()
+{
+	if (m_soundlog == NULL)
+		return;
+
+	// the end record tells the replay how long to keep rendering
+	UINT8 record[SOUNDLOG_WRITE_SIZE] = { 0 };
+	attotime time = m_machine.time();
+	record[0] = SOUNDLOG_RECORD_END;
+	soundlog_put_32(&record[8], time.seconds);
+	soundlog_put_64(&record[12], time.attoseconds);
+	core_fwrite(m_soundlog, record, SOUNDLOG_WRITE_SIZE);
+
+	core_fclose(m_soundlog);
+	m_soundlog = NULL;
+}
+
+
+//-------------------------------------------------
+//  sync_write_logs - wait for every render
+//  thread to apply its logged writes, so that
+//  chip state can be saved or loaded
+//-------------------------------------------------
+
+void sound_manager::sync_write_logs()
+{
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		stream->sync_write_log();
+}
+
+
+//-------------------------------------------------
+//  build_stream_schedule - sort the streams by
+//  their depth in the graph so that every stream
+//  at a given level only depends on streams at
+//  lower levels, then group them by device
+//-------------------------------------------------
+
+void sound_manager::build_stream_schedule()
+{
+	int count = m_stream_list.count();
+
+	// compute the level of each stream; iterate until nothing changes, which
+	// takes at most one pass per level since the graph is acyclic
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		stream->m_graph_level = 0;
+	for (int pass = 0; pass < count; pass++)
+	{
+		bool changed = false;
+		for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+			for (int inputnum = 0; inputnum < stream->m_inputs; inputnum++)
+			{
+				sound_stream::stream_output *source = stream->m_input[inputnum].m_source;
+				if (source != NULL && source->m_stream->m_graph_level >= stream->m_graph_level)
+				{
+					stream->m_graph_level = source->m_stream->m_graph_level + 1;
+					changed = true;
+				}
+			}
+		if (!changed)
+			break;
+	}
+
+	// free the old schedule
+	auto_free(&m_machine, m_schedule);
+	auto_free(&m_machine, m_task);
+	auto_free(&m_machine, m_level_task);
+
+	// sort the streams by level, keeping streams of the same device together;
+	// a device's streams may share state, so they must never run concurrently
+	m_schedule = auto_alloc_array(&m_machine, sound_stream *, count + 1);
+	m_levels = 0;
+	int index = 0;
+	for (int level = 0; index < count; level++)
+	{
+		for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+			if (stream->m_graph_level == level)
+			{
+				// skip streams whose device has already been placed at this level
+				bool placed = false;
+				for (int prev = index - 1; prev >= 0 && m_schedule[prev]->m_graph_level == level; prev--)
+					if (&m_schedule[prev]->device() == &stream->device())
+						placed = true;
+				if (placed)
+					continue;
+
+				// add all of this device's streams at this level
+				for (sound_stream *other = stream; other != NULL; other = other->next())
+					if (other->m_graph_level == level && &other->device() == &stream->device())
+						m_schedule[index++] = other;
+			}
+		m_levels = level + 1;
+	}
+	m_schedule[count] = NULL;
+
+	// now break the schedule into tasks
+	m_task = auto_alloc_array(&m_machine, stream_task, count + 1);
+	m_level_task = auto_alloc_array(&m_machine, int, m_levels + 1);
+	int tasknum = 0;
+	for (index = 0; index < count; index++)
+	{
+		int level = m_schedule[index]->m_graph_level;
+		if (index == 0 || level != m_schedule[index - 1]->m_graph_level)
+			m_level_task[level] = tasknum;
+		if (index == 0 || level != m_schedule[index - 1]->m_graph_level || &m_schedule[index]->device() != &m_schedule[index - 1]->device())
+		{
+			m_task[tasknum].m_stream = &m_schedule[index];
+			m_task[tasknum].m_count = 0;
+			tasknum++;
+		}
+		m_task[tasknum - 1].m_count++;
+	}
+	m_level_task[m_levels] = tasknum;
+
+	VPRINTF(("stream schedule: %d streams, %d levels, %d tasks\n", count, m_levels, tasknum));
+	m_schedule_dirty = false;
+}
+
+
+//-------------------------------------------------
+//  update_task_callback - work item callback that
+//  brings one group of streams up to date
+//-------------------------------------------------
+
+void *sound_manager::update_task_callback(void *param, int threadid)
+{
+	stream_task *task = reinterpret_cast<stream_task *>(param);
+	for (int streamnum = 0; streamnum < task->m_count; streamnum++)
+		task->m_stream[streamnum]->update_to_current_time();
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  update_streams_parallel - bring every stream
+//  up to the current time one graph level at a
+//  time, generating the independent streams on
+//  each level concurrently
+//-------------------------------------------------
+
+void sound_manager::update_streams_parallel()
+{
+	if (m_schedule_dirty)
+		build_stream_schedule();
+
+	for (int level = 0; level < m_levels; level++)
+	{
+		int first = m_level_task[level];
+		int count = m_level_task[level + 1] - first;
+
+		// a single task isn't worth the trip through the queue
+		if (count == 1)
+			update_task_callback(&m_task[first], 0);
+		else if (count > 1)
+		{
+			osd_work_item_queue_multiple(m_update_queue, update_task_callback, count, &m_task[first], sizeof(m_task[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+
+			// the next level reads these streams' output, so wait however long it takes
+			while (!osd_work_queue_wait(m_update_queue, osd_ticks_per_second() * 10))
+				;
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  display_stream_profiling - print the time
+//  spent generating samples for each device
+//-------------------------------------------------
+
+void sound_manager::display_stream_profiling()
+{
+	osd_ticks_t total = 0;
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		total += stream->m_profile_ticks;
+	if (total == 0)
+		return;
+
+	double ticks_per_usec = (double)osd_ticks_per_second() / 1000000.0;
+	mame_printf_info("Sound stream timing:\n");
+	mame_printf_info("%-24s %-16s %5s %10s %12s %12s %7s\n", "Device", "Tag", "Level", "Calls", "Samples", "usec", "Share");
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		mame_printf_info("%-24s %-16s %5d %10d %12" I64FMT "d %12.0f %6.2f%%\n",
+				stream->device().name(), stream->device().tag(), stream->m_graph_level,
+				stream->m_profile_calls, stream->m_profile_samples,
+				(double)stream->m_profile_ticks / ticks_per_usec,
+				(double)stream->m_profile_ticks * 100.0 / (double)total);
+	mame_printf_info("Total: %.0f usec\n", (double)total / ticks_per_usec);
+}
+
+
 //-------------------------------------------------
 //  config_load - read and apply data from the
 //  configuration file
@@ -1135,6 +1752,14 @@ void sound_manager::update()
 
 	g_profiler.start(PROFILER_SOUND);
 
+	// any ROMs -faststart held back are needed before sound is generated for real
+	rom_load_deferred(&m_machine);
+
+	// bring the whole graph up to date in parallel if enabled; the speakers
+	// below will then find their inputs already generated
+	if (m_update_queue != NULL)
+		update_streams_parallel();
+
 	// force all the speaker streams to generate the proper number of samples
 	int samples_this_update = 0;
 	for (speaker_device *speaker = downcast<speaker_device *>(m_machine.m_devicelist.first(SPEAKER)); speaker != NULL; speaker = speaker->next_speaker())
@@ -1169,6 +1794,14 @@ void sound_manager::update()
 	}
 	else
 #endif /* USE_VOLUME_AUTO_ADJUST */
+	// at normal speed every sample is used exactly once, so clamp them all in one go
+	if (finalmix_step == 100 && m_finalmix_leftover < 100)
+	{
+		mix_clamp_interleave(finalmix, m_leftmix, m_rightmix, samples_this_update);
+		finalmix_offset = samples_this_update * 2;
+		sample = m_finalmix_leftover + samples_this_update * 100;
+	}
+	else
 	for (sample = m_finalmix_leftover; sample < samples_this_update * 100; sample += finalmix_step)
 	{
 		int sampindex = sample / 100;
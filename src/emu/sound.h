@@ -52,6 +52,7 @@
 //**************************************************************************
 
 #define STREAM_UPDATE(name) void name(device_t *device, sound_stream *stream, void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples)
+#define STREAM_WRITE(name) void name(device_t *device, sound_stream *stream, void *param, offs_t offset, UINT32 data)
 
 
 
@@ -81,6 +82,7 @@ class sound_stream
 	friend class sound_manager;
 
 	typedef void (*stream_update_func)(device_t *device, sound_stream *stream, void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples);
+	typedef void (*stream_write_func)(device_t *device, sound_stream *stream, void *param, offs_t offset, UINT32 data);
 
 	// stream output class
 	class stream_output
@@ -109,15 +111,28 @@ class sound_stream
 		UINT32				m_bufsize;				// size of output buffer, in samples
 		UINT32				m_bufalloc;				// allocated size of output buffer, in samples
 		attoseconds_t		m_latency_attoseconds;	// latency between this stream and the input stream
+		bool				m_polyphase;			// true to upsample with the polyphase filter
 		INT16				m_gain;					// gain to apply to this input
 		INT16				m_initial_gain;			// initial gain supplied at creation
 	};
 
+	// a register write waiting for the render thread
+	struct logged_write
+	{
+		INT32				m_sampindex;			// sample index the write takes effect at
+		offs_t				m_offset;				// offset passed to the write handler
+		UINT32				m_data;					// data passed to the write handler
+	};
+
 	// constants
 	static const int OUTPUT_BUFFER_UPDATES		= 5;
+	static const int WRITE_LOG_SIZE				= 4096;
 	static const UINT32 FRAC_BITS				= 22;
 	static const UINT32 FRAC_ONE				= 1 << FRAC_BITS;
 	static const UINT32 FRAC_MASK				= FRAC_ONE - 1;
+	static const int POLYPHASE_TAPS				= 8;
+	static const int POLYPHASE_PHASE_BITS		= 8;
+	static const int POLYPHASE_COEFF_BITS		= 14;
 
 	// construction/destruction
 	sound_stream(device_t &device, int inputs, int outputs, int sample_rate, void *param = NULL, stream_update_func callback = &sound_stream::device_stream_update_stub);
@@ -138,7 +153,9 @@ public:
 
 	// operations
 	void set_input(int inputnum, sound_stream *input_stream, int outputnum = 0, float gain = 1.0f);
+	void set_write_handler(stream_write_func handler);
 	void update();
+	void write(offs_t offset, UINT32 data);
 	const stream_sample_t *output_since_last_update(int outputnum, int &numsamples);
 
 	// timing
@@ -148,7 +165,10 @@ public:
 
 private:
 	// helpers called by our friends only
+	void update_to_current_time();
 	void update_with_accounting(bool second_tick);
+	void sync_write_log();
+	void stop_render_thread();
 	void apply_sample_rate_changes();
 
 	// internal helpers
@@ -157,8 +177,15 @@ private:
 	void allocate_resample_buffers();
 	void allocate_output_buffers();
 	void postload();
+	INT32 current_sampindex() const;
 	void generate_samples(int samples);
+	void render_write_log();
+	static void *render_callback(void *param, int threadid);
 	stream_sample_t *generate_resampled_data(stream_input &input, UINT32 numsamples);
+	static void build_polyphase_table();
+
+	// polyphase filter coefficients, indexed by phase and tap
+	static INT32		s_polyphase[1 << POLYPHASE_PHASE_BITS][POLYPHASE_TAPS];
 
 	// linking information
 	device_t &			m_device;				// owning device
@@ -194,6 +221,21 @@ private:
 	// callback information
 	stream_update_func	m_callback;				// callback function
 	void *				m_param;				// callback function parameter
+
+	// scheduling information
+	int					m_graph_level;			// depth in the stream graph (0 = no sourced inputs)
+	osd_ticks_t			m_profile_ticks;		// total ticks spent in the callback
+	UINT64				m_profile_samples;		// total samples generated
+	UINT32				m_profile_calls;		// number of callback invocations
+
+	// register write log, consumed by the render thread
+	stream_write_func	m_write_handler;		// applies a logged write to the chip state
+	osd_work_queue *	m_render_queue;			// render thread (NULL to apply writes inline)
+	osd_lock *			m_write_lock;			// protects the fields below
+	logged_write *		m_write_log;			// ring buffer of pending writes
+	int					m_write_first;			// index of the oldest pending write
+	int					m_write_count;			// number of pending writes
+	bool				m_render_pending;		// true if a render work item is queued or running
 };
 
 
@@ -211,6 +253,17 @@ class sound_manager
 
 	// stream updates
 	static const attotime STREAMS_UPDATE_ATTOTIME;
+	static const int STREAMS_UPDATE_FREQUENCY_MAX = 500;
+
+	// at most this many chips are named in a register write log
+	static const int MAX_SOUNDLOG_DEVICES = 32;
+
+	// a group of streams belonging to one device at one level of the graph
+	struct stream_task
+	{
+		sound_stream **		m_stream;				// first stream in the group
+		int					m_count;				// number of streams in the group
+	};
 
 public:
 	static const int STREAMS_UPDATE_FREQUENCY = 50;
@@ -224,6 +277,7 @@ public:
 	sound_stream *first_stream() const { return m_stream_list.first(); }
 	attotime last_update() const { return m_last_update; }
 	attoseconds_t update_attoseconds() const { return m_update_attoseconds; }
+	int update_frequency() const { return ATTOSECONDS_TO_HZ(m_update_attoseconds) + 0.5; }
 
 	// stream creation
 	sound_stream *stream_alloc(device_t &device, int inputs, int outputs, int sample_rate, void *param = NULL, sound_stream::stream_update_func callback = NULL);
@@ -238,14 +292,29 @@ public:
 	// user gain controls
 	bool indexed_speaker_input(int index, speaker_input &info) const;
 
+	// render threads
+	void sync_write_logs();
+
+	// register write logging for the soundbench tool
+	void log_write(device_t &device, offs_t offset, UINT8 data) { if (m_soundlog != NULL) write_soundlog(device, offset, data); }
+
 private:
 	// internal helpers
+	static attoseconds_t update_period_from_options(running_machine &machine);
 	void mute(bool mute, UINT8 reason);
 	static void reset(running_machine &machine);
 	static void pause(running_machine &machine);
 	static void resume(running_machine &machine);
 	static void config_load(running_machine *machine, int config_type, xml_data_node *parentnode);
 	static void config_save(running_machine *machine, int config_type, xml_data_node *parentnode);
+	static void exit(running_machine &machine);
+
+	void build_stream_schedule();
+	void update_streams_parallel();
+	void display_stream_profiling();
+	static void *update_task_callback(void *param, int threadid);
+	void write_soundlog(device_t &device, offs_t offset, UINT8 data);
+	void close_soundlog();
 
 	static TIMER_CALLBACK( update_static ) { reinterpret_cast<sound_manager *>(ptr)->update(); }
 	void update();
@@ -265,10 +334,26 @@ private:
 
 	wav_file *			m_wavfile;
 
+	// register write log
+	core_file *			m_soundlog;				// log file (NULL if disabled)
+	device_t *			m_soundlog_device[MAX_SOUNDLOG_DEVICES];	// devices named in the log so far
+	int					m_soundlog_devices;		// number of devices named in the log
+
 	// streams data
 	simple_list<sound_stream> m_stream_list;	// list of streams
 	attoseconds_t		m_update_attoseconds;	// attoseconds between global updates
 	attotime			m_last_update;			// last update time
+
+	// parallel stream scheduling
+	osd_work_queue *	m_update_queue;			// work queue for independent streams (NULL if disabled)
+	bool				m_schedule_dirty;		// true if the stream graph changed since the last schedule
+	sound_stream **		m_schedule;				// streams sorted by graph level, then device
+	stream_task *		m_task;					// groups of streams that can run concurrently
+	int *				m_level_task;			// index of the first task at each level, plus a terminator
+	int					m_levels;				// number of levels in the graph
+	bool				m_profiling;			// true to collect per-stream timing
+	bool				m_polyphase;			// true to upsample with the polyphase filter
+	bool				m_render_thread;		// true to render logged streams on their own thread
 };
 
 
@@ -98,6 +98,7 @@ WRITE8_DEVICE_HANDLER( ym2151_w )
 {
 	ym2151_state *token = get_safe_token(device);
 
+	device->machine->sound().log_write(*device, offset, data);
 	if (offset & 1)
 	{
 		token->stream->update();
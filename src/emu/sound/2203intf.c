@@ -171,6 +171,7 @@ READ8_DEVICE_HANDLER( ym2203_r )
 WRITE8_DEVICE_HANDLER( ym2203_w )
 {
 	ym2203_state *info = get_safe_token(device);
+	device->machine->sound().log_write(*device, offset, data);
 	ym2203_write(info->chip, offset & 1, data);
 }
 
@@ -144,6 +144,7 @@ READ8_DEVICE_HANDLER( ym2612_r )
 WRITE8_DEVICE_HANDLER( ym2612_w )
 {
 	ym2612_state *info = get_safe_token(device);
+	device->machine->sound().log_write(*device, offset, data);
 	ym2612_write(info->chip, offset & 3, data);
 }
 
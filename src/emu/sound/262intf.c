@@ -122,6 +122,7 @@ READ8_DEVICE_HANDLER( ymf262_r )
 WRITE8_DEVICE_HANDLER( ymf262_w )
 {
 	ymf262_state *info = get_safe_token(device);
+	device->machine->sound().log_write(*device, offset, data);
 	ymf262_write(info->chip, offset & 3, data);
 }
 
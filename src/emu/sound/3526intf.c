@@ -131,6 +131,7 @@ READ8_DEVICE_HANDLER( ym3526_r )
 WRITE8_DEVICE_HANDLER( ym3526_w )
 {
 	ym3526_state *info = get_safe_token(device);
+	device->machine->sound().log_write(*device, offset, data);
 	ym3526_write(info->chip, offset & 1, data);
 }
 
@@ -132,6 +132,7 @@ READ8_DEVICE_HANDLER( ym3812_r )
 WRITE8_DEVICE_HANDLER( ym3812_w )
 {
 	ym3812_state *info = get_safe_token(device);
+	device->machine->sound().log_write(*device, offset, data);
 	ym3812_write(info->chip, offset & 1, data);
 }
 
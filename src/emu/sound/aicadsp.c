@@ -53,11 +53,105 @@ static INT32 UNPACK(UINT16 val)
 	return uval;
 }
 
+//flags of a compiled step
+#define AICADSP_OP_IN_MEMS	0x00001	//INPUTS from MEMS[IRA]
+#define AICADSP_OP_IN_MIXS	0x00002	//INPUTS from MIXS[IRA]<<4
+#define AICADSP_OP_IN_ZERO	0x00004	//INPUTS=0 (none of the three: INPUTS unchanged)
+#define AICADSP_OP_IWT		0x00008
+#define AICADSP_OP_IWT_IN	0x00010	//IWT to the register being read: INPUTS=MEMVAL
+#define AICADSP_OP_TWT		0x00020
+#define AICADSP_OP_XSEL		0x00040
+#define AICADSP_OP_ZERO		0x00080
+#define AICADSP_OP_BSEL		0x00100
+#define AICADSP_OP_NEGB		0x00200
+#define AICADSP_OP_YRL		0x00400
+#define AICADSP_OP_FRCL		0x00800
+#define AICADSP_OP_ADRL		0x01000
+#define AICADSP_OP_EWT		0x02000
+#define AICADSP_OP_MRD		0x04000	//only set on odd steps
+#define AICADSP_OP_MWT		0x08000	//only set on odd steps
+#define AICADSP_OP_TABLE	0x10000
+#define AICADSP_OP_ADREB	0x20000
+#define AICADSP_OP_NXADR	0x40000
+#define AICADSP_OP_NOFL		0x80000
+#define AICADSP_OP_SATURATE	0x100000	//SHIFT 0/1 saturate, 2/3 wrap to 24 bits
+
 void aica_dsp_init(struct _AICADSP *DSP)
 {
 	memset(DSP,0,sizeof(struct _AICADSP));
 	DSP->RBL=0x8000;
 	DSP->Stopped=1;
+	DSP->Dirty=1;
+}
+
+//decode MPRO once instead of on every sample; called from aica_dsp_step
+//whenever MPRO or the program length has changed
+void aica_dsp_compile(struct _AICADSP *DSP)
+{
+	int step;
+
+	DSP->ProgramLength=DSP->LastStep;
+	for(step=0;step<DSP->LastStep;++step)
+	{
+		UINT16 *IPtr=DSP->MPRO+step*8;
+		struct _AICADSP_OP *op=&DSP->Program[step];
+		UINT32 IRA=(IPtr[2]>>7)&0x3F;
+		UINT32 SHIFT=(IPtr[4]>>4)&0x03;
+		UINT32 flags=0;
+
+		op->TRA=(IPtr[0]>>9)&0x7F;
+		op->TWA=(IPtr[0]>>1)&0x7F;
+		op->IWA=(IPtr[2]>>1)&0x1F;
+		op->YSEL=(IPtr[2]>>13)&0x03;
+		op->EWA=(IPtr[4]>>8)&0x0F;
+		op->SHIFT=SHIFT;
+		op->COEF=step;
+		op->MASA=(IPtr[6]>>9)&0x1f;
+
+		assert(IRA<0x32);
+		if(IRA<=0x1f)
+		{
+			flags|=AICADSP_OP_IN_MEMS;
+			op->IRA=IRA;
+		}
+		else if(IRA<=0x2F)
+		{
+			flags|=AICADSP_OP_IN_MIXS;
+			op->IRA=IRA-0x20;
+		}
+		else
+		{
+			if(IRA<=0x31)
+				flags|=AICADSP_OP_IN_ZERO;
+			op->IRA=0;
+		}
+
+		if((IPtr[0]>>8)&0x01) flags|=AICADSP_OP_TWT;
+		if((IPtr[2]>>15)&0x01) flags|=AICADSP_OP_XSEL;
+		if((IPtr[2]>>6)&0x01)
+		{
+			flags|=AICADSP_OP_IWT;
+			if(IRA==op->IWA)
+				flags|=AICADSP_OP_IWT_IN;
+		}
+		if((IPtr[4]>>15)&0x01) flags|=AICADSP_OP_TABLE;
+		if(((IPtr[4]>>14)&0x01) && (step&1)) flags|=AICADSP_OP_MWT;	//memory only allowed on odd? DoA inserts NOPs on even
+		if(((IPtr[4]>>13)&0x01) && (step&1)) flags|=AICADSP_OP_MRD;
+		if((IPtr[4]>>12)&0x01) flags|=AICADSP_OP_EWT;
+		if((IPtr[4]>>7)&0x01) flags|=AICADSP_OP_ADRL;
+		if((IPtr[4]>>6)&0x01) flags|=AICADSP_OP_FRCL;
+		if((IPtr[4]>>3)&0x01) flags|=AICADSP_OP_YRL;
+		if((IPtr[4]>>2)&0x01) flags|=AICADSP_OP_NEGB;
+		if((IPtr[4]>>1)&0x01) flags|=AICADSP_OP_ZERO;
+		if((IPtr[4]>>0)&0x01) flags|=AICADSP_OP_BSEL;
+		if((IPtr[6]>>15)&0x01) flags|=AICADSP_OP_NOFL;
+		if((IPtr[6]>>8)&0x01) flags|=AICADSP_OP_ADREB;
+		if((IPtr[6]>>7)&0x01) flags|=AICADSP_OP_NXADR;
+		if(SHIFT<2) flags|=AICADSP_OP_SATURATE;
+
+		op->Flags=flags;
+	}
+	DSP->Dirty=0;
 }
 
 void aica_dsp_step(struct _AICADSP *DSP)
@@ -73,257 +167,145 @@ void aica_dsp_step(struct _AICADSP *DSP)
 	INT32 Y_REG=0;		//24 bit
 	UINT32 ADDR=0;
 	UINT32 ADRS_REG=0;	//13 bit
-	int step;
+	const struct _AICADSP_OP *op, *end;
 
 	if(DSP->Stopped)
 		return;
 
+	if(DSP->Dirty)
+		aica_dsp_compile(DSP);
+
 	memset(DSP->EFREG,0,2*16);
-#if 0
-	int dump=0;
-	FILE *f=NULL;
-	if(dump)
-		f=fopen("dsp.txt","wt");
-#endif
-	for(step=0;step</*128*/DSP->LastStep;++step)
+	end=DSP->Program+DSP->ProgramLength;
+	for(op=DSP->Program;op<end;++op)
 	{
-		UINT16 *IPtr=DSP->MPRO+step*8;
-
-//      if(IPtr[0]==0 && IPtr[1]==0 && IPtr[2]==0 && IPtr[3]==0)
-//          break;
-
-		UINT32 TRA=(IPtr[0]>>9)&0x7F;
-		UINT32 TWT=(IPtr[0]>>8)&0x01;
-		UINT32 TWA=(IPtr[0]>>1)&0x7F;
-
-		UINT32 XSEL=(IPtr[2]>>15)&0x01;
-		UINT32 YSEL=(IPtr[2]>>13)&0x03;
-		UINT32 IRA=(IPtr[2]>>7)&0x3F;
-		UINT32 IWT=(IPtr[2]>>6)&0x01;
-		UINT32 IWA=(IPtr[2]>>1)&0x1F;
-
-		UINT32 TABLE=(IPtr[4]>>15)&0x01;
-		UINT32 MWT=(IPtr[4]>>14)&0x01;
-		UINT32 MRD=(IPtr[4]>>13)&0x01;
-		UINT32 EWT=(IPtr[4]>>12)&0x01;
-		UINT32 EWA=(IPtr[4]>>8)&0x0F;
-		UINT32 ADRL=(IPtr[4]>>7)&0x01;
-		UINT32 FRCL=(IPtr[4]>>6)&0x01;
-		UINT32 SHIFT=(IPtr[4]>>4)&0x03;
-		UINT32 YRL=(IPtr[4]>>3)&0x01;
-		UINT32 NEGB=(IPtr[4]>>2)&0x01;
-		UINT32 ZERO=(IPtr[4]>>1)&0x01;
-		UINT32 BSEL=(IPtr[4]>>0)&0x01;
-
-		UINT32 NOFL=(IPtr[6]>>15)&1;		//????
-		UINT32 COEF=step;
+		UINT32 flags=op->Flags;
+		INT32 TEMPVAL;
 
-		UINT32 MASA=(IPtr[6]>>9)&0x1f;	//???
-		UINT32 ADREB=(IPtr[6]>>8)&0x1;
-		UINT32 NXADR=(IPtr[6]>>7)&0x1;
-
-		INT64 v;
-
-		//operations are done at 24 bit precision
-#if 0
-		if(MASA)
-			int a=1;
-		if(NOFL)
-			int a=1;
-
-//      int dump=0;
-
-		if(f)
-		{
-#define DUMP(v)	fprintf(f," " #v ": %04X",v);
-
-			fprintf(f,"%d: ",step);
-			DUMP(ACC);
-			DUMP(SHIFTED);
-			DUMP(X);
-			DUMP(Y);
-			DUMP(B);
-			DUMP(INPUTS);
-			DUMP(MEMVAL);
-			DUMP(FRC_REG);
-			DUMP(Y_REG);
-			DUMP(ADDR);
-			DUMP(ADRS_REG);
-			fprintf(f,"\n");
-		}
-#endif
 		//INPUTS RW
-		assert(IRA<0x32);
-		if(IRA<=0x1f)
-			INPUTS=DSP->MEMS[IRA];
-		else if(IRA<=0x2F)
-			INPUTS=DSP->MIXS[IRA-0x20]<<4;	//MIXS is 20 bit
-		else if(IRA<=0x31)
+		if(flags&AICADSP_OP_IN_MEMS)
+			INPUTS=DSP->MEMS[op->IRA];
+		else if(flags&AICADSP_OP_IN_MIXS)
+			INPUTS=DSP->MIXS[op->IRA]<<4;	//MIXS is 20 bit
+		else if(flags&AICADSP_OP_IN_ZERO)
 			INPUTS=0;
 
 		INPUTS<<=8;
 		INPUTS>>=8;
-		//if(INPUTS&0x00800000)
-		//  INPUTS|=0xFF000000;
 
-		if(IWT)
+		if(flags&AICADSP_OP_IWT)
 		{
-			DSP->MEMS[IWA]=MEMVAL;	//MEMVAL was selected in previous MRD
-			if(IRA==IWA)
+			DSP->MEMS[op->IWA]=MEMVAL;	//MEMVAL was selected in previous MRD
+			if(flags&AICADSP_OP_IWT_IN)
 				INPUTS=MEMVAL;
 		}
 
 		//Operand sel
+		TEMPVAL=DSP->TEMP[(op->TRA+DSP->DEC)&0x7F];
+		TEMPVAL<<=8;
+		TEMPVAL>>=8;
+
 		//B
-		if(!ZERO)
+		if(flags&AICADSP_OP_ZERO)
+			B=0;
+		else
 		{
-			if(BSEL)
-				B=ACC;
-			else
-			{
-				B=DSP->TEMP[(TRA+DSP->DEC)&0x7F];
-				B<<=8;
-				B>>=8;
-				//if(B&0x00800000)
-				//  B|=0xFF000000;  //Sign extend
-			}
-			if(NEGB)
+			B=(flags&AICADSP_OP_BSEL) ? ACC : TEMPVAL;
+			if(flags&AICADSP_OP_NEGB)
 				B=0-B;
 		}
-		else
-			B=0;
 
 		//X
-		if(XSEL)
-			X=INPUTS;
-		else
+		X=(flags&AICADSP_OP_XSEL) ? INPUTS : TEMPVAL;
+
+		//Y
+		switch(op->YSEL)
 		{
-			X=DSP->TEMP[(TRA+DSP->DEC)&0x7F];
-			X<<=8;
-			X>>=8;
-			//if(X&0x00800000)
-			//  X|=0xFF000000;
+			case 0: Y=FRC_REG; break;
+			case 1: Y=DSP->COEF[op->COEF<<1]>>3; break;	//COEF is 16 bits
+			case 2: Y=(Y_REG>>11)&0x1FFF; break;
+			case 3: Y=(Y_REG>>4)&0x0FFF; break;
 		}
 
-		//Y
-		if(YSEL==0)
-			Y=FRC_REG;
-		else if(YSEL==1)
-			Y=DSP->COEF[COEF<<1]>>3;	//COEF is 16 bits
-		else if(YSEL==2)
-			Y=(Y_REG>>11)&0x1FFF;
-		else if(YSEL==3)
-			Y=(Y_REG>>4)&0x0FFF;
-
-		if(YRL)
+		if(flags&AICADSP_OP_YRL)
 			Y_REG=INPUTS;
 
 		//Shifter
-		if(SHIFT==0)
+		SHIFTED=(op->SHIFT==1 || op->SHIFT==2) ? ACC*2 : ACC;
+		if(flags&AICADSP_OP_SATURATE)
 		{
-			SHIFTED=ACC;
 			if(SHIFTED>0x007FFFFF)
 				SHIFTED=0x007FFFFF;
 			if(SHIFTED<(-0x00800000))
 				SHIFTED=-0x00800000;
 		}
-		else if(SHIFT==1)
-		{
-			SHIFTED=ACC*2;
-			if(SHIFTED>0x007FFFFF)
-				SHIFTED=0x007FFFFF;
-			if(SHIFTED<(-0x00800000))
-				SHIFTED=-0x00800000;
-		}
-		else if(SHIFT==2)
-		{
-			SHIFTED=ACC*2;
-			SHIFTED<<=8;
-			SHIFTED>>=8;
-			//SHIFTED&=0x00FFFFFF;
-			//if(SHIFTED&0x00800000)
-			//  SHIFTED|=0xFF000000;
-		}
-		else if(SHIFT==3)
+		else
 		{
-			SHIFTED=ACC;
 			SHIFTED<<=8;
 			SHIFTED>>=8;
-			//SHIFTED&=0x00FFFFFF;
-			//if(SHIFTED&0x00800000)
-			//  SHIFTED|=0xFF000000;
 		}
 
 		//ACCUM
 		Y<<=19;
 		Y>>=19;
-		//if(Y&0x1000)
-		//  Y|=0xFFFFF000;
 
-		v=(((INT64) X*(INT64) Y)>>12);
-		ACC=(int) v+B;
+		ACC=(int)(((INT64) X*(INT64) Y)>>12)+B;
 
-		if(TWT)
-			DSP->TEMP[(TWA+DSP->DEC)&0x7F]=SHIFTED;
+		if(flags&AICADSP_OP_TWT)
+			DSP->TEMP[(op->TWA+DSP->DEC)&0x7F]=SHIFTED;
 
-		if(FRCL)
+		if(flags&AICADSP_OP_FRCL)
 		{
-			if(SHIFT==3)
+			if(op->SHIFT==3)
 				FRC_REG=SHIFTED&0x0FFF;
 			else
 				FRC_REG=(SHIFTED>>11)&0x1FFF;
 		}
 
-		if(MRD || MWT)
-		//if(0)
+		if(flags&(AICADSP_OP_MRD|AICADSP_OP_MWT))
 		{
-			ADDR=DSP->MADRS[MASA<<1];
-			if(!TABLE)
+			ADDR=DSP->MADRS[op->MASA<<1];
+			if(!(flags&AICADSP_OP_TABLE))
 				ADDR+=DSP->DEC;
-			if(ADREB)
+			if(flags&AICADSP_OP_ADREB)
 				ADDR+=ADRS_REG&0x0FFF;
-			if(NXADR)
+			if(flags&AICADSP_OP_NXADR)
 				ADDR++;
-			if(!TABLE)
+			if(!(flags&AICADSP_OP_TABLE))
 				ADDR&=DSP->RBL-1;
 			else
 				ADDR&=0xFFFF;
-			//ADDR<<=1;
-			//ADDR+=DSP->RBP<<13;
-			//MEMVAL=DSP->AICARAM[ADDR>>1];
 			ADDR+=DSP->RBP<<10;
-			if(MRD && (step&1))	//memory only allowed on odd? DoA inserts NOPs on even
+			if(flags&AICADSP_OP_MRD)
 			{
-				if(NOFL)
+				if(flags&AICADSP_OP_NOFL)
 					MEMVAL=DSP->AICARAM[ADDR]<<8;
 				else
 					MEMVAL=UNPACK(DSP->AICARAM[ADDR]);
 			}
-			if(MWT && (step&1))
+			if(flags&AICADSP_OP_MWT)
 			{
-				if(NOFL)
+				if(flags&AICADSP_OP_NOFL)
 					DSP->AICARAM[ADDR]=SHIFTED>>8;
 				else
 					DSP->AICARAM[ADDR]=PACK(SHIFTED);
 			}
 		}
 
-		if(ADRL)
+		if(flags&AICADSP_OP_ADRL)
 		{
-			if(SHIFT==3)
+			if(op->SHIFT==3)
 				ADRS_REG=(SHIFTED>>12)&0xFFF;
 			else
 				ADRS_REG=(INPUTS>>16);
 		}
 
-		if(EWT)
-			DSP->EFREG[EWA]+=SHIFTED>>8;
-
+		if(flags&AICADSP_OP_EWT)
+			DSP->EFREG[op->EWA]+=SHIFTED>>8;
 	}
+
 	--DSP->DEC;
 	memset(DSP->MIXS,0,4*16);
-//  if(f)
-//      fclose(f);
 }
 
 void aica_dsp_setsample(struct _AICADSP *DSP,INT32 sample,int SEL,int MXL)
@@ -346,5 +328,6 @@ void aica_dsp_start(struct _AICADSP *DSP)
 			break;
 	}
 	DSP->LastStep=i+1;
+	DSP->Dirty=1;
 
 }
@@ -3,6 +3,21 @@
 #ifndef __AICADSP_H__
 #define __AICADSP_H__
 
+//a microprogram step decoded by aica_dsp_compile
+struct _AICADSP_OP
+{
+	UINT32 Flags;	//AICADSP_OP_xxx
+	UINT8 TRA;
+	UINT8 TWA;
+	UINT8 IRA;	//MEMS or MIXS index, depending on the input flags
+	UINT8 IWA;
+	UINT8 YSEL;
+	UINT8 SHIFT;
+	UINT8 EWA;
+	UINT8 COEF;
+	UINT8 MASA;
+};
+
 //the DSP Context
 struct _AICADSP
 {
@@ -30,11 +45,17 @@ struct _AICADSP
 
 	int Stopped;
 	int LastStep;
+
+//compiled program
+	int Dirty;	//MPRO written since the last compile
+	int ProgramLength;
+	struct _AICADSP_OP Program[128];
 };
 
 void aica_dsp_init(struct _AICADSP *DSP);
 void aica_dsp_setsample(struct _AICADSP *DSP, INT32 sample, INT32 SEL, INT32 MXL);
 void aica_dsp_step(struct _AICADSP *DSP);
 void aica_dsp_start(struct _AICADSP *DSP);
+void aica_dsp_compile(struct _AICADSP *DSP);
 
 #endif /* __AICADSP_H__ */
@@ -45,6 +45,7 @@ private:																\
 	_priv																\
 }
 
+/* step-only nodes keep no state; their output is a function of the inputs */
 #define DISCRETE_CLASS_STEP(_name, _maxout, _priv)						\
 class DISCRETE_CLASS_NAME(_name): public discrete_base_node, public discrete_step_interface				\
 {																		\
@@ -53,6 +54,7 @@ class DISCRETE_CLASS_NAME(_name): public discrete_base_node, public discrete_ste
 public:																	\
 	void step(void);													\
 	void reset(void)			{ this->step(); }						\
+	bool is_stateless(void)		{ return true; }						\
 	int max_output(void) { return _maxout; }					\
 private:																\
 	_priv																\
@@ -129,6 +129,7 @@ public:
 	};
 	void step(void);
 	void reset(void);
+	bool is_stateless(void) { return true; }
 protected:
 private:
 	DISCRETE_CLASS_INPUT(I_IN0, 	0);
@@ -628,7 +628,7 @@ static UINT64 step_list_run_time(const node_step_list_t &list)
 
 void discrete_device::display_profiling(void)
 {
-	int count;
+	int count, stepped;
 	UINT64 total;
 	UINT64 tresh;
 	double tt;
@@ -649,13 +649,20 @@ void discrete_device::display_profiling(void)
 	}
 
 	/* Task information */
+	stepped = 0;
 	for_each(discrete_task **, task, &task_list)
 	{
 		tt =  step_list_run_time((*task)->step_list);
+		stepped += (*task)->step_list.count();
 
 		printf("Task(%d): %8.2f %15.2f\n", (*task)->task_group, tt / (double) total * 100.0, tt / (double) m_total_samples);
 	}
 
+	/* Compile information; run with DISCRETE_COMPILE=0 to profile the uncompiled nodes */
+	printf("Compiled: %s, %d of %d step nodes folded, %d node inputs made static\n", m_compile ? "yes" : "no", m_folded_list.count(), stepped + m_folded_list.count(), m_static_inputs);
+	for_each(discrete_base_node **, node, &m_folded_list)
+		printf("%3d: %20s   folded\n", (*node)->index(), (*node)->module_name());
+
 	printf("Average samples/double->update: %8.2f\n", (double) m_total_samples / (double) m_total_stream_updates);
 }
 
@@ -782,6 +789,111 @@ void discrete_device::init_nodes(const sound_block_list_t &block_list)
 }
 
 
+/*************************************
+ *
+ *  Compile the step lists
+ *
+ *************************************/
+
+/*
+ * Stateless nodes whose inputs can never change produce the
+ * same output every sample. Fold them: evaluate them once after
+ * reset (see device_reset) and drop them from the task step lists.
+ * Folding repeats until nothing changes, so constants propagate
+ * through chains of nodes regardless of their block order.
+ *
+ * Afterwards, inputs of the remaining nodes that are fed by
+ * constants or folded nodes are turned into static inputs. Nodes
+ * which pick a fixed-value path at reset (RC/CR filters, 555s,
+ * VCOs) then take it, instead of rereading those inputs every
+ * sample.
+ */
+
+void discrete_device::compile_nodes(void)
+{
+	int changed;
+
+	m_folded_list.clear();
+	m_static_inputs = 0;
+	m_static_node = auto_alloc_array_clear(machine, UINT8, DISCRETE_MAX_NODES);
+
+	/* constants are set at reset and never change */
+	for_each(discrete_base_node **, node, &m_node_list)
+		if ((*node)->block_node() != NODE_SPECIAL && dynamic_cast<discrete_dss_constant_node *>(*node) != NULL)
+			m_static_node[NODE_INDEX((*node)->block_node())] = 1;
+
+	do
+	{
+		changed = 0;
+		for_each(discrete_base_node **, node, &m_node_list)
+		{
+			discrete_step_interface *step;
+			int inputnum, constant = 1;
+
+			if ((*node)->block_node() == NODE_SPECIAL || m_static_node[NODE_INDEX((*node)->block_node())])
+				continue;
+			if (!(*node)->interface(step) || !step->is_stateless())
+				continue;
+
+			/* static inputs are constant; node inputs must be constants or folded nodes */
+			for (inputnum = 0; inputnum < (*node)->active_inputs() && constant; inputnum++)
+				if ((*node)->input_is_node() & (1 << inputnum))
+				{
+					int inputnode = (*node)->input_node(inputnum);
+
+					if (!m_static_node[NODE_INDEX(inputnode)])
+						constant = 0;
+				}
+
+			if (constant)
+			{
+				m_static_node[NODE_INDEX((*node)->block_node())] = 1;
+				m_folded_list.add(*node);
+				changed = 1;
+			}
+		}
+	} while (changed);
+
+	/* rebuild the step lists without the folded nodes */
+	for_each(discrete_task **, task, &task_list)
+	{
+		node_step_list_t old_list = (*task)->step_list;
+
+		(*task)->step_list.clear();
+		for_each(discrete_step_interface **, entry, &old_list)
+		{
+			int node = (*entry)->self->block_node();
+
+			if (node == NODE_SPECIAL || !m_static_node[NODE_INDEX(node)])
+				(*task)->step_list.add(*entry);
+		}
+	}
+
+	/* the remaining nodes read constant and folded outputs as static values */
+	for_each(discrete_base_node **, node, &m_node_list)
+	{
+		int inputnum;
+
+		if ((*node)->block_node() != NODE_SPECIAL && m_static_node[NODE_INDEX((*node)->block_node())])
+			continue;
+
+		for (inputnum = 0; inputnum < (*node)->active_inputs(); inputnum++)
+			if (((*node)->m_input_is_node & (1 << inputnum)) && m_static_node[NODE_INDEX((*node)->input_node(inputnum))])
+			{
+				(*node)->m_input_is_node &= ~(1 << inputnum);
+				m_static_inputs++;
+			}
+	}
+
+	discrete_log("compile_nodes() - folded %d nodes into constants, %d node inputs made static", m_folded_list.count(), m_static_inputs);
+}
+
+int discrete_device::is_static_node(discrete_base_node *node)
+{
+	return node->block_node() != NODE_SPECIAL && m_static_node[NODE_INDEX(node->block_node())];
+}
+
+
 /*************************************
  *
  *  node_description implementation
@@ -944,6 +1056,11 @@ void discrete_device::device_start()
 	if (getenv("DISCRETE_PROFILING"))
 		m_profiling = atoi(getenv("DISCRETE_PROFILING"));
 
+	/* fold constant nodes unless disabled */
+	m_compile = 1;
+	if (getenv("DISCRETE_COMPILE"))
+		m_compile = atoi(getenv("DISCRETE_COMPILE"));
+
 	/* Build the final block list */
 	sound_block_list_t block_list;
 	discrete_build_list(intf_start, block_list);
@@ -975,6 +1092,13 @@ void discrete_device::device_start()
 		(*node)->start();
 	}
 
+	/* fold constant nodes out of the step lists */
+	m_folded_list.clear();
+	m_static_node = NULL;
+	m_static_inputs = 0;
+	if (m_compile)
+		compile_nodes();
+
 	/* Now set up tasks */
 	for_each(discrete_task **, task, &task_list)
 	{
@@ -1038,9 +1162,31 @@ void discrete_device::device_reset()
 
 	update_to_current_time();
 
-	/* loop over all nodes */
+	/* constants and folded nodes first; the others read them as static inputs at reset */
+	if (m_static_node != NULL)
+	{
+		for_each (discrete_base_node **, node, &m_node_list)
+			if (is_static_node(*node))
+			{
+				(*node)->m_output[0] = 0;
+				(*node)->reset();
+			}
+
+		/* evaluate the folded nodes once; their outputs never change after this */
+		for_each(discrete_base_node **, node, &m_folded_list)
+		{
+			discrete_step_interface *step;
+			if ((*node)->interface(step))
+				step->step();
+		}
+	}
+
+	/* loop over all other nodes */
 	for_each (discrete_base_node **, node, &m_node_list)
 	{
+		if (m_static_node != NULL && is_static_node(*node))
+			continue;
+
 		/* Fimxe : node_level */
 		(*node)->m_output[0] = 0;
 
@@ -4243,6 +4243,8 @@ public:
 	virtual ~discrete_step_interface() { }
 
 	virtual void step(void) = 0;
+	/* true if step() depends on nothing but the inputs, so it can be folded when they are constant */
+	virtual bool is_stateless(void) { return false; }
 	osd_ticks_t			run_time;
 	discrete_base_node *	self;
 };
@@ -4389,6 +4391,8 @@ private:
 	void discrete_sanity_check(const sound_block_list_t &block_list);
 	void display_profiling(void);
 	void init_nodes(const sound_block_list_t &block_list);
+	void compile_nodes(void);
+	int is_static_node(discrete_base_node *node);
 
 	/* internal node tracking */
 	discrete_base_node **	m_indexed_node;
@@ -4396,6 +4400,12 @@ private:
 	/* tasks */
 	task_list_t				task_list;		/* discrete_task_context * */
 
+	/* nodes folded into constants by compile_nodes, in evaluation order */
+	int						m_compile;
+	node_list_t				m_folded_list;
+	UINT8 *					m_static_node;		/* by node index: constant or folded */
+	int						m_static_inputs;	/* node inputs made static by compile_nodes */
+
 	/* debugging statistics */
 	FILE *					m_disclogfile;
 
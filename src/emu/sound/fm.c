@@ -124,6 +124,15 @@
 #define BUILD_OPN (BUILD_YM2203||BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
 #define BUILD_OPN_PRESCALER (BUILD_YM2203||BUILD_YM2608)
 
+/* chip allocation; FM_EMU builds have no machine to allocate from */
+#ifndef FM_EMU
+#define FM_ALLOC(device, type)	auto_alloc_clear((device)->machine, type)
+#define FM_FREE(device, ptr)	auto_free((device)->machine, ptr)
+#else
+#define FM_ALLOC(device, type)	global_alloc_clear(type)
+#define FM_FREE(device, ptr)	global_free(ptr)
+#endif
+
 
 /* globals */
 #define TYPE_SSG    0x01    /* SSG support          */
@@ -1679,7 +1688,7 @@ INLINE void CSMKeyControll(UINT8 type, FM_CH *CH)
 	}
 }
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 /* FM channel save , internal state only */
 static void FMsave_state_channel(device_t *device,FM_CH *CH,int num_ch)
 {
@@ -2208,7 +2217,7 @@ void ym2203_reset_chip(void *chip)
 	for(i = 0x26 ; i >= 0x20 ; i-- ) OPNWriteReg(OPN,i,0);
 }
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 void ym2203_postload(void *chip)
 {
 	if (chip)
@@ -2264,11 +2273,11 @@ void * ym2203_init(void *param, device_t *device, int clock, int rate,
 	YM2203 *F2203;
 
 	/* allocate ym2203 state space */
-	F2203 = auto_alloc_clear(device->machine, YM2203);
+	F2203 = FM_ALLOC(device, YM2203);
 
 	if( !init_tables() )
 	{
-		auto_free( device->machine, F2203 );
+		FM_FREE(device, F2203);
 		return NULL;
 	}
 
@@ -2283,7 +2292,7 @@ void * ym2203_init(void *param, device_t *device, int clock, int rate,
 	F2203->OPN.ST.IRQ_Handler   = IRQHandler;
 	F2203->OPN.ST.SSG           = ssg;
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 	YM2203_save_state(F2203, device);
 #endif
 	return F2203;
@@ -2295,7 +2304,7 @@ void ym2203_shutdown(void *chip)
 	YM2203 *FM2203 = (YM2203 *)chip;
 
 	FMCloseTable();
-	auto_free(FM2203->OPN.ST.device->machine, FM2203);
+	FM_FREE(FM2203->OPN.ST.device, FM2203);
 }
 
 /* YM2203 I/O interface */
@@ -2650,7 +2659,7 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 	}
 }
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 /* FM channel save , internal state only */
 static void FMsave_state_adpcma(device_t *device,ADPCM_CH *adpcm)
 {
@@ -3405,7 +3414,7 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 	FM_STATUS_SET(&OPN->ST, 0);
 
 }
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 void ym2608_postload(void *chip)
 {
 	if (chip)
@@ -3487,11 +3496,11 @@ void * ym2608_init(void *param, device_t *device, int clock, int rate,
 	YM2608 *F2608;
 
 	/* allocate extend state space */
-	F2608 = auto_alloc_clear(device->machine, YM2608);
+	F2608 = FM_ALLOC(device, YM2608);
 	/* allocate total level table (128kb space) */
 	if( !init_tables() )
 	{
-		auto_free( device->machine, F2608 );
+		FM_FREE(device, F2608);
 		return NULL;
 	}
 
@@ -3527,7 +3536,7 @@ void * ym2608_init(void *param, device_t *device, int clock, int rate,
 
 	Init_ADPCMATable();
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 	YM2608_save_state(F2608, device);
 #endif
 	return F2608;
@@ -3539,7 +3548,7 @@ void ym2608_shutdown(void *chip)
 	YM2608 *F2608 = (YM2608 *)chip;
 
 	FMCloseTable();
-	auto_free(F2608->OPN.ST.device->machine, F2608);
+	FM_FREE(F2608->OPN.ST.device, F2608);
 }
 
 /* reset one of chips */
@@ -4083,7 +4092,7 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length)
 #endif /* BUILD_YM2610B */
 
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 void ym2610_postload(void *chip)
 {
 	if (chip)
@@ -4170,11 +4179,11 @@ void *ym2610_init(void *param, device_t *device, int clock, int rate,
 	YM2610 *F2610;
 
 	/* allocate extend state space */
-	F2610 = auto_alloc_clear(device->machine, YM2610);
+	F2610 = FM_ALLOC(device, YM2610);
 	/* allocate total level table (128kb space) */
 	if( !init_tables() )
 	{
-		auto_free( device->machine, F2610 );
+		FM_FREE(device, F2610);
 		return NULL;
 	}
 
@@ -4202,7 +4211,7 @@ void *ym2610_init(void *param, device_t *device, int clock, int rate,
 	F2610->deltaT.status_change_EOS_bit = 0x80;	/* status flag: set bit7 on End Of Sample */
 
 	Init_ADPCMATable();
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 	YM2610_save_state(F2610, device);
 #endif
 	return F2610;
@@ -4214,7 +4223,7 @@ void ym2610_shutdown(void *chip)
 	YM2610 *F2610 = (YM2610 *)chip;
 
 	FMCloseTable();
-	auto_free(F2610->OPN.ST.device->machine, F2610);
+	FM_FREE(F2610->OPN.ST.device, F2610);
 }
 
 /* reset one of chip */
@@ -4225,6 +4234,7 @@ void ym2610_reset_chip(void *chip)
 	FM_OPN *OPN   = &F2610->OPN;
 	YM_DELTAT *DELTAT = &F2610->deltaT;
 
+#ifndef FM_EMU
 	astring name;
 	device_t* dev = F2610->OPN.ST.device;
 
@@ -4241,6 +4251,7 @@ void ym2610_reset_chip(void *chip)
 	}
 	else
 		F2610->deltaT.memory_size = dev->machine->region(name)->bytes();
+#endif
 
 	/* Reset Prescaler */
 	OPNSetPres( OPN, 6*24, 6*24, 4*2); /* OPN 1/6 , SSG 1/4 */
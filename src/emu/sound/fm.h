@@ -24,7 +24,13 @@
 
 /* --- speedup optimize --- */
 /* busy flag enulation , The definition of FM_GET_TIME_NOW() is necessary. */
+#ifndef FM_EMU
 #define FM_BUSY_FLAG_SUPPORT 1
+#else
+/* FM_EMU builds the cores outside of a running machine (soundbench), */
+/* so there is no machine time to measure the busy period against     */
+#define FM_BUSY_FLAG_SUPPORT 0
+#endif
 
 /* --- external SSG(YM2149/AY-3-8910)emulator interface port */
 /* used by YM2203,YM2608,and YM2610 */
@@ -38,6 +44,7 @@ struct _ssg_callbacks
 };
 
 /* --- external callback funstions for realtime update --- */
+/* (FM_EMU builds render straight through and have no stream to update) */
 
 #if FM_BUSY_FLAG_SUPPORT
 #define TIME_TYPE					attotime
@@ -51,25 +58,41 @@ struct _ssg_callbacks
 #if BUILD_YM2203
   /* in 2203intf.c */
   void ym2203_update_request(void *param);
+#ifndef FM_EMU
   #define ym2203_update_req(chip) ym2203_update_request(chip)
+#else
+  #define ym2203_update_req(chip)
+#endif
 #endif /* BUILD_YM2203 */
 
 #if BUILD_YM2608
   /* in 2608intf.c */
   void ym2608_update_request(void *param);
+#ifndef FM_EMU
   #define ym2608_update_req(chip) ym2608_update_request(chip);
+#else
+  #define ym2608_update_req(chip)
+#endif
 #endif /* BUILD_YM2608 */
 
 #if (BUILD_YM2610||BUILD_YM2610B)
   /* in 2610intf.c */
   void ym2610_update_request(void *param);
+#ifndef FM_EMU
   #define ym2610_update_req(chip) ym2610_update_request(chip);
+#else
+  #define ym2610_update_req(chip)
+#endif
 #endif /* (BUILD_YM2610||BUILD_YM2610B) */
 
 #if (BUILD_YM2612||BUILD_YM3438)
   /* in 2612intf.c */
   void ym2612_update_request(void *param);
+#ifndef FM_EMU
   #define ym2612_update_req(chip) ym2612_update_request(chip);
+#else
+  #define ym2612_update_req(chip)
+#endif
 #endif /* (BUILD_YM2612||BUILD_YM3438) */
 
 /* compiler dependence */
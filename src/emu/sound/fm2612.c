@@ -135,6 +135,15 @@
 #define BUILD_OPN (BUILD_YM2203||BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B||BUILD_YM2612||BUILD_YM3438)
 #define BUILD_OPN_PRESCALER (BUILD_YM2203||BUILD_YM2608)
 
+/* chip allocation; FM_EMU builds have no machine to allocate from */
+#ifndef FM_EMU
+#define FM_ALLOC(device, type)	auto_alloc_clear((device)->machine, type)
+#define FM_FREE(device, ptr)	auto_free((device)->machine, ptr)
+#else
+#define FM_ALLOC(device, type)	global_alloc_clear(type)
+#define FM_FREE(device, ptr)	global_free(ptr)
+#endif
+
 
 /* globals */
 #define TYPE_SSG    0x01    /* SSG support          */
@@ -1682,7 +1691,7 @@ INLINE void CSMKeyControll(FM_OPN *OPN, FM_CH *CH)
 	OPN->SL3.key_csm = 1;
 }
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 /* FM channel save , internal state only */
 static void FMsave_state_channel(device_t *device,FM_CH *CH,int num_ch)
 {
@@ -2317,7 +2326,7 @@ void ym2612_update_one(void *chip, FMSAMPLE **buffer, int length)
 	INTERNAL_TIMER_B(&OPN->ST,length)
 }
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 void ym2612_postload(void *chip)
 {
 	if (chip)
@@ -2369,7 +2378,7 @@ void * ym2612_init(void *param, device_t *device, int clock, int rate,
 	YM2612 *F2612;
 
 	/* allocate extend state space */
-	F2612 = auto_alloc_clear(device->machine, YM2612);
+	F2612 = FM_ALLOC(device, YM2612);
 	/* allocate total level table (128kb space) */
 	init_tables();
 
@@ -2385,7 +2394,7 @@ void * ym2612_init(void *param, device_t *device, int clock, int rate,
 	F2612->OPN.ST.timer_handler = timer_handler;
 	F2612->OPN.ST.IRQ_Handler   = IRQHandler;
 
-#ifdef __STATE_H__
+#if defined(__STATE_H__) && !defined(FM_EMU)
 	YM2612_save_state(F2612, device);
 #endif
 	return F2612;
@@ -2397,7 +2406,7 @@ void ym2612_shutdown(void *chip)
 	YM2612 *F2612 = (YM2612 *)chip;
 
 	FMCloseTable();
-	auto_free(F2612->OPN.ST.device->machine, F2612);
+	FM_FREE(F2612->OPN.ST.device, F2612);
 }
 
 /* reset one of chip */
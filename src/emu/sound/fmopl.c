@@ -1812,6 +1812,9 @@ static void OPLResetChip(FM_OPL *OPL)
 }
 
 
+/* FM_EMU builds the core outside of a running machine (soundbench): */
+/* the chip comes from the global pool and has no save state         */
+#ifndef FM_EMU
 static STATE_POSTLOAD( OPL_postload )
 {
 	FM_OPL *OPL = (FM_OPL *)param;
@@ -1959,6 +1962,11 @@ static void OPL_save_state(FM_OPL *OPL, device_t *device)
 
 	device->machine->state().register_postload(OPL_postload, OPL);
 }
+#else
+static void OPL_save_state(FM_OPL *OPL, device_t *device)
+{
+}
+#endif
 
 
 /* Create one of virtual YM3812/YM3526/Y8950 */
@@ -1980,7 +1988,11 @@ static FM_OPL *OPLCreate(device_t *device, UINT32 clock, UINT32 rate, int type)
 #endif
 
 	/* allocate memory block */
+#ifndef FM_EMU
 	ptr = (char *)auto_alloc_array_clear(device->machine, UINT8, state_size);
+#else
+	ptr = (char *)global_alloc_array_clear(UINT8, state_size);
+#endif
 
 	OPL  = (FM_OPL *)ptr;
 
@@ -2009,7 +2021,11 @@ static FM_OPL *OPLCreate(device_t *device, UINT32 clock, UINT32 rate, int type)
 static void OPLDestroy(FM_OPL *OPL)
 {
 	OPL_UnLockTable();
+#ifndef FM_EMU
 	auto_free(OPL->device->machine, OPL);
+#else
+	global_free(OPL);
+#endif
 }
 
 /* Optional handlers */
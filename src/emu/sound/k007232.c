@@ -457,6 +457,7 @@ DEVICE_GET_INFO( k007232 )
 	{
 		/* --- the following bits of info are returned as 64-bit signed integers --- */
 		case DEVINFO_INT_TOKEN_BYTES:					info->i = sizeof(KDAC_A_PCM);				break;
+		case DEVINFO_INT_ROM_ON_DEMAND:					info->i = 1;								break;
 
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case DEVINFO_FCT_START:							info->start = DEVICE_START_NAME( k007232 );		break;
@@ -31,34 +31,6 @@ void oki_adpcm_state::reset()
 }
 
 
-//-------------------------------------------------
-//  device_clock_changed - called if the clock
-//  changes
-//-------------------------------------------------
-
-INT16 oki_adpcm_state::clock(UINT8 nibble)
-{
-	// update the signal
-	m_signal += s_diff_lookup[m_step * 16 + (nibble & 15)];
-
-	// clamp to the maximum
-	if (m_signal > 2047)
-		m_signal = 2047;
-	else if (m_signal < -2048)
-		m_signal = -2048;
-
-	// adjust the step size and clamp
-	m_step += s_index_shift[nibble & 7];
-	if (m_step > 48)
-		m_step = 48;
-	else if (m_step < 0)
-		m_step = 0;
-
-	// return the signal
-	return m_signal;
-}
-
-
 //-------------------------------------------------
 //  compute_tables - precompute tables for faster
 //  sound generation
@@ -59,4 +59,38 @@ private:
 };
 
 
+
+//**************************************************************************
+//  INLINE FUNCTIONS
+//**************************************************************************
+
+//-------------------------------------------------
+//  clock - decode one nibble and return the new
+//  signal; inline so that per-voice decode loops
+//  don't pay for a call per sample
+//-------------------------------------------------
+
+inline INT16 oki_adpcm_state::clock(UINT8 nibble)
+{
+	// update the signal
+	m_signal += s_diff_lookup[m_step * 16 + (nibble & 15)];
+
+	// clamp to the maximum
+	if (m_signal > 2047)
+		m_signal = 2047;
+	else if (m_signal < -2048)
+		m_signal = -2048;
+
+	// adjust the step size and clamp
+	m_step += s_index_shift[nibble & 7];
+	if (m_step > 48)
+		m_step = 48;
+	else if (m_step < 0)
+		m_step = 0;
+
+	// return the signal
+	return m_signal;
+}
+
+
 #endif // __OKIADPCM_H__
@@ -37,6 +37,7 @@
 
 #include "emu.h"
 #include "okim6295.h"
+#include "sampvoice.h"
 
 
 //**************************************************************************
@@ -46,11 +47,6 @@
 // devices
 const device_type OKIM6295 = okim6295_device_config::static_alloc_device_config;
 
-// ADPCM state and tables
-bool adpcm_state::s_tables_computed = false;
-const INT8 adpcm_state::s_index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
-int adpcm_state::s_diff_lookup[49*16];
-
 // volume lookup table. The manual lists only 9 steps, ~3dB per step. Given the dB values,
 // that seems to map to a 5-bit volume control. Any volume parameter beyond the 9th index
 // results in silent playback.
@@ -437,105 +433,29 @@ void okim6295_device::okim_voice::generate_adpcm(direct_read_data &direct, strea
 		return;
 
 	// loop while we still have samples to generate
-	while (samples-- != 0)
+	while (samples != 0)
 	{
-		// fetch the next sample byte
-		int nibble = direct.read_raw_byte(m_base_offset + m_sample / 2) >> (((m_sample & 1) << 2) ^ 4);
+		INT32 decoded[SAMPVOICE_BLOCK_SAMPLES];
+		UINT32 remaining = (m_sample < m_count) ? m_count - m_sample : 1;
+		int count = MIN(samples, SAMPVOICE_BLOCK_SAMPLES);
+		if (count > (int)remaining)
+			count = remaining;
+
+		// decode a block of nibbles
+		for (int sampnum = 0; sampnum < count; sampnum++, m_sample++)
+			decoded[sampnum] = m_adpcm.clock(direct.read_raw_byte(m_base_offset + m_sample / 2) >> (((m_sample & 1) << 2) ^ 4));
 
 		// output to the buffer, scaling by the volume
 		// signal in range -2048..2047, volume in range 2..32 => signal * volume / 2 in range -32768..32767
-		*buffer++ += m_adpcm.clock(nibble) * m_volume / 2;
+		sampvoice_mix_mono(buffer, decoded, m_volume, 1, count);
+		buffer += count;
+		samples -= count;
 
 		// next!
-		if (++m_sample >= m_count)
+		if (m_sample >= m_count)
 		{
 			m_playing = false;
 			break;
 		}
 	}
 }
-
-
-
-//**************************************************************************
-//  ADPCM STATE HELPER
-//**************************************************************************
-
-//-------------------------------------------------
-//  reset - reset the ADPCM state
-//-------------------------------------------------
-
-void adpcm_state::reset()
-{
-	// reset the signal/step
-	m_signal = -2;
-	m_step = 0;
-}
-
-
-//-------------------------------------------------
-//  device_clock_changed - called if the clock
-//  changes
-//-------------------------------------------------
-
-INT16 adpcm_state::clock(UINT8 nibble)
-{
-	// update the signal
-	m_signal += s_diff_lookup[m_step * 16 + (nibble & 15)];
-
-	// clamp to the maximum
-	if (m_signal > 2047)
-		m_signal = 2047;
-	else if (m_signal < -2048)
-		m_signal = -2048;
-
-	// adjust the step size and clamp
-	m_step += s_index_shift[nibble & 7];
-	if (m_step > 48)
-		m_step = 48;
-	else if (m_step < 0)
-		m_step = 0;
-
-	// return the signal
-	return m_signal;
-}
-
-
-//-------------------------------------------------
-//  compute_tables - precompute tables for faster
-//  sound generation
-//-------------------------------------------------
-
-void adpcm_state::compute_tables()
-{
-	// skip if we already did it
-	if (s_tables_computed)
-		return;
-	s_tables_computed = true;
-
-	// nibble to bit map
-	static const INT8 nbl2bit[16][4] =
-	{
-		{ 1, 0, 0, 0}, { 1, 0, 0, 1}, { 1, 0, 1, 0}, { 1, 0, 1, 1},
-		{ 1, 1, 0, 0}, { 1, 1, 0, 1}, { 1, 1, 1, 0}, { 1, 1, 1, 1},
-		{-1, 0, 0, 0}, {-1, 0, 0, 1}, {-1, 0, 1, 0}, {-1, 0, 1, 1},
-		{-1, 1, 0, 0}, {-1, 1, 0, 1}, {-1, 1, 1, 0}, {-1, 1, 1, 1}
-	};
-
-	// loop over all possible steps
-	for (int step = 0; step <= 48; step++)
-	{
-		// compute the step value
-		int stepval = floor(16.0 * pow(11.0 / 10.0, (double)step));
-
-		// loop over all nibbles and compute the difference
-		for (int nib = 0; nib < 16; nib++)
-		{
-			s_diff_lookup[step*16 + nib] = nbl2bit[nib][0] *
-				(stepval   * nbl2bit[nib][1] +
-				 stepval/2 * nbl2bit[nib][2] +
-				 stepval/4 * nbl2bit[nib][3] +
-				 stepval/8);
-		}
-	}
-}
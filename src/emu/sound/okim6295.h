@@ -11,6 +11,8 @@
 #ifndef __OKIM6295_H__
 #define __OKIM6295_H__
 
+#include "okiadpcm.h"
+
 
 
 
@@ -51,24 +53,8 @@ enum
 // ======================> adpcm_state
 
 // Internal ADPCM state, used by external ADPCM generators with compatible specs to the OKIM 6295.
-class adpcm_state
-{
-public:
-	adpcm_state() { compute_tables(); reset(); }
-
-	void reset();
-	INT16 clock(UINT8 nibble);
-
-	INT32	m_signal;
-	INT32	m_step;
-
-private:
-	static const INT8 s_index_shift[8];
-	static int s_diff_lookup[49*16];
-
-	static void compute_tables();
-	static bool s_tables_computed;
-};
+// This is the shared OKI decoder; the old name is kept for the drivers that use it directly.
+typedef oki_adpcm_state adpcm_state;
 
 
 
@@ -95,6 +81,9 @@ protected:
 	// device_config overrides
 	virtual const address_space_config *memory_space_config(int spacenum = 0) const;
 
+	// device_config_sound_interface overrides
+	virtual bool sound_rom_on_demand() const { return true; }
+
 	// internal state
 	const address_space_config  m_space_config;
 
@@ -0,0 +1,73 @@
+/***************************************************************************
+
+    sampvoice.h
+
+    Shared sample-voice helpers for the PCM/ADPCM sample players. A voice
+    first decodes up to SAMPVOICE_BLOCK_SAMPLES samples of ROM data into a
+    scratch buffer (this part is inherently serial: ADPCM state and loop
+    points depend on the previous sample), then hands the block to one of
+    the kernels below to apply volume/pan and accumulate it into the
+    stream outputs. The kernels are plain loops; hand-written SSE2
+    versions of them measured no faster.
+
+    mixbench checks the voice loops of the chips using these against
+    the per-sample loops they had before, and times both.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __SAMPVOICE_H__
+#define __SAMPVOICE_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* size of the per-voice scratch buffer; small enough to live on the stack */
+#define SAMPVOICE_BLOCK_SAMPLES		128
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    sampvoice_mix_mono - dest +=
+    src * gain / (1 << shift), with the division
+    rounding toward zero as C does
+-------------------------------------------------*/
+
+INLINE void sampvoice_mix_mono(INT32 *dest, const INT32 *src, INT32 gain, int shift, int count)
+{
+	INT32 bias = (1 << shift) - 1;
+	while (count--)
+	{
+		INT32 prod = *src++ * gain;
+		*dest++ += (prod + ((prod >> 31) & bias)) >> shift;
+	}
+}
+
+
+/*-------------------------------------------------
+    sampvoice_mix_stereo - left +=
+    src * lgain, right += src * rgain
+-------------------------------------------------*/
+
+INLINE void sampvoice_mix_stereo(INT32 *left, INT32 *right, const INT32 *src, INT32 lgain, INT32 rgain, int count)
+{
+	while (count--)
+	{
+		INT32 samp = *src++;
+		*left++ += samp * lgain;
+		*right++ += samp * rgain;
+	}
+}
+
+
+#endif /* __SAMPVOICE_H__ */
@@ -904,6 +904,7 @@ static void SCSP_w16(scsp_state *scsp,unsigned int addr,unsigned short val)
 		else if(addr<0xC00)
 		{
 			*((unsigned short *) (scsp->DSP.MPRO+(addr-0x800)/2))=val;
+			scsp->DSP.Dirty=1;
 
 			if(addr==0xBF0)
 			{
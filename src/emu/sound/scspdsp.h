@@ -3,6 +3,21 @@
 #ifndef __SCSPDSP_H__
 #define __SCSPDSP_H__
 
+//a microprogram step decoded by SCSPDSP_Compile
+struct _SCSPDSP_OP
+{
+	UINT32 Flags;	//SCSPDSP_OP_xxx
+	UINT8 TRA;
+	UINT8 TWA;
+	UINT8 IRA;	//MEMS or MIXS index, depending on the input flags
+	UINT8 IWA;
+	UINT8 YSEL;
+	UINT8 SHIFT;
+	UINT8 EWA;
+	UINT8 COEF;
+	UINT8 MASA;
+};
+
 //the DSP Context
 struct _SCSPDSP
 {
@@ -30,11 +45,18 @@ struct _SCSPDSP
 
 	int Stopped;
 	int LastStep;
+
+//compiled program
+	int Dirty;	//MPRO written since the last compile
+	int ProgramLength;
+	int Halt;	//program ends on an invalid IRA: skip the end of sample work
+	struct _SCSPDSP_OP Program[128];
 };
 
 void SCSPDSP_Init(struct _SCSPDSP *DSP);
 void SCSPDSP_SetSample(struct _SCSPDSP *DSP, INT32 sample, INT32 SEL, INT32 MXL);
 void SCSPDSP_Step(struct _SCSPDSP *DSP);
 void SCSPDSP_Start(struct _SCSPDSP *DSP);
+void SCSPDSP_Compile(struct _SCSPDSP *DSP);
 
 #endif /* __SCSPDSP_H__ */
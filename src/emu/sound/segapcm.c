@@ -4,6 +4,7 @@
 
 #include "emu.h"
 #include "segapcm.h"
+#include "sampvoice.h"
 
 typedef struct _segapcm_state segapcm_state;
 struct _segapcm_state
@@ -69,29 +70,33 @@ static STREAM_UPDATE( SEGAPCM_update )
 			UINT8 end = regs[6] + 1;
 			int i;
 
-			/* loop over samples on this channel */
-			for (i = 0; i < samples; i++)
+			/* loop over samples on this channel a block at a time */
+			for (i = 0; i < samples && !(regs[0x86] & 1); )
 			{
-				INT8 v = 0;
+				INT32 pcm[SAMPVOICE_BLOCK_SAMPLES];
+				int count, blocksize = MIN(samples - i, SAMPVOICE_BLOCK_SAMPLES);
 
-				/* handle looping if we've hit the end */
-				if ((addr >> 16) == end)
+				for (count = 0; count < blocksize; count++)
 				{
-					if (regs[0x86] & 2)
+					/* handle looping if we've hit the end */
+					if ((addr >> 16) == end)
 					{
-						regs[0x86] |= 1;
-						break;
+						if (regs[0x86] & 2)
+						{
+							regs[0x86] |= 1;
+							break;
+						}
+						else addr = loop;
 					}
-					else addr = loop;
-				}
 
-				/* fetch the sample */
-				v = rom[(addr >> 8) & rgnmask] - 0x80;
+					/* fetch the sample and advance */
+					pcm[count] = (INT8)(rom[(addr >> 8) & rgnmask] - 0x80);
+					addr = (addr + regs[7]) & 0xffffff;
+				}
 
-				/* apply panning and advance */
-				outputs[0][i] += v * regs[2];
-				outputs[1][i] += v * regs[3];
-				addr = (addr + regs[7]) & 0xffffff;
+				/* apply panning */
+				sampvoice_mix_stereo(&outputs[0][i], &outputs[1][i], pcm, regs[2], regs[3], count);
+				i += count;
 			}
 
 			/* store back the updated address */
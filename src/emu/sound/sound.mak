@@ -356,7 +356,7 @@ endif
 # OKI ADPCM sample players
 #-------------------------------------------------
 
-ifneq ($(filter OKIM6258 OKIM9810,$(SOUNDS)),)
+ifneq ($(filter OKIM6258 OKIM6295 OKIM9810,$(SOUNDS)),)
 SOUNDOBJS += $(SOUNDOBJ)/okiadpcm.o
 endif
 
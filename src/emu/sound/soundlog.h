@@ -0,0 +1,104 @@
+/***************************************************************************
+
+    soundlog.h
+
+    File format of the sound chip register write logs recorded with
+    -soundlog and replayed by the soundbench tool.
+
+    A log starts with an 8-byte magic string and a 32-bit version, and
+    is followed by a sequence of records, each starting with a type byte.
+    All multi-byte values are little-endian.
+
+    DEVICE records name a chip the first time it is written:
+
+        0   type (SOUNDLOG_RECORD_DEVICE)
+        1   device index, referenced by later records
+        2   length of the device name
+        3   length of the device tag
+        4   device clock (32 bits)
+        8   device name, then device tag (not NUL-terminated)
+
+    WRITE records hold one call to the chip's write handler:
+
+        0   type (SOUNDLOG_RECORD_WRITE)
+        1   device index
+        2   data
+        3   (unused)
+        4   handler offset (32 bits)
+        8   emulated time, seconds (32 bits)
+        12  emulated time, attoseconds (64 bits)
+
+    A single END record carrying the emulated time at exit closes the
+    log; it uses the WRITE layout with device index, data and offset
+    all zero.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __SOUNDLOG_H__
+#define __SOUNDLOG_H__
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define SOUNDLOG_MAGIC				"MAMESLOG"
+#define SOUNDLOG_VERSION			1
+#define SOUNDLOG_HEADER_SIZE		12
+
+/* record types */
+#define SOUNDLOG_RECORD_DEVICE		0
+#define SOUNDLOG_RECORD_WRITE		1
+#define SOUNDLOG_RECORD_END			2
+
+/* fixed record sizes */
+#define SOUNDLOG_DEVICE_SIZE		8
+#define SOUNDLOG_WRITE_SIZE			20
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    soundlog_put_32/64 - store little-endian
+    values into a record
+-------------------------------------------------*/
+
+INLINE void soundlog_put_32(UINT8 *dest, UINT32 value)
+{
+	dest[0] = value;
+	dest[1] = value >> 8;
+	dest[2] = value >> 16;
+	dest[3] = value >> 24;
+}
+
+INLINE void soundlog_put_64(UINT8 *dest, UINT64 value)
+{
+	soundlog_put_32(&dest[0], (UINT32)value);
+	soundlog_put_32(&dest[4], (UINT32)(value >> 32));
+}
+
+
+/*-------------------------------------------------
+    soundlog_get_32/64 - fetch little-endian
+    values from a record
+-------------------------------------------------*/
+
+INLINE UINT32 soundlog_get_32(const UINT8 *src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | ((UINT32)src[3] << 24);
+}
+
+INLINE UINT64 soundlog_get_64(const UINT8 *src)
+{
+	return soundlog_get_32(&src[0]) | ((UINT64)soundlog_get_32(&src[4]) << 32);
+}
+
+#endif /* __SOUNDLOG_H__ */
@@ -752,6 +752,7 @@ DEVICE_GET_INFO( upd7759 )
 	{
 		/* --- the following bits of info are returned as 64-bit signed integers --- */
 		case DEVINFO_INT_TOKEN_BYTES:					info->i = sizeof(upd7759_state);			break;
+		case DEVINFO_INT_ROM_ON_DEMAND:					info->i = 1;								break;
 
 		/* --- the following bits of info are returned as pointers to data or functions --- */
 		case DEVINFO_FCT_START:							info->start = DEVICE_START_NAME( upd7759 );		break;
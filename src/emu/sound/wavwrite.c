@@ -1,24 +1,50 @@
 #include "osdcore.h"
+#include "flacenc.h"
 #include "sound/wavwrite.h"
 
+/* samples per channel in each buffered block; also the FLAC block size */
+#define WAV_BLOCK_SAMPLES	4096
+
+typedef struct _wav_block wav_block;
+struct _wav_block
+{
+	wav_block *next;
+	wav_file *wav;
+	int samples;
+	INT16 data[1];
+};
+
 struct _wav_file
 {
 	FILE *file;
 	UINT32 total_offs;
 	UINT32 data_offs;
+	int channels;
+
+	/* background writer; a NULL queue means writes go straight to disk */
+	osd_work_queue *queue;
+	osd_lock *lock;
+	wav_block *freelist;
+	wav_block *current;
+
+	/* FLAC encoder, run on the writer thread */
+	flac_encoder *flac;
+	UINT8 *flacbuf;
 };
 
 
-wav_file *wav_open(const char *filename, int sample_rate, int channels)
+static void write_wav_header(wav_file *wav, int sample_rate, int channels);
+
+static wav_file *create_file(const char *filename, int channels)
 {
 	wav_file *wav;
-	UINT32 bps, temp32;
-	UINT16 align, temp16;
 
 	/* allocate memory for the wav struct */
 	wav = (wav_file *) osd_malloc(sizeof(struct _wav_file));
 	if (!wav)
 		return NULL;
+	memset(wav, 0, sizeof(*wav));
+	wav->channels = channels;
 
 	/* create the file */
 	wav->file = fopen(filename, "wb");
@@ -27,6 +53,60 @@ wav_file *wav_open(const char *filename, int sample_rate, int channels)
 		osd_free(wav);
 		return NULL;
 	}
+	return wav;
+}
+
+
+wav_file *wav_open(const char *filename, int sample_rate, int channels)
+{
+	wav_file *wav = create_file(filename, channels);
+	if (!wav)
+		return NULL;
+
+	write_wav_header(wav, sample_rate, channels);
+	return wav;
+}
+
+
+wav_file *wav_open_stream(const char *filename, int sample_rate, int channels, UINT32 flags)
+{
+	wav_file *wav = create_file(filename, channels);
+	if (!wav)
+		return NULL;
+
+	/* a FLAC stream starts with its own header; it is rewritten with the totals on close */
+	if (flags & WAV_STREAM_FLAC)
+	{
+		wav->flac = flac_encoder_alloc(sample_rate, channels, WAV_BLOCK_SAMPLES);
+		if (wav->flac)
+			wav->flacbuf = (UINT8 *)osd_malloc(flac_encoder_max_frame_bytes(wav->flac));
+		if (!wav->flac || !wav->flacbuf)
+		{
+			wav_close(wav);
+			return NULL;
+		}
+		flac_encoder_header(wav->flac, wav->flacbuf);
+		fwrite(wav->flacbuf, 1, FLACENC_HEADER_BYTES, wav->file);
+	}
+	else
+		write_wav_header(wav, sample_rate, channels);
+
+	/* blocks are written from a single I/O thread, so they land in order */
+	wav->lock = osd_lock_alloc();
+	wav->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	if (!wav->lock || !wav->queue)
+	{
+		wav_close(wav);
+		return NULL;
+	}
+	return wav;
+}
+
+
+static void write_wav_header(wav_file *wav, int sample_rate, int channels)
+{
+	UINT32 bps, temp32;
+	UINT16 align, temp16;
 
 	/* write the 'RIFF' header */
 	fwrite("RIFF", 1, 4, wav->file);
@@ -80,28 +160,150 @@ wav_file *wav_open(const char *filename, int sample_rate, int channels)
 	wav->data_offs = ftell(wav->file);
 	fwrite(&temp32, 1, 4, wav->file);
 
-	return wav;
+}
+
+
+static wav_block *alloc_block(wav_file *wav)
+{
+	wav_block *block;
+
+	/* reuse a block the writer is done with, or grow the pool; never wait for the disk */
+	osd_lock_acquire(wav->lock);
+	block = wav->freelist;
+	if (block)
+		wav->freelist = block->next;
+	osd_lock_release(wav->lock);
+
+	if (!block)
+	{
+		block = (wav_block *)osd_malloc(sizeof(*block) + (WAV_BLOCK_SAMPLES * wav->channels - 1) * sizeof(block->data[0]));
+		if (!block)
+			return NULL;
+		block->wav = wav;
+	}
+	block->samples = 0;
+	return block;
+}
+
+
+static void *write_block(void *param, int threadid)
+{
+	wav_block *block = (wav_block *)param;
+	wav_file *wav = block->wav;
+
+	/* encode or just write */
+	if (wav->flac)
+	{
+		UINT32 bytes = flac_encoder_frame(wav->flac, block->data, block->samples / wav->channels, wav->flacbuf);
+		fwrite(wav->flacbuf, 1, bytes, wav->file);
+	}
+	else
+		fwrite(block->data, 2, block->samples, wav->file);
+
+	/* hand the block back */
+	osd_lock_acquire(wav->lock);
+	block->next = wav->freelist;
+	wav->freelist = block;
+	osd_lock_release(wav->lock);
+	return NULL;
+}
+
+
+static void queue_block(wav_file *wav)
+{
+	osd_work_item_queue(wav->queue, write_block, wav->current, WORK_ITEM_FLAG_AUTO_RELEASE);
+	wav->current = NULL;
+}
+
+
+static void add_samples(wav_file *wav, const INT16 *data, int samples)
+{
+	int capacity = WAV_BLOCK_SAMPLES * wav->channels;
+
+	/* unbuffered files just write and flush */
+	if (!wav->queue)
+	{
+		fwrite(data, 2, samples, wav->file);
+		fflush(wav->file);
+		return;
+	}
+
+	/* otherwise fill blocks and pass full ones to the writer */
+	while (samples > 0)
+	{
+		int chunk;
+
+		if (!wav->current)
+		{
+			wav->current = alloc_block(wav);
+			if (!wav->current)
+				return;
+		}
+		chunk = MIN(samples, capacity - wav->current->samples);
+		memcpy(&wav->current->data[wav->current->samples], data, chunk * sizeof(*data));
+		wav->current->samples += chunk;
+		data += chunk;
+		samples -= chunk;
+		if (wav->current->samples == capacity)
+			queue_block(wav);
+	}
 }
 
 
 void wav_close(wav_file *wav)
 {
-	UINT32 total = ftell(wav->file);
+	UINT32 total;
 	UINT32 temp32;
 
 	if (!wav) return;
 
-	/* update the total file size */
-	fseek(wav->file, wav->total_offs, SEEK_SET);
-	temp32 = total - (wav->total_offs + 4);
-	temp32 = LITTLE_ENDIANIZE_INT32(temp32);
-	fwrite(&temp32, 1, 4, wav->file);
+	/* let the writer finish everything that's buffered */
+	if (wav->queue)
+	{
+		if (wav->current && wav->current->samples > 0)
+			queue_block(wav);
+		while (!osd_work_queue_wait(wav->queue, osd_ticks_per_second())) ;
+		osd_work_queue_free(wav->queue);
+	}
+	if (wav->current)
+		osd_free(wav->current);
+	while (wav->freelist)
+	{
+		wav_block *block = wav->freelist;
+		wav->freelist = block->next;
+		osd_free(block);
+	}
+	if (wav->lock)
+		osd_lock_free(wav->lock);
 
-	/* update the data size */
-	fseek(wav->file, wav->data_offs, SEEK_SET);
-	temp32 = total - (wav->data_offs + 4);
-	temp32 = LITTLE_ENDIANIZE_INT32(temp32);
-	fwrite(&temp32, 1, 4, wav->file);
+	if (wav->flac)
+	{
+		/* rewrite the FLAC header now that the totals are known */
+		if (wav->flacbuf)
+		{
+			fseek(wav->file, 0, SEEK_SET);
+			flac_encoder_header(wav->flac, wav->flacbuf);
+			fwrite(wav->flacbuf, 1, FLACENC_HEADER_BYTES, wav->file);
+			osd_free(wav->flacbuf);
+		}
+		flac_encoder_free(wav->flac);
+	}
+	else
+	{
+		total = ftell(wav->file);
+
+		/* update the total file size */
+		fseek(wav->file, wav->total_offs, SEEK_SET);
+		temp32 = total - (wav->total_offs + 4);
+		temp32 = LITTLE_ENDIANIZE_INT32(temp32);
+		fwrite(&temp32, 1, 4, wav->file);
+
+		/* update the data size */
+		fseek(wav->file, wav->data_offs, SEEK_SET);
+		temp32 = total - (wav->data_offs + 4);
+		temp32 = LITTLE_ENDIANIZE_INT32(temp32);
+		fwrite(&temp32, 1, 4, wav->file);
+	}
 
 	fclose(wav->file);
 	osd_free(wav);
@@ -112,9 +314,8 @@ void wav_add_data_16(wav_file *wav, INT16 *data, int samples)
 {
 	if (!wav) return;
 
-	/* just write and flush the data */
-	fwrite(data, 2, samples, wav->file);
-	fflush(wav->file);
+	/* just write the data */
+	add_samples(wav, data, samples);
 }
 
 
@@ -137,9 +338,8 @@ void wav_add_data_32(wav_file *wav, INT32 *data, int samples, int shift)
 		temp[i] = (val < -32768) ? -32768 : (val > 32767) ? 32767 : val;
 	}
 
-	/* write and flush */
-	fwrite(temp, 2, samples, wav->file);
-	fflush(wav->file);
+	/* write */
+	add_samples(wav, temp, samples);
 
 	/* free memory */
 	osd_free(temp);
@@ -162,9 +362,8 @@ void wav_add_data_16lr(wav_file *wav, INT16 *left, INT16 *right, int samples)
 	for (i = 0; i < samples * 2; i++)
 		temp[i] = (i & 1) ? right[i / 2] : left[i / 2];
 
-	/* write and flush */
-	fwrite(temp, 4, samples, wav->file);
-	fflush(wav->file);
+	/* write */
+	add_samples(wav, temp, samples * 2);
 
 	/* free memory */
 	osd_free(temp);
@@ -191,9 +390,8 @@ void wav_add_data_32lr(wav_file *wav, INT32 *left, INT32 *right, int samples, in
 		temp[i] = (val < -32768) ? -32768 : (val > 32767) ? 32767 : val;
 	}
 
-	/* write and flush */
-	fwrite(temp, 4, samples, wav->file);
-	fflush(wav->file);
+	/* write */
+	add_samples(wav, temp, samples * 2);
 
 	/* free memory */
 	osd_free(temp);
@@ -5,7 +5,12 @@
 
 typedef struct _wav_file wav_file;
 
+/* wav_open_stream flags */
+#define WAV_STREAM_FLAC		0x01		/* write a FLAC stream instead of a WAV */
+
 wav_file *wav_open(const char *filename, int sample_rate, int channels);
+/* like wav_open, but samples are buffered and written (and encoded) on a background thread */
+wav_file *wav_open_stream(const char *filename, int sample_rate, int channels, UINT32 flags);
 void wav_close(wav_file*wavptr);
 
 void wav_add_data_16(wav_file *wavptr, INT16 *data, int samples);
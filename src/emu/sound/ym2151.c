@@ -11,6 +11,8 @@
 /* undef this to not use MAME timer system */
 #define USE_MAME_TIMERS
 
+/* FM_EMU builds the core outside of a running machine (soundbench): */
+/* the chip comes from the global pool and has no save state or timers */
 /*#define FM_EMU*/
 #ifdef FM_EMU
 	#ifdef USE_MAME_TIMERS
@@ -1377,7 +1379,7 @@ int ym2151_read_status( void *_chip )
 
 
 //#ifdef USE_MAME_TIMERS
-#if 1 // disabled for now due to crashing with winalloc.c (ERROR_NOT_ENOUGH_MEMORY)
+#ifndef FM_EMU	/* no save states outside of a running machine */
 /*
 *   state save support for MAME
 */
@@ -1509,7 +1511,11 @@ void * ym2151_init(device_t *device, int clock, int rate)
 {
 	YM2151 *PSG;
 
+#ifndef FM_EMU
 	PSG = auto_alloc(device->machine, YM2151);
+#else
+	PSG = global_alloc(YM2151);
+#endif
 
 	memset(PSG, 0, sizeof(YM2151));
 
@@ -1560,7 +1566,11 @@ void ym2151_shutdown(void *_chip)
 {
 	YM2151 *chip = (YM2151 *)_chip;
 
+#ifndef FM_EMU
 	auto_free (chip->device->machine, chip);
+#else
+	global_free (chip);
+#endif
 
 	if (cymfile)
 		fclose (cymfile);
@@ -2398,7 +2408,7 @@ void ym2151_update_one(void *chip, SAMP **buffers, int length)
 			{
 				int oldstate = PSG->status & 3;
 				PSG->status |= 2;
-				if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(chip->device, 1);
+				if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(PSG->device, 1);
 			}
 		}
 	}
@@ -2476,7 +2486,7 @@ void ym2151_update_one(void *chip, SAMP **buffers, int length)
 				{
 					int oldstate = PSG->status & 3;
 					PSG->status |= 1;
-					if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(chip->device, 1);
+					if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(PSG->device, 1);
 				}
 				if (PSG->irq_enable & 0x80)
 					PSG->csm_req = 2;	/* request KEY ON / KEY OFF sequence */
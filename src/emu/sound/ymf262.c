@@ -2341,7 +2341,12 @@ static OPL3 *OPL3Create(device_t *device, int clock, int rate, int type)
 	if (OPL3_LockTable(device) == -1) return NULL;
 
 	/* allocate memory block */
+#ifndef FM_EMU
 	chip = auto_alloc_clear(device->machine, OPL3);
+#else
+	/* FM_EMU builds have no machine to allocate from (soundbench) */
+	chip = global_alloc_clear(OPL3);
+#endif
 
 	chip->device = device;
 	chip->type  = type;
@@ -2360,7 +2365,11 @@ static OPL3 *OPL3Create(device_t *device, int clock, int rate, int type)
 static void OPL3Destroy(OPL3 *chip)
 {
 	OPL3_UnLockTable();
+#ifndef FM_EMU
 	auto_free(chip->device->machine, chip);
+#else
+	global_free(chip);
+#endif
 }
 
 
@@ -1319,15 +1319,15 @@ static void ymf271_write_fm(YMF271Chip *chip, int grp, int adr, int data)
 	}
 }
 
-static void ymf271_write_pcm(YMF271Chip *chip, int data)
+static void ymf271_write_pcm(YMF271Chip *chip, int reg, int data)
 {
 	int slotnum;
 	YMF271Slot *slot;
 
-	slotnum = pcm_tab[chip->pcmreg&0xf];
+	slotnum = pcm_tab[reg&0xf];
 	slot = &chip->slots[slotnum];
 
-	switch ((chip->pcmreg>>4)&0xf)
+	switch ((reg>>4)&0xf)
 	{
 		case 0:
 			slot->startaddr &= ~0xff;
@@ -1419,109 +1419,138 @@ static void ymf271_write_ext_memory(YMF271Chip *chip, UINT32 address, UINT8 data
 	devcb_call_write8(&chip->ext_mem_write, address, data);
 }
 
-static void ymf271_write_timer(YMF271Chip *chip, int data)
+static void ymf271_write_group(YMF271Chip *chip, int reg, int data)
 {
 	int slotnum;
 	YMF271Group *group;
-	attotime period;
 
-	slotnum = fm_tab[chip->timerreg & 0xf];
+	slotnum = fm_tab[reg & 0xf];
 	group = &chip->groups[slotnum];
 
-	if ((chip->timerreg & 0xf0) == 0)
-	{
-		group->sync = data & 0x3;
-		group->pfm = data >> 7;
-	}
-	else
+	group->sync = data & 0x3;
+	group->pfm = data >> 7;
+}
+
+static void ymf271_write_timer(YMF271Chip *chip, int data)
+{
+	attotime period;
+
+	switch (chip->timerreg)
 	{
-		switch (chip->timerreg)
-		{
-			case 0x10:
-				chip->timerA &= ~0xff;
-				chip->timerA |= data;
-				break;
+		case 0x10:
+			chip->timerA &= ~0xff;
+			chip->timerA |= data;
+			break;
 
-			case 0x11:
-				if (!(data & 0xfc))
+		case 0x11:
+			if (!(data & 0xfc))
+			{
+				chip->timerA &= 0x00ff;
+				if ((data & 0x3) != 0x3)
 				{
-					chip->timerA &= 0x00ff;
-					if ((data & 0x3) != 0x3)
-					{
-						chip->timerA |= (data & 0xff)<<8;
-					}
+					chip->timerA |= (data & 0xff)<<8;
 				}
-				break;
+			}
+			break;
 
-			case 0x12:
-				chip->timerB = data;
-				break;
+		case 0x12:
+			chip->timerB = data;
+			break;
 
-			case 0x13:
-				if (data & 1)
-				{	// timer A load
-					chip->timerAVal = chip->timerA;
-				}
-				if (data & 2)
-				{	// timer B load
-					chip->timerBVal = chip->timerB;
-				}
-				if (data & 4)
-				{
-					// timer A IRQ enable
-					chip->enable |= 4;
-				}
-				if (data & 8)
-				{
-					// timer B IRQ enable
-					chip->enable |= 8;
-				}
-				if (data & 0x10)
-				{	// timer A reset
-					chip->irqstate &= ~1;
-					chip->status &= ~1;
+		case 0x13:
+			if (data & 1)
+			{	// timer A load
+				chip->timerAVal = chip->timerA;
+			}
+			if (data & 2)
+			{	// timer B load
+				chip->timerBVal = chip->timerB;
+			}
+			if (data & 4)
+			{
+				// timer A IRQ enable
+				chip->enable |= 4;
+			}
+			if (data & 8)
+			{
+				// timer B IRQ enable
+				chip->enable |= 8;
+			}
+			if (data & 0x10)
+			{	// timer A reset
+				chip->irqstate &= ~1;
+				chip->status &= ~1;
 
-					if (chip->irq_callback) chip->irq_callback(chip->device, 0);
+				if (chip->irq_callback) chip->irq_callback(chip->device, 0);
 
-					//period = (double)(256.0 - chip->timerAVal ) * ( 384.0 * 4.0 / (double)CLOCK);
-					period = attotime::from_hz(chip->clock) * (384 * (1024 - chip->timerAVal));
+				//period = (double)(256.0 - chip->timerAVal ) * ( 384.0 * 4.0 / (double)CLOCK);
+				period = attotime::from_hz(chip->clock) * (384 * (1024 - chip->timerAVal));
 
-					chip->timA->adjust(period, 0, period);
-				}
-				if (data & 0x20)
-				{	// timer B reset
-					chip->irqstate &= ~2;
-					chip->status &= ~2;
+				chip->timA->adjust(period, 0, period);
+			}
+			if (data & 0x20)
+			{	// timer B reset
+				chip->irqstate &= ~2;
+				chip->status &= ~2;
 
-					if (chip->irq_callback) chip->irq_callback(chip->device, 0);
+				if (chip->irq_callback) chip->irq_callback(chip->device, 0);
 
-					period = attotime::from_hz(chip->clock) * (384 * 16 * (256 - chip->timerBVal));
+				period = attotime::from_hz(chip->clock) * (384 * 16 * (256 - chip->timerBVal));
 
-					chip->timB->adjust(period, 0, period);
-				}
+				chip->timB->adjust(period, 0, period);
+			}
 
-				break;
+			break;
 
-			case 0x14:
-				chip->ext_address &= ~0xff;
-				chip->ext_address |= data;
-				break;
-			case 0x15:
-				chip->ext_address &= ~0xff00;
-				chip->ext_address |= data << 8;
-				break;
-			case 0x16:
-				chip->ext_address &= ~0xff0000;
-				chip->ext_address |= (data & 0x7f) << 16;
-				chip->ext_read = (data & 0x80) ? 1 : 0;
-				if( !chip->ext_read )
-					chip->ext_address = (chip->ext_address + 1) & 0x7fffff;
-				break;
-			case 0x17:
-				ymf271_write_ext_memory( chip, chip->ext_address, data );
+		case 0x14:
+			chip->ext_address &= ~0xff;
+			chip->ext_address |= data;
+			break;
+		case 0x15:
+			chip->ext_address &= ~0xff00;
+			chip->ext_address |= data << 8;
+			break;
+		case 0x16:
+			chip->ext_address &= ~0xff0000;
+			chip->ext_address |= (data & 0x7f) << 16;
+			chip->ext_read = (data & 0x80) ? 1 : 0;
+			if( !chip->ext_read )
 				chip->ext_address = (chip->ext_address + 1) & 0x7fffff;
-				break;
-		}
+			break;
+		case 0x17:
+			ymf271_write_ext_memory( chip, chip->ext_address, data );
+			chip->ext_address = (chip->ext_address + 1) & 0x7fffff;
+			break;
+	}
+}
+
+/* the stream's write log carries the register latch in the low byte of the offset */
+enum
+{
+	LOG_FM = 0,		/* + group 0-3 */
+	LOG_PCM = 4,
+	LOG_GROUP = 5
+};
+
+static STREAM_WRITE( ymf271_stream_write )
+{
+	YMF271Chip *chip = (YMF271Chip *)param;
+	int reg = offset & 0xff;
+
+	switch (offset >> 8)
+	{
+		case LOG_FM + 0:
+		case LOG_FM + 1:
+		case LOG_FM + 2:
+		case LOG_FM + 3:
+			ymf271_write_fm(chip, offset >> 8, reg, data);
+			break;
+		case LOG_PCM:
+			ymf271_write_pcm(chip, reg, data);
+			break;
+		case LOG_GROUP:
+			ymf271_write_group(chip, reg, data);
+			break;
 	}
 }
 
@@ -1535,37 +1564,41 @@ WRITE8_DEVICE_HANDLER( ymf271_w )
 			chip->reg0 = data;
 			break;
 		case 1:
-			ymf271_write_fm(chip, 0, chip->reg0, data);
+			chip->stream->write(((LOG_FM + 0) << 8) | chip->reg0, data);
 			break;
 		case 2:
 			chip->reg1 = data;
 			break;
 		case 3:
-			ymf271_write_fm(chip, 1, chip->reg1, data);
+			chip->stream->write(((LOG_FM + 1) << 8) | chip->reg1, data);
 			break;
 		case 4:
 			chip->reg2 = data;
 			break;
 		case 5:
-			ymf271_write_fm(chip, 2, chip->reg2, data);
+			chip->stream->write(((LOG_FM + 2) << 8) | chip->reg2, data);
 			break;
 		case 6:
 			chip->reg3 = data;
 			break;
 		case 7:
-			ymf271_write_fm(chip, 3, chip->reg3, data);
+			chip->stream->write(((LOG_FM + 3) << 8) | chip->reg3, data);
 			break;
 		case 8:
 			chip->pcmreg = data;
 			break;
 		case 9:
-			ymf271_write_pcm(chip, data);
+			chip->stream->write((LOG_PCM << 8) | chip->pcmreg, data);
 			break;
 		case 0xc:
 			chip->timerreg = data;
 			break;
 		case 0xd:
-			ymf271_write_timer(chip, data);
+			/* group sync/PFM feeds synthesis; the timers stay on this thread */
+			if ((chip->timerreg & 0xf0) == 0)
+				chip->stream->write((LOG_GROUP << 8) | chip->timerreg, data);
+			else
+				ymf271_write_timer(chip, data);
 			break;
 	}
 }
@@ -1779,6 +1812,7 @@ static DEVICE_START( ymf271 )
 
 	ymf271_init(device, chip, *device->region(), intf->irq_callback, &intf->ext_read, &intf->ext_write);
 	chip->stream = device->machine->sound().stream_alloc(*device, 0, 2, device->clock()/384, chip, ymf271_update);
+	chip->stream->set_write_handler(ymf271_stream_write);
 
 	for (i = 0; i < 256; i++)
 	{
@@ -1801,6 +1835,9 @@ static DEVICE_RESET( ymf271 )
 	int i;
 	YMF271Chip *chip = get_safe_token(device);
 
+	/* take the slots back from the render thread */
+	chip->stream->update();
+
 	for (i = 0; i < 48; i++)
 	{
 		chip->slots[i].active = 0;
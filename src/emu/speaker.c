@@ -42,6 +42,7 @@
 #include "osdepend.h"
 #include "config.h"
 #include "profiler.h"
+#include "mixutil.h"
 #include "sound/wavwrite.h"
 
 
@@ -194,15 +195,10 @@ void speaker_device::sound_stream_update(sound_stream &stream, stream_sample_t *
 {
 	VPRINTF(("Mixer_update(%d)\n", samples));
 
-	// loop over samples
-	for (int pos = 0; pos < samples; pos++)
-	{
-		// add up all the inputs
-		INT32 sample = inputs[0][pos];
-		for (int inp = 1; inp < m_auto_allocated_inputs; inp++)
-			sample += inputs[inp][pos];
-		outputs[0][pos] = sample;
-	}
+	// add up all the inputs, one buffer at a time
+	memcpy(outputs[0], inputs[0], samples * sizeof(outputs[0][0]));
+	for (int inp = 1; inp < m_auto_allocated_inputs; inp++)
+		mix_add(outputs[0], inputs[inp], samples);
 }
 
 
@@ -250,20 +246,17 @@ void speaker_device::mix(INT32 *leftmix, INT32 *rightmix, int &samples_this_upda
 	{
 		// if the speaker is centered, send to both left and right
 		if (m_config.m_x == 0)
-			for (int sample = 0; sample < samples_this_update; sample++)
-			{
-				leftmix[sample] += stream_buf[sample];
-				rightmix[sample] += stream_buf[sample];
-			}
+		{
+			mix_add(leftmix, stream_buf, samples_this_update);
+			mix_add(rightmix, stream_buf, samples_this_update);
+		}
 
 		// if the speaker is to the left, send only to the left
 		else if (m_config.m_x < 0)
-			for (int sample = 0; sample < samples_this_update; sample++)
-				leftmix[sample] += stream_buf[sample];
+			mix_add(leftmix, stream_buf, samples_this_update);
 
 		// if the speaker is to the right, send only to the right
 		else
-			for (int sample = 0; sample < samples_this_update; sample++)
-				rightmix[sample] += stream_buf[sample];
+			mix_add(rightmix, stream_buf, samples_this_update);
 	}
 }
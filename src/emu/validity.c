@@ -10,10 +10,12 @@
 ***************************************************************************/
 
 #include "emu.h"
+#include "emuopts.h"
 #include "hash.h"
 #include "validity.h"
 
 #include <ctype.h>
+#include <zlib.h>
 
 
 /***************************************************************************
@@ -24,6 +26,17 @@
 
 
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* -faststart remembers each driver source this build has validated, one
+   "key <TAB> source file" line apiece */
+#define VALIDITY_CACHE_FILENAME		"validity.dat"
+#define VALIDITY_CACHE_HEADER		"# MAME validity cache v1"
+
+
+
 /***************************************************************************
     COMPILE-TIME VALIDATION
 ***************************************************************************/
@@ -310,13 +323,12 @@ static bool validate_inlines(void)
 
 
 /*-------------------------------------------------
-    validate_driver - validate basic driver
-    information
+    validate_driver_entry - validate the driver
+    entry itself and its place in the driver list
 -------------------------------------------------*/
 
-static bool validate_driver(const machine_config &config, game_driver_map &names, game_driver_map &descriptions)
+static bool validate_driver_entry(const game_driver &driver, game_driver_map &names, game_driver_map &descriptions)
 {
-	const game_driver &driver = config.gamedrv();
 	const game_driver *clone_of;
 	const char *compatible_with;
 	const game_driver *other_drv;
@@ -416,6 +428,20 @@ static bool validate_driver(const machine_config &config, game_driver_map &names
 		}
 	}
 
+	return error;
+}
+
+
+/*-------------------------------------------------
+    validate_driver - validate basic driver
+    information
+-------------------------------------------------*/
+
+static bool validate_driver(const machine_config &config, game_driver_map &names, game_driver_map &descriptions)
+{
+	const game_driver &driver = config.gamedrv();
+	bool error = validate_driver_entry(driver, names, descriptions);
+
 	/* make sure sound-less drivers are flagged */
 	const device_config_sound_interface *sound;
 	if ((driver.flags & GAME_IS_BIOS_ROOT) == 0 && !config.m_devicelist.first(sound) && (driver.flags & GAME_NO_SOUND) == 0 && (driver.flags & GAME_NO_SOUND_HW) == 0)
@@ -1118,6 +1144,109 @@ static bool validate_devices(const machine_config &config, const ioport_list &po
 }
 
 
+/*-------------------------------------------------
+    validity_cache_key - checksum the build and
+    the drivers of one source file, including
+    their ROM tables; the build stamp changes
+    with every link, so it covers the machine
+    configs, devices and ports behind them
+-------------------------------------------------*/
+
+static UINT32 validity_cache_key(const char *source_file)
+{
+	UINT32 key = crc32(0, (const Bytef *)build_version, strlen(build_version));
+	key = crc32(key, (const Bytef *)build_stamp, strlen(build_stamp));
+	key = crc32(key, (const Bytef *)source_file, strlen(source_file) + 1);
+
+	for (int drivnum = 0; drivers[drivnum] != NULL; drivnum++)
+	{
+		const game_driver *driver = drivers[drivnum];
+
+		if (strcmp(driver->source_file, source_file) != 0)
+			continue;
+		key = crc32(key, (const Bytef *)driver->name, strlen(driver->name) + 1);
+		if (driver->parent != NULL)
+			key = crc32(key, (const Bytef *)driver->parent, strlen(driver->parent) + 1);
+		key = crc32(key, (const Bytef *)driver->description, strlen(driver->description) + 1);
+		key = crc32(key, (const Bytef *)&driver->flags, sizeof(driver->flags));
+
+		if (driver->rom != NULL)
+			for (const rom_entry *rom = driver->rom; !ROMENTRY_ISEND(rom); rom++)
+			{
+				if (rom->_name != NULL)
+					key = crc32(key, (const Bytef *)rom->_name, strlen(rom->_name));
+				if (rom->_hashdata != NULL)
+					key = crc32(key, (const Bytef *)rom->_hashdata, strlen(rom->_hashdata));
+				/* the cache never leaves this machine, so native byte order will do */
+				key = crc32(key, (const Bytef *)&rom->_offset, sizeof(rom->_offset));
+				key = crc32(key, (const Bytef *)&rom->_length, sizeof(rom->_length));
+				key = crc32(key, (const Bytef *)&rom->_flags, sizeof(rom->_flags));
+			}
+	}
+	return key;
+}
+
+
+/*-------------------------------------------------
+    validity_cache_read - read the validity cache,
+    keeping the lines for other source files in
+    'others'; returns the key cached for the given
+    source file, or 0 if there is none
+-------------------------------------------------*/
+
+static UINT32 validity_cache_read(const char *filename, const char *source_file, astring &others)
+{
+	core_file *file;
+	char line[1024];
+	UINT32 result = 0;
+
+	others.reset();
+	if (core_fopen(filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return 0;
+
+	/* ignore files from other versions outright */
+	if (core_fgets(line, ARRAY_LENGTH(line), file) == NULL || strncmp(line, VALIDITY_CACHE_HEADER, strlen(VALIDITY_CACHE_HEADER)) != 0)
+	{
+		core_fclose(file);
+		return 0;
+	}
+
+	while (core_fgets(line, ARRAY_LENGTH(line), file) != NULL)
+	{
+		char *tab = strchr(line, '\t');
+		UINT32 key;
+
+		/* skip anything malformed */
+		line[strcspn(line, "\r\n")] = 0;
+		if (tab == NULL || sscanf(line, "%08X", &key) != 1)
+			continue;
+
+		if (strcmp(tab + 1, source_file) == 0)
+			result = key;
+		else
+			others.cat(line).cat("\n");
+	}
+	core_fclose(file);
+	return result;
+}
+
+
+/*-------------------------------------------------
+    validity_cache_write - record that a source
+    file passed its checks under the given key
+-------------------------------------------------*/
+
+static void validity_cache_write(const char *filename, const char *source_file, UINT32 key, const astring &others)
+{
+	core_file *file;
+
+	if (core_fopen(filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file) != FILERR_NONE)
+		return;
+	core_fprintf(file, "%s\n%s%08X\t%s\n", VALIDITY_CACHE_HEADER, others.cstr(), key, source_file);
+	core_fclose(file);
+}
+
+
 /*-------------------------------------------------
     mame_validitychecks - master validity checker
 -------------------------------------------------*/
@@ -1172,6 +1301,18 @@ bool mame_validitychecks(core_options &options, const game_driver *curdriver)
 	/* validate inline function behavior */
 	error = validate_inlines() || error;
 
+	/* with -faststart, the drivers of a source that passed under this build only get
+	   the checks against the driver list, which may have changed since */
+	astring cachename, cacheothers;
+	UINT32 cachekey = 0;
+	bool cached = false;
+	if (curdriver != NULL && !error && options_get_bool(&options, OPTION_FASTSTART))
+	{
+		cachename.cpy(options_get_string(&options, OPTION_CFG_DIRECTORY)).cat(PATH_SEPARATOR).cat(VALIDITY_CACHE_FILENAME);
+		cachekey = validity_cache_key(curdriver->source_file);
+		cached = (validity_cache_read(cachename, curdriver->source_file, cacheothers) == cachekey);
+	}
+
 	get_profile_ticks();
 
 	/* pre-populate the defstr tagmap with all the default strings */
@@ -1195,6 +1336,15 @@ bool mame_validitychecks(core_options &options, const game_driver *curdriver)
 		if (curdriver != NULL && strcmp(curdriver->source_file, driver.source_file) != 0)
 			continue;
 
+		/* the rest was checked under this build already */
+		if (cached)
+		{
+			driver_checks -= get_profile_ticks();
+			error = validate_driver_entry(driver, names, descriptions) || error;
+			driver_checks += get_profile_ticks();
+			continue;
+		}
+
 		try
 		{
 			/* expand the machine driver */
@@ -1249,5 +1399,8 @@ bool mame_validitychecks(core_options &options, const game_driver *curdriver)
 	mame_printf_info("Input:     %8dm\n", (int)(input_checks / 1000000));
 #endif
 
+	/* remember a clean pass for next time */
+	if (cachekey != 0 && !cached && !error)
+		validity_cache_write(cachename, curdriver->source_file, cachekey, cacheothers);
 	return error;
 }
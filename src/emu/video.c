@@ -231,6 +231,10 @@ void video_manager::frame_update(bool debug)
 			skipped_it = true;
 		else
 			m_empty_skip_count = 0;
+
+		// the first frame of the running game ends the startup timed by -bench_startup
+		if (mame_startup_mark(STARTUP_PHASE_FIRST_FRAME) && options_get_bool(&m_machine.options(), OPTION_BENCH_STARTUP))
+			m_machine.schedule_exit();
 	}
 
 	// draw the user interface
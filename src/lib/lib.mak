@@ -35,6 +35,7 @@ UTILOBJS = \
 	$(LIBOBJ)/util/corefile.o \
 	$(LIBOBJ)/util/corestr.o \
 	$(LIBOBJ)/util/coreutil.o \
+	$(LIBOBJ)/util/flacenc.o \
 	$(LIBOBJ)/util/harddisk.o \
 	$(LIBOBJ)/util/huffman.o \
 	$(LIBOBJ)/util/imageutl.o \
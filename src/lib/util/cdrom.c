@@ -77,6 +77,8 @@ struct _cdrom_file
 	UINT32				hunksectors;		/* sectors per hunk */
 	UINT32				cachehunk;			/* which hunk is cached */
 	UINT8 *				cache;				/* cache of the current hunk */
+	UINT32				pendinghunk;		/* which hunk is being read asynchronously */
+	UINT8 *				pending;			/* buffer for the asynchronous read */
 };
 
 
@@ -117,6 +119,38 @@ INLINE UINT32 physical_to_chd_lba(cdrom_file *file, UINT32 physlba, UINT32 *trac
 }
 
 
+/*-------------------------------------------------
+    swap_in_pending - make the asynchronous read
+    buffer the cached hunk
+-------------------------------------------------*/
+
+INLINE void swap_in_pending(cdrom_file *file, UINT32 hunknum)
+{
+	UINT8 *temp = file->cache;
+
+	file->cache = file->pending;
+	file->pending = temp;
+	file->cachehunk = hunknum;
+}
+
+
+/*-------------------------------------------------
+    finish_async_read - wait for any asynchronous
+    read to finish and make its hunk the cached
+    one
+-------------------------------------------------*/
+
+INLINE void finish_async_read(cdrom_file *file)
+{
+	if (file->pendinghunk == ~0)
+		return;
+
+	if (chd_async_complete(file->chd) == CHDERR_NONE)
+		swap_in_pending(file, file->pendinghunk);
+	file->pendinghunk = ~0;
+}
+
+
 
 /***************************************************************************
     BASE FUNCTIONALITY
@@ -152,6 +186,7 @@ cdrom_file *cdrom_open(chd_file *chd)
 	file->chd = chd;
 	file->hunksectors = header->hunkbytes / CD_FRAME_SIZE;
 	file->cachehunk = -1;
+	file->pendinghunk = ~0;
 
 	/* read the CD-ROM metadata */
 	err = cdrom_parse_metadata(chd, &file->cdtoc);
@@ -191,10 +226,15 @@ cdrom_file *cdrom_open(chd_file *chd)
 	file->cdtoc.tracks[i].physframeofs = physofs;
 	file->cdtoc.tracks[i].chdframeofs = chdofs;
 
-	/* allocate a cache */
+	/* allocate a cache, and a second hunk for asynchronous reads */
 	file->cache = (UINT8 *)malloc(chd_get_header(chd)->hunkbytes);
-	if (file->cache == NULL)
+	file->pending = (UINT8 *)malloc(chd_get_header(chd)->hunkbytes);
+	if (file->cache == NULL || file->pending == NULL)
 	{
+		if (file->cache != NULL)
+			free(file->cache);
+		if (file->pending != NULL)
+			free(file->pending);
 		free(file);
 		return NULL;
 	}
@@ -212,9 +252,14 @@ void cdrom_close(cdrom_file *file)
 	if (file == NULL)
 		return;
 
+	/* let any read in flight land before freeing its buffer */
+	finish_async_read(file);
+
 	/* free the cache */
 	if (file->cache)
 		free(file->cache);
+	if (file->pending)
+		free(file->pending);
 	free(file);
 }
 
@@ -302,6 +347,65 @@ UINT32 cdrom_read_subcode(cdrom_file *file, UINT32 lbasector, void *buffer)
 }
 
 
+/*-------------------------------------------------
+    cdrom_read_async - start reading the hunk
+    holding a sector in the background; the next
+    read of it collects the data
+-------------------------------------------------*/
+
+UINT32 cdrom_read_async(cdrom_file *file, UINT32 lbasector)
+{
+	UINT32 hunknum;
+	chd_error err;
+
+	if (file == NULL)
+		return 0;
+	hunknum = physical_to_chd_lba(file, lbasector, NULL) / file->hunksectors;
+
+	/* nothing to do if it's already here or on its way */
+	if (file->cachehunk == hunknum || file->pendinghunk == hunknum)
+		return 1;
+
+	/* only one asynchronous read may be in flight */
+	finish_async_read(file);
+	if (file->cachehunk == hunknum)
+		return 1;
+
+	err = chd_read_async(file->chd, hunknum, file->pending);
+	if (err == CHDERR_OPERATION_PENDING)
+	{
+		file->pendinghunk = hunknum;
+		return 1;
+	}
+
+	/* if the CHD fell back on a synchronous read, the data is already here */
+	if (err != CHDERR_NONE)
+		return 0;
+	swap_in_pending(file, hunknum);
+	return 1;
+}
+
+
+/*-------------------------------------------------
+    cdrom_prefetch - hint that a run of sectors
+    is about to be read
+-------------------------------------------------*/
+
+void cdrom_prefetch(cdrom_file *file, UINT32 lbasector, UINT32 count)
+{
+	UINT32 firsthunk, lasthunk;
+
+	if (file == NULL || count == 0)
+		return;
+
+	/* the run may cross into the padding between tracks, so map both ends */
+	firsthunk = physical_to_chd_lba(file, lbasector, NULL) / file->hunksectors;
+	lasthunk = physical_to_chd_lba(file, lbasector + count - 1, NULL) / file->hunksectors;
+	if (lasthunk >= firsthunk)
+		chd_prefetch(file->chd, firsthunk, lasthunk - firsthunk + 1);
+}
+
+
 
 /***************************************************************************
     HANDY UTILITIES
@@ -619,6 +723,9 @@ static chd_error read_sector_into_cache(cdrom_file *file, UINT32 lbasector, UINT
 	hunknum = chdsector / file->hunksectors;
 	*sectoroffs = chdsector % file->hunksectors;
 
+	/* collect any asynchronous read first; it may well be the hunk we want */
+	finish_async_read(file);
+
 	/* if we haven't cached this hunk, read it now */
 	if (file->cachehunk != hunknum)
 	{
@@ -133,6 +133,8 @@ void cdrom_close(cdrom_file *file);
 /* core read access */
 UINT32 cdrom_read_data(cdrom_file *file, UINT32 lbasector, void *buffer, UINT32 datatype);
 UINT32 cdrom_read_subcode(cdrom_file *file, UINT32 lbasector, void *buffer);
+UINT32 cdrom_read_async(cdrom_file *file, UINT32 lbasector);
+void cdrom_prefetch(cdrom_file *file, UINT32 lbasector, UINT32 count);
 
 /* handy utilities */
 UINT32 cdrom_get_track(cdrom_file *file, UINT32 frame);
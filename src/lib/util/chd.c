@@ -86,6 +86,12 @@
 
 #define NO_MATCH					(~0)
 
+#define COMPRESS_SLOTS				16			/* hunks that can be compressing at once */
+
+#define LRU_STATE_EMPTY				0			/* cache entry holds nothing */
+#define LRU_STATE_LOADING			1			/* cache entry is being decompressed */
+#define LRU_STATE_VALID				2			/* cache entry holds a decompressed hunk */
+
 
 
 /***************************************************************************
@@ -135,6 +141,44 @@ struct _crcmap_entry
 };
 
 
+/* a decompressed hunk in the LRU cache */
+typedef struct _lru_entry lru_entry;
+struct _lru_entry
+{
+	lru_entry *				prev;			/* previous (more recently used) entry */
+	lru_entry *				next;			/* next (less recently used) entry */
+	UINT32					hunknum;		/* hunk held here, or ~0 */
+	UINT8					state;			/* LRU_STATE_* */
+	UINT8					prefetched;		/* brought in by read-ahead and not yet read? */
+	UINT8 *					data;			/* decompressed data, allocated on first use */
+};
+
+
+/* the result of compressing a hunk ahead of writing it */
+typedef struct _hunk_result hunk_result;
+struct _hunk_result
+{
+	UINT32					crc;			/* CRC of the data as it will read back */
+	UINT8					mini;			/* can it be stored as a mini hunk? */
+	chd_error				err;			/* result of compressing */
+	UINT32					length;			/* compressed length */
+	const UINT8 *			compressed;		/* compressed data */
+};
+
+
+/* a hunk in flight in the compression pipeline */
+typedef struct _compress_slot compress_slot;
+struct _compress_slot
+{
+	chd_file *				codec;			/* private copy of the CHD holding codec state and buffers */
+	osd_work_item *			workitem;		/* work item compressing this hunk */
+	UINT32					hunknum;		/* hunk being compressed */
+	UINT8 *					data;			/* copy of the source data */
+	UINT8					srcnull;		/* was the hunk passed as NULL (A/V codec configuration)? */
+	hunk_result				result;			/* result of compressing */
+};
+
+
 /* a single metadata entry */
 typedef struct _metadata_entry metadata_entry;
 struct _metadata_entry
@@ -181,6 +225,11 @@ struct _chd_file
 	struct MD5Context		compmd5;		/* running MD5 during compression */
 	struct sha1_ctx			compsha1;		/* running SHA1 during compression */
 	UINT32					comphunk;		/* next hunk we will compress */
+	UINT32					compdone;		/* number of hunks written */
+	osd_work_queue *		compqueue;		/* work queue for parallel compression */
+	compress_slot *			compslot;		/* ring of hunks being compressed */
+	UINT32					comphead;		/* oldest slot in flight */
+	UINT32					compcount;		/* number of slots in flight */
 
 	UINT8					verifying;		/* are we verifying? */
 	struct MD5Context		vermd5; 		/* running MD5 during verification */
@@ -191,6 +240,20 @@ struct _chd_file
 	osd_work_item *			workitem;		/* active work item, or NULL if none */
 	UINT32					async_hunknum;	/* hunk index for asynchronous operations */
 	void *					async_buffer;	/* buffer pointer for asynchronous operations */
+
+	osd_lock *				filelock;		/* serializes file and codec access between threads */
+	osd_lock *				lrulock;		/* protects the LRU cache and read-ahead state */
+	lru_entry *				lrulist;		/* array of LRU cache entries */
+	UINT32					lrucount;		/* number of LRU cache entries */
+	lru_entry *				lruhead;		/* most recently used entry */
+	lru_entry *				lrutail;		/* least recently used entry */
+	UINT32					lastread;		/* last hunk read, for spotting sequential access */
+	UINT32					readahead;		/* how many hunks to decompress ahead */
+	UINT32					aheadnext;		/* next hunk read-ahead will decompress */
+	UINT32					aheadlast;		/* last hunk read-ahead will decompress */
+	UINT8					aheadactive;	/* is a read-ahead work item queued? */
+	osd_work_queue *		aheadqueue;		/* work queue for read-ahead */
+	chd_stats				stats;			/* cache statistics */
 };
 
 
@@ -240,6 +303,15 @@ static const UINT8 nullsha1[CHD_SHA1_BYTES] = { 0 };
 /* internal async operations */
 static void *async_read_callback(void *param, int threadid);
 static void *async_write_callback(void *param, int threadid);
+static void *readahead_callback(void *param, int threadid);
+static void *compress_callback(void *param, int threadid);
+
+/* internal compression pipeline */
+static void compress_alloc(chd_file *chd);
+static void compress_free(chd_file *chd);
+static int compress_queue(chd_file *chd, UINT32 hunknum, const void *data);
+static chd_error compress_retire(chd_file *chd, UINT32 mustretire);
+static void compress_hunk_done(chd_file *chd, UINT32 hunknum, const UINT8 *crcdata);
 
 /* internal header operations */
 static chd_error header_validate(const chd_header *header);
@@ -249,7 +321,19 @@ static chd_error header_write(core_file *file, const chd_header *header);
 /* internal hunk read/write */
 static chd_error hunk_read_into_cache(chd_file *chd, UINT32 hunknum);
 static chd_error hunk_read_into_memory(chd_file *chd, UINT32 hunknum, UINT8 *dest);
-static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UINT8 *src);
+static int hunk_is_mini(chd_file *chd, const UINT8 *src);
+static chd_error hunk_compress_data(chd_file *chd, const UINT8 *src, UINT32 *length, UINT32 *crc);
+static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UINT8 *src, const hunk_result *precomp);
+
+/* internal LRU cache helpers */
+static chd_error lru_alloc(chd_file *chd, UINT32 hunks, UINT32 readahead);
+static void lru_free(chd_file *chd);
+static void lru_flush(chd_file *chd);
+static lru_entry *lru_find(chd_file *chd, UINT32 hunknum);
+static lru_entry *lru_reserve(chd_file *chd, UINT32 hunknum);
+static chd_error lru_load(chd_file *chd, lru_entry *entry, UINT32 hunknum);
+static chd_error lru_read(chd_file *chd, UINT32 hunknum, UINT8 *dest);
+static void readahead_start(chd_file *chd);
 
 /* internal map access */
 static chd_error map_write_initial(core_file *file, chd_file *parent, const chd_header *header);
@@ -282,6 +366,7 @@ static chd_error av_codec_compress(chd_file *chd, const void *src, UINT32 *lengt
 static chd_error av_codec_decompress(chd_file *chd, UINT32 srclength, void *dest);
 static chd_error av_codec_config(chd_file *chd, int param, void *config);
 static chd_error av_codec_postinit(chd_file *chd);
+static int av_codec_pack(chd_file *chd, UINT8 *dest);
 
 
 
@@ -518,6 +603,29 @@ INLINE void wait_for_pending_async(chd_file *chd)
 }
 
 
+/*-------------------------------------------------
+    wait_for_pending_io - wait for any pending
+    async operation and stop read-ahead; needed
+    before anything that moves the file pointer
+    or changes the data outside of the file lock
+-------------------------------------------------*/
+
+INLINE void wait_for_pending_io(chd_file *chd)
+{
+	wait_for_pending_async(chd);
+
+	/* cut the read-ahead window short and let the worker drain */
+	if (chd->aheadqueue != NULL)
+	{
+		osd_lock_acquire(chd->lrulock);
+		chd->aheadnext = chd->aheadlast + 1;
+		osd_lock_release(chd->lrulock);
+		if (!osd_work_queue_wait(chd->aheadqueue, 10 * osd_ticks_per_second()))
+			osd_break_into_debugger("Pending read-ahead never completed!");
+	}
+}
+
+
 
 /***************************************************************************
     CHD FILE MANAGEMENT
@@ -644,6 +752,12 @@ chd_error chd_open_file(core_file *file, int mode, chd_file *parent, chd_file **
 	newchd->parent = parent;
 	newchd->file = file;
 
+	/* allocate the locks that let reads run on several threads */
+	newchd->filelock = osd_lock_alloc();
+	newchd->lrulock = osd_lock_alloc();
+	if (newchd->filelock == NULL || newchd->lrulock == NULL)
+		EARLY_EXIT(err = CHDERR_OUT_OF_MEMORY);
+
 	/* now attempt to read the header */
 	err = header_read(newchd->file, &newchd->header);
 	if (err != CHDERR_NONE)
@@ -716,6 +830,14 @@ chd_error chd_open_file(core_file *file, int mode, chd_file *parent, chd_file **
 	if (err != CHDERR_NONE)
 		EARLY_EXIT(err);
 
+	/* set up the decompressed hunk cache; lossy hunks decode elsewhere and can't be cached */
+	if (!newchd->codecintf->lossy)
+	{
+		err = lru_alloc(newchd, CHD_DEFAULT_CACHE_HUNKS, CHD_DEFAULT_READAHEAD);
+		if (err != CHDERR_NONE)
+			EARLY_EXIT(err);
+	}
+
 	/* all done */
 	*chd = newchd;
 	return CHDERR_NONE;
@@ -817,14 +939,19 @@ void chd_close(chd_file *chd)
 	if (chd == NULL || chd->cookie != COOKIE_VALUE)
 		return;
 
-	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	/* wait for any pending async operations and read-ahead */
+	wait_for_pending_io(chd);
+
+	/* abandon any compression still in flight */
+	compress_free(chd);
 
-	/* kill the work queue and any work item */
+	/* kill the work queues and any work item */
 	if (chd->workitem != NULL)
 		osd_work_item_release(chd->workitem);
 	if (chd->workqueue != NULL)
 		osd_work_queue_free(chd->workqueue);
+	if (chd->aheadqueue != NULL)
+		osd_work_queue_free(chd->aheadqueue);
 
 	/* deinit the codec */
 	if (chd->codecintf != NULL && chd->codecintf->free != NULL)
@@ -840,6 +967,13 @@ void chd_close(chd_file *chd)
 	if (chd->cache != NULL)
 		free(chd->cache);
 
+	/* free the LRU cache and the locks */
+	lru_free(chd);
+	if (chd->lrulock != NULL)
+		osd_lock_free(chd->lrulock);
+	if (chd->filelock != NULL)
+		osd_lock_free(chd->filelock);
+
 	/* free the hunk map */
 	if (chd->map != NULL)
 		free(chd->map);
@@ -1037,7 +1171,7 @@ chd_error chd_read(chd_file *chd, UINT32 hunknum, void *buffer)
 	wait_for_pending_async(chd);
 
 	/* perform the read */
-	return hunk_read_into_memory(chd, hunknum, (UINT8 *)buffer);
+	return lru_read(chd, hunknum, (UINT8 *)buffer);
 }
 
 
@@ -1088,10 +1222,10 @@ chd_error chd_write(chd_file *chd, UINT32 hunknum, const void *buffer)
 		return CHDERR_HUNK_OUT_OF_RANGE;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* then write out the hunk */
-	return hunk_write_from_memory(chd, hunknum, (const UINT8 *)buffer);
+	return hunk_write_from_memory(chd, hunknum, (const UINT8 *)buffer, NULL);
 }
 
 
@@ -1111,7 +1245,7 @@ chd_error chd_write_async(chd_file *chd, UINT32 hunknum, const void *buffer)
 		return CHDERR_HUNK_OUT_OF_RANGE;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* set the async parameters */
 	chd->async_hunknum = hunknum;
@@ -1152,6 +1286,88 @@ chd_error chd_async_complete(chd_file *chd)
 }
 
 
+/*-------------------------------------------------
+    chd_set_cache - resize the decompressed hunk
+    cache and set the read-ahead depth
+-------------------------------------------------*/
+
+chd_error chd_set_cache(chd_file *chd, UINT32 hunks, UINT32 readahead)
+{
+	/* punt if NULL or invalid */
+	if (chd == NULL || chd->cookie != COOKIE_VALUE)
+		return CHDERR_INVALID_PARAMETER;
+	if (hunks > CHD_MAX_CACHE_HUNKS)
+		return CHDERR_INVALID_PARAMETER;
+
+	/* lossy hunks are never cached */
+	if (chd->codecintf->lossy)
+		return CHDERR_NOT_SUPPORTED;
+
+	/* nothing may be using the cache while we replace it */
+	wait_for_pending_io(chd);
+	lru_free(chd);
+	return lru_alloc(chd, hunks, readahead);
+}
+
+
+/*-------------------------------------------------
+    chd_prefetch - start decompressing a range
+    of hunks into the cache ahead of reads the
+    caller knows are coming
+-------------------------------------------------*/
+
+chd_error chd_prefetch(chd_file *chd, UINT32 hunknum, UINT32 count)
+{
+	/* punt if NULL or invalid */
+	if (chd == NULL || chd->cookie != COOKIE_VALUE)
+		return CHDERR_INVALID_PARAMETER;
+
+	/* if we're past the end, fail */
+	if (hunknum >= chd->header.totalhunks)
+		return CHDERR_HUNK_OUT_OF_RANGE;
+
+	/* without a cache there is nowhere to put the hunks */
+	if (chd->lrulist == NULL)
+		return CHDERR_NOT_SUPPORTED;
+
+	/* clip to the disk and to half the cache, so we don't evict what we prefetched before it's read */
+	count = MIN(count, chd->header.totalhunks - hunknum);
+	count = MIN(count, chd->lrucount / 2);
+	if (count == 0)
+		return CHDERR_NONE;
+
+	osd_lock_acquire(chd->lrulock);
+
+	/* replace the read-ahead window, and treat the first hunk as the next in sequence */
+	chd->aheadnext = hunknum;
+	chd->aheadlast = hunknum + count - 1;
+	chd->lastread = hunknum - 1;
+	readahead_start(chd);
+
+	osd_lock_release(chd->lrulock);
+	return CHDERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    chd_get_stats - return hit/miss statistics
+    for the hunk cache
+-------------------------------------------------*/
+
+void chd_get_stats(chd_file *chd, chd_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	/* punt if NULL or invalid */
+	if (chd == NULL || chd->cookie != COOKIE_VALUE)
+		return;
+
+	osd_lock_acquire(chd->lrulock);
+	*stats = chd->stats;
+	osd_lock_release(chd->lrulock);
+}
+
+
 
 /***************************************************************************
     METADATA MANAGEMENT
@@ -1169,7 +1385,7 @@ chd_error chd_get_metadata(chd_file *chd, UINT32 searchtag, UINT32 searchindex,
 	UINT32 count;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* if we didn't find it, just return */
 	err = metadata_find_entry(chd, searchtag, searchindex, &metaentry);
@@ -1246,7 +1462,7 @@ chd_error chd_set_metadata(chd_file *chd, UINT32 metatag, UINT32 metaindex, cons
 		return CHDERR_INVALID_PARAMETER;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* find the entry if it already exists */
 	err = metadata_find_entry(chd, metatag, metaindex, &metaentry);
@@ -1393,7 +1609,7 @@ chd_error chd_compress_begin(chd_file *chd)
 		return CHDERR_INVALID_PARAMETER;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* mark the CHD writeable and write the updated header */
 	chd->header.flags |= CHDFLAGS_IS_WRITEABLE;
@@ -1411,6 +1627,10 @@ chd_error chd_compress_begin(chd_file *chd)
 	sha1_init(&chd->compsha1);
 	chd->compressing = TRUE;
 	chd->comphunk = 0;
+	chd->compdone = 0;
+
+	/* compress on all processors if we can; otherwise chd_compress_hunk works serially */
+	compress_alloc(chd);
 
 	return CHDERR_NONE;
 }
@@ -1424,52 +1644,50 @@ chd_error chd_compress_begin(chd_file *chd)
 chd_error chd_compress_hunk(chd_file *chd, const void *data, double *curratio)
 {
 	UINT32 thishunk = chd->comphunk++;
-	UINT64 sourceoffset = (UINT64)thishunk * (UINT64)chd->header.hunkbytes;
-	UINT32 bytestochecksum;
-	const void *crcdata;
 	chd_error err;
 
 	/* error if in the wrong state */
 	if (!chd->compressing)
 		return CHDERR_INVALID_STATE;
 
-	/* write out the hunk */
-	err = hunk_write_from_memory(chd, thishunk, (const UINT8 *)data);
+	/* hand the hunk to the pipeline if there is one; hunks are written back in order */
+	if (chd->compslot != NULL)
+	{
+		/* the oldest hunk has to be written before its slot can be reused */
+		if (chd->compcount == COMPRESS_SLOTS)
+		{
+			err = compress_retire(chd, 1);
+			if (err != CHDERR_NONE)
+				return err;
+		}
+		if (compress_queue(chd, thishunk, data))
+		{
+			err = compress_retire(chd, 0);
+			goto update_ratio;
+		}
+	}
+
+	/* otherwise, write out everything in flight and then this hunk */
+	err = compress_retire(chd, COMPRESS_SLOTS);
+	if (err != CHDERR_NONE)
+		return err;
+	err = hunk_write_from_memory(chd, thishunk, (const UINT8 *)data, NULL);
 	if (err != CHDERR_NONE)
 		return err;
 
 	/* if we are lossy, then we need to use the decompressed version in */
 	/* the cache as our MD5/SHA1 source */
-	crcdata = (chd->codecintf->lossy || data == NULL) ? chd->cache : data;
-
-	/* update the MD5/SHA1 */
-	bytestochecksum = chd->header.hunkbytes;
-	if (sourceoffset + chd->header.hunkbytes > chd->header.logicalbytes)
-	{
-		if (sourceoffset >= chd->header.logicalbytes)
-			bytestochecksum = 0;
-		else
-			bytestochecksum = chd->header.logicalbytes - sourceoffset;
-	}
-	if (bytestochecksum > 0)
-	{
-		MD5Update(&chd->compmd5, (const unsigned char *)crcdata, bytestochecksum);
-		sha1_update(&chd->compsha1, bytestochecksum, (const UINT8 *)crcdata);
-	}
-
-	/* update our CRC map */
-	if ((chd->map[thishunk].flags & MAP_ENTRY_FLAG_TYPE_MASK) != MAP_ENTRY_TYPE_SELF_HUNK &&
-		(chd->map[thishunk].flags & MAP_ENTRY_FLAG_TYPE_MASK) != MAP_ENTRY_TYPE_PARENT_HUNK)
-		crcmap_add_entry(chd, thishunk);
+	compress_hunk_done(chd, thishunk, (chd->codecintf->lossy || data == NULL) ? chd->cache : (const UINT8 *)data);
 
 	/* update the ratio */
-	if (curratio != NULL)
+update_ratio:
+	if (curratio != NULL && chd->compdone > 0)
 	{
 		UINT64 curlength = core_fsize(chd->file);
-		*curratio = 1.0 - (double)curlength / (double)((UINT64)chd->comphunk * (UINT64)chd->header.hunkbytes);
+		*curratio = 1.0 - (double)curlength / (double)((UINT64)chd->compdone * (UINT64)chd->header.hunkbytes);
 	}
 
-	return CHDERR_NONE;
+	return err;
 }
 
 
@@ -1480,10 +1698,18 @@ chd_error chd_compress_hunk(chd_file *chd, const void *data, double *curratio)
 
 chd_error chd_compress_finish(chd_file *chd, int write_protect)
 {
+	chd_error err;
+
 	/* error if in the wrong state */
 	if (!chd->compressing)
 		return CHDERR_INVALID_STATE;
 
+	/* write out whatever is still in flight */
+	err = compress_retire(chd, COMPRESS_SLOTS);
+	compress_free(chd);
+	if (err != CHDERR_NONE)
+		return err;
+
 	/* compute the final MD5/SHA1 values */
 	MD5Final(chd->header.md5, &chd->compmd5);
 	sha1_final(&chd->compsha1);
@@ -1519,7 +1745,7 @@ chd_error chd_verify_begin(chd_file *chd)
 		return CHDERR_CANT_VERIFY;
 
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* init the MD5/SHA1 computations */
 	MD5Init(&chd->vermd5);
@@ -1612,7 +1838,7 @@ chd_error chd_verify_finish(chd_file *chd, chd_verify_result *result)
 chd_error chd_codec_config(chd_file *chd, int param, void *config)
 {
 	/* wait for any pending async operations */
-	wait_for_pending_async(chd);
+	wait_for_pending_io(chd);
 
 	/* if the codec has a configuration callback, call through to it */
 	if (chd->codecintf->config != NULL)
@@ -1655,8 +1881,8 @@ static void *async_read_callback(void *param, int threadid)
 	chd_file *chd = (chd_file *)param;
 	chd_error err;
 
-	/* read the hunk into the cache */
-	err = hunk_read_into_memory(chd, chd->async_hunknum, (UINT8 *)chd->async_buffer);
+	/* read the hunk through the cache */
+	err = lru_read(chd, chd->async_hunknum, (UINT8 *)chd->async_buffer);
 
 	/* return the error */
 	return (void *)err;
@@ -1674,13 +1900,74 @@ static void *async_write_callback(void *param, int threadid)
 	chd_error err;
 
 	/* write the hunk from memory */
-	err = hunk_write_from_memory(chd, chd->async_hunknum, (const UINT8 *)chd->async_buffer);
+	err = hunk_write_from_memory(chd, chd->async_hunknum, (const UINT8 *)chd->async_buffer, NULL);
 
 	/* return the error */
 	return (void *)err;
 }
 
 
+/*-------------------------------------------------
+    compress_callback - compress a hunk in the
+    pipeline on a worker thread
+-------------------------------------------------*/
+
+static void *compress_callback(void *param, int threadid)
+{
+	compress_slot *slot = (compress_slot *)param;
+	chd_file *codec = slot->codec;
+	hunk_result *result = &slot->result;
+
+	/* CRC it and check for a mini hunk, as hunk_write_from_memory would */
+	result->crc = slot->srcnull ? 0 : crc32(0, slot->data, codec->header.hunkbytes);
+	result->mini = FALSE;
+	if (!codec->codecintf->lossy && !slot->srcnull && codec->header.compression >= CHDCOMPRESSION_ZLIB_PLUS)
+		result->mini = hunk_is_mini(codec, slot->data);
+
+	/* a mini hunk is never compressed; anything else might still turn out to match */
+	/* an earlier hunk, but we can't know that until it's written */
+	result->err = CHDERR_COMPRESSION_ERROR;
+	if (!result->mini)
+		result->err = hunk_compress_data(codec, slot->data, &result->length, &result->crc);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    readahead_callback - decompress hunks ahead
+    of sequential reads into the LRU cache
+-------------------------------------------------*/
+
+static void *readahead_callback(void *param, int threadid)
+{
+	chd_file *chd = (chd_file *)param;
+
+	osd_lock_acquire(chd->lrulock);
+	while (chd->aheadnext <= chd->aheadlast)
+	{
+		UINT32 hunknum = chd->aheadnext++;
+		lru_entry *entry;
+
+		/* skip hunks that are already cached or on their way */
+		if (lru_find(chd, hunknum) != NULL)
+			continue;
+
+		/* claim an entry and fill it; lru_load drops the cache lock while decompressing */
+		entry = lru_reserve(chd, hunknum);
+		if (entry == NULL)
+			break;
+		if (lru_load(chd, entry, hunknum) == CHDERR_NONE)
+		{
+			entry->prefetched = TRUE;
+			chd->stats.prefetched++;
+		}
+	}
+	chd->aheadactive = FALSE;
+	osd_lock_release(chd->lrulock);
+	return NULL;
+}
+
+
 
 /***************************************************************************
     INTERNAL HEADER OPERATIONS
@@ -1942,24 +2229,31 @@ static chd_error hunk_read_into_memory(chd_file *chd, UINT32 hunknum, UINT8 *des
 		/* compressed data */
 		case MAP_ENTRY_TYPE_COMPRESSED:
 
-			/* read it into the decompression buffer */
+			/* read it into the decompression buffer; the file and codec are shared with read-ahead */
+			osd_lock_acquire(chd->filelock);
 			core_fseek(chd->file, entry->offset, SEEK_SET);
 			bytes = core_fread(chd->file, chd->compressed, entry->length);
 			if (bytes != entry->length)
+			{
+				osd_lock_release(chd->filelock);
 				return CHDERR_READ_ERROR;
+			}
 
 			/* now decompress using the codec */
 			err = CHDERR_NONE;
 			if (chd->codecintf->decompress != NULL)
 				err = (*chd->codecintf->decompress)(chd, entry->length, dest);
+			osd_lock_release(chd->filelock);
 			if (err != CHDERR_NONE)
 				return err;
 			break;
 
 		/* uncompressed data */
 		case MAP_ENTRY_TYPE_UNCOMPRESSED:
+			osd_lock_acquire(chd->filelock);
 			core_fseek(chd->file, entry->offset, SEEK_SET);
 			bytes = core_fread(chd->file, dest, chd->header.hunkbytes);
+			osd_lock_release(chd->filelock);
 			if (bytes != chd->header.hunkbytes)
 				return CHDERR_READ_ERROR;
 			break;
@@ -1988,17 +2282,62 @@ static chd_error hunk_read_into_memory(chd_file *chd, UINT32 hunknum, UINT8 *des
 }
 
 
+/*-------------------------------------------------
+    hunk_is_mini - can a hunk be stored as a
+    mini hunk (one repeated 8-byte value)?
+-------------------------------------------------*/
+
+static int hunk_is_mini(chd_file *chd, const UINT8 *src)
+{
+	UINT32 bytes;
+
+	for (bytes = 8; bytes < chd->header.hunkbytes; bytes++)
+		if (src[bytes] != src[bytes - 8])
+			return FALSE;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    hunk_compress_data - compress a hunk with the
+    codec into chd->compressed; lossy results
+    are decompressed into chd->cache to get the
+    CRC of what will actually read back
+-------------------------------------------------*/
+
+static chd_error hunk_compress_data(chd_file *chd, const UINT8 *src, UINT32 *length, UINT32 *crc)
+{
+	chd_error err = CHDERR_COMPRESSION_ERROR;
+
+	/* now try compressing the data */
+	if (chd->codecintf->compress != NULL)
+		err = (*chd->codecintf->compress)(chd, src, length);
+
+	/* if that worked, and we're lossy, decompress and CRC the result */
+	if (err == CHDERR_NONE && (chd->codecintf->lossy || src == NULL))
+	{
+		err = (*chd->codecintf->decompress)(chd, *length, chd->cache);
+		if (err == CHDERR_NONE)
+			*crc = crc32(0, chd->cache, chd->header.hunkbytes);
+	}
+	return err;
+}
+
+
 /*-------------------------------------------------
     hunk_write_from_memory - write a hunk from
-    memory into a CHD
+    memory into a CHD; if the compression
+    pipeline already compressed it, 'precomp'
+    holds the result
 -------------------------------------------------*/
 
-static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UINT8 *src)
+static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UINT8 *src, const hunk_result *precomp)
 {
 	map_entry *entry = &chd->map[hunknum];
 	map_entry newentry;
 	UINT8 fileentry[MAP_ENTRY_SIZE];
 	const void *data = src;
+	const UINT8 *compressed = chd->compressed;
 	UINT32 bytes = 0, match;
 	chd_error err;
 
@@ -2006,9 +2345,14 @@ static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UIN
 	if (hunknum > chd->maxhunk)
 		chd->maxhunk = hunknum;
 
+	/* other hunks may refer to this one, so drop everything we have cached */
+	lru_flush(chd);
+
 	/* first compute the CRC of the original data */
 	newentry.crc = 0;
-	if (src != NULL)
+	if (precomp != NULL)
+		newentry.crc = precomp->crc;
+	else if (src != NULL)
 		newentry.crc = crc32(0, &src[0], chd->header.hunkbytes);
 
 	/* if we're not a lossy codec, compute the CRC and look for matches */
@@ -2017,13 +2361,8 @@ static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UIN
 		/* some extra stuff for zlib+ compression */
 		if (chd->header.compression >= CHDCOMPRESSION_ZLIB_PLUS)
 		{
-			/* see if we can mini-compress first */
-			for (bytes = 8; bytes < chd->header.hunkbytes; bytes++)
-				if (src[bytes] != src[bytes - 8])
-					break;
-
-			/* if so, we don't need to write any data */
-			if (bytes == chd->header.hunkbytes)
+			/* see if we can mini-compress first; if so, we don't need to write any data */
+			if ((precomp != NULL) ? precomp->mini : hunk_is_mini(chd, src))
 			{
 				newentry.offset = get_bigendian_uint64(&src[0]);
 				newentry.length = 0;
@@ -2056,23 +2395,20 @@ static chd_error hunk_write_from_memory(chd_file *chd, UINT32 hunknum, const UIN
 		}
 	}
 
-	/* now try compressing the data */
-	err = CHDERR_COMPRESSION_ERROR;
-	if (chd->codecintf->compress != NULL)
-		err = (*chd->codecintf->compress)(chd, src, &bytes);
-
-	/* if that worked, and we're lossy, decompress and CRC the result */
-	if (err == CHDERR_NONE && (chd->codecintf->lossy || src == NULL))
+	/* now try compressing the data, unless that was already done */
+	if (precomp != NULL)
 	{
-		err = (*chd->codecintf->decompress)(chd, bytes, chd->cache);
-		if (err == CHDERR_NONE)
-			newentry.crc = crc32(0, chd->cache, chd->header.hunkbytes);
+		err = precomp->err;
+		bytes = precomp->length;
+		compressed = precomp->compressed;
 	}
+	else
+		err = hunk_compress_data(chd, src, &bytes, &newentry.crc);
 
 	/* if we succeeded in compressing the data, replace our data pointer and mark it so */
 	if (err == CHDERR_NONE)
 	{
-		data = chd->compressed;
+		data = compressed;
 		newentry.length = bytes;
 		newentry.flags = MAP_ENTRY_TYPE_COMPRESSED;
 	}
@@ -2111,6 +2447,551 @@ write_entry:
 
 
 
+/***************************************************************************
+    INTERNAL COMPRESSION PIPELINE
+***************************************************************************/
+
+/*-------------------------------------------------
+    compress_clone - make a private copy of a CHD
+    with its own codec state and buffers, for a
+    worker thread to compress with
+-------------------------------------------------*/
+
+static chd_file *compress_clone(chd_file *chd)
+{
+	chd_file *clone;
+
+	/* start from a copy; workers only ever read the header and the codec */
+	clone = (chd_file *)malloc(sizeof(*clone));
+	if (clone == NULL)
+		return NULL;
+	*clone = *chd;
+	clone->workqueue = NULL;
+	clone->workitem = NULL;
+	clone->aheadqueue = NULL;
+	clone->lrulist = NULL;
+	clone->lrucount = 0;
+	clone->compqueue = NULL;
+	clone->compslot = NULL;
+	clone->codecdata = NULL;
+
+	/* give it its own buffers */
+	clone->cache = (UINT8 *)malloc(chd->header.hunkbytes);
+	clone->compressed = (UINT8 *)malloc(chd->header.hunkbytes);
+	if (clone->cache == NULL || clone->compressed == NULL)
+		goto error;
+
+	/* and its own codec, which must be fully set up before any worker touches it */
+	if ((*chd->codecintf->init)(clone) != CHDERR_NONE)
+	{
+		clone->codecdata = NULL;
+		goto error;
+	}
+	if (chd->header.compression == CHDCOMPRESSION_AV && ((av_codec_data *)clone->codecdata)->compstate == NULL)
+		goto error;
+	return clone;
+
+error:
+	if (clone->codecdata != NULL)
+		(*chd->codecintf->free)(clone);
+	if (clone->compressed != NULL)
+		free(clone->compressed);
+	if (clone->cache != NULL)
+		free(clone->cache);
+	free(clone);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    compress_alloc - set up the compression
+    pipeline; if anything fails, compression
+    simply stays serial
+-------------------------------------------------*/
+
+static void compress_alloc(chd_file *chd)
+{
+	int slotnum;
+
+	/* nothing to gain without a codec */
+	if (chd->codecintf->compress == NULL || chd->codecintf->init == NULL)
+		return;
+
+	chd->compslot = (compress_slot *)malloc(COMPRESS_SLOTS * sizeof(chd->compslot[0]));
+	if (chd->compslot == NULL)
+		return;
+	memset(chd->compslot, 0, COMPRESS_SLOTS * sizeof(chd->compslot[0]));
+	chd->comphead = chd->compcount = 0;
+
+	/* each slot gets a source buffer and a private codec */
+	for (slotnum = 0; slotnum < COMPRESS_SLOTS; slotnum++)
+	{
+		compress_slot *slot = &chd->compslot[slotnum];
+
+		slot->data = (UINT8 *)malloc(chd->header.hunkbytes);
+		slot->codec = compress_clone(chd);
+		if (slot->data == NULL || slot->codec == NULL)
+			goto error;
+		slot->result.compressed = slot->codec->compressed;
+	}
+
+	chd->compqueue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	if (chd->compqueue == NULL)
+		goto error;
+	return;
+
+error:
+	compress_free(chd);
+}
+
+
+/*-------------------------------------------------
+    compress_free - tear down the compression
+    pipeline, abandoning anything in flight
+-------------------------------------------------*/
+
+static void compress_free(chd_file *chd)
+{
+	int slotnum;
+
+	if (chd->compslot == NULL)
+		return;
+
+	/* wait for the workers before freeing what they use */
+	for (slotnum = 0; slotnum < COMPRESS_SLOTS; slotnum++)
+		if (chd->compslot[slotnum].workitem != NULL)
+			osd_work_item_release(chd->compslot[slotnum].workitem);
+	if (chd->compqueue != NULL)
+		osd_work_queue_free(chd->compqueue);
+	chd->compqueue = NULL;
+
+	for (slotnum = 0; slotnum < COMPRESS_SLOTS; slotnum++)
+	{
+		compress_slot *slot = &chd->compslot[slotnum];
+
+		if (slot->codec != NULL)
+		{
+			(*chd->codecintf->free)(slot->codec);
+			free(slot->codec->compressed);
+			free(slot->codec->cache);
+			free(slot->codec);
+		}
+		if (slot->data != NULL)
+			free(slot->data);
+	}
+	free(chd->compslot);
+	chd->compslot = NULL;
+	chd->compcount = 0;
+}
+
+
+/*-------------------------------------------------
+    compress_queue - copy a hunk into the next
+    free slot and queue it for compression;
+    returns FALSE if it has to be done serially
+-------------------------------------------------*/
+
+static int compress_queue(chd_file *chd, UINT32 hunknum, const void *data)
+{
+	compress_slot *slot = &chd->compslot[(chd->comphead + chd->compcount) % COMPRESS_SLOTS];
+
+	/* snapshot the data; A/V frames are given by reference, so pack them into raw form */
+	if (data != NULL)
+	{
+		memcpy(slot->data, data, chd->header.hunkbytes);
+		slot->srcnull = FALSE;
+	}
+	else if (chd->header.compression == CHDCOMPRESSION_AV && av_codec_pack(chd, slot->data))
+		slot->srcnull = TRUE;
+	else
+		return FALSE;
+
+	/* queue it up */
+	slot->hunknum = hunknum;
+	slot->workitem = osd_work_item_queue(chd->compqueue, compress_callback, slot, 0);
+	if (slot->workitem == NULL)
+		return FALSE;
+	chd->compcount++;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    compress_retire - write out compressed hunks
+    in order; waits for at least 'mustretire'
+    of them, then takes any others that are done
+-------------------------------------------------*/
+
+static chd_error compress_retire(chd_file *chd, UINT32 mustretire)
+{
+	while (chd->compcount > 0)
+	{
+		compress_slot *slot = &chd->compslot[chd->comphead];
+		chd_error err;
+
+		/* stop at the first hunk that isn't ready, unless we must wait */
+		if (mustretire == 0 && !osd_work_item_wait(slot->workitem, 0))
+			break;
+		while (!osd_work_item_wait(slot->workitem, 10 * osd_ticks_per_second())) ;
+		osd_work_item_release(slot->workitem);
+		slot->workitem = NULL;
+		chd->comphead = (chd->comphead + 1) % COMPRESS_SLOTS;
+		chd->compcount--;
+		if (mustretire > 0)
+			mustretire--;
+
+		/* make the same decisions the serial path would, in the same order */
+		err = hunk_write_from_memory(chd, slot->hunknum, slot->srcnull ? NULL : slot->data, &slot->result);
+		if (err != CHDERR_NONE)
+			return err;
+		compress_hunk_done(chd, slot->hunknum, (chd->codecintf->lossy || slot->srcnull) ? slot->codec->cache : slot->data);
+	}
+	return CHDERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    compress_hunk_done - update the running
+    hashes and the CRC map once a hunk is written
+-------------------------------------------------*/
+
+static void compress_hunk_done(chd_file *chd, UINT32 hunknum, const UINT8 *crcdata)
+{
+	UINT64 sourceoffset = (UINT64)hunknum * (UINT64)chd->header.hunkbytes;
+	UINT32 bytestochecksum;
+
+	/* update the MD5/SHA1 */
+	bytestochecksum = chd->header.hunkbytes;
+	if (sourceoffset + chd->header.hunkbytes > chd->header.logicalbytes)
+	{
+		if (sourceoffset >= chd->header.logicalbytes)
+			bytestochecksum = 0;
+		else
+			bytestochecksum = chd->header.logicalbytes - sourceoffset;
+	}
+	if (bytestochecksum > 0)
+	{
+		MD5Update(&chd->compmd5, crcdata, bytestochecksum);
+		sha1_update(&chd->compsha1, bytestochecksum, crcdata);
+	}
+
+	/* update our CRC map */
+	if ((chd->map[hunknum].flags & MAP_ENTRY_FLAG_TYPE_MASK) != MAP_ENTRY_TYPE_SELF_HUNK &&
+		(chd->map[hunknum].flags & MAP_ENTRY_FLAG_TYPE_MASK) != MAP_ENTRY_TYPE_PARENT_HUNK)
+		crcmap_add_entry(chd, hunknum);
+	chd->compdone++;
+}
+
+
+
+/***************************************************************************
+    INTERNAL LRU CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    lru_alloc - allocate the LRU cache entries;
+    their data is allocated on first use
+-------------------------------------------------*/
+
+static chd_error lru_alloc(chd_file *chd, UINT32 hunks, UINT32 readahead)
+{
+	UINT32 entnum;
+
+	/* read-ahead gets at most half of the cache, leaving room for what's being read */
+	chd->readahead = MIN(readahead, hunks / 2);
+	chd->lastread = ~0;
+	chd->aheadnext = 1;
+	chd->aheadlast = 0;
+	if (hunks == 0)
+		return CHDERR_NONE;
+
+	/* allocate the entries and link them up in order */
+	chd->lrulist = (lru_entry *)malloc(hunks * sizeof(chd->lrulist[0]));
+	if (chd->lrulist == NULL)
+		return CHDERR_OUT_OF_MEMORY;
+	memset(chd->lrulist, 0, hunks * sizeof(chd->lrulist[0]));
+	for (entnum = 0; entnum < hunks; entnum++)
+	{
+		lru_entry *entry = &chd->lrulist[entnum];
+		entry->prev = (entnum == 0) ? NULL : &chd->lrulist[entnum - 1];
+		entry->next = (entnum == hunks - 1) ? NULL : &chd->lrulist[entnum + 1];
+		entry->hunknum = ~0;
+		entry->state = LRU_STATE_EMPTY;
+	}
+	chd->lruhead = &chd->lrulist[0];
+	chd->lrutail = &chd->lrulist[hunks - 1];
+	chd->lrucount = hunks;
+	return CHDERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    lru_free - free the LRU cache
+-------------------------------------------------*/
+
+static void lru_free(chd_file *chd)
+{
+	UINT32 entnum;
+
+	if (chd->lrulist == NULL)
+		return;
+	for (entnum = 0; entnum < chd->lrucount; entnum++)
+		if (chd->lrulist[entnum].data != NULL)
+			free(chd->lrulist[entnum].data);
+	free(chd->lrulist);
+	chd->lrulist = NULL;
+	chd->lruhead = chd->lrutail = NULL;
+	chd->lrucount = 0;
+}
+
+
+/*-------------------------------------------------
+    lru_flush - forget every cached hunk; only
+    called with no reads in flight
+-------------------------------------------------*/
+
+static void lru_flush(chd_file *chd)
+{
+	UINT32 entnum;
+
+	if (chd->lrulist == NULL)
+		return;
+	osd_lock_acquire(chd->lrulock);
+	for (entnum = 0; entnum < chd->lrucount; entnum++)
+	{
+		chd->lrulist[entnum].hunknum = ~0;
+		chd->lrulist[entnum].state = LRU_STATE_EMPTY;
+		chd->lrulist[entnum].prefetched = FALSE;
+	}
+	osd_lock_release(chd->lrulock);
+}
+
+
+/*-------------------------------------------------
+    lru_touch - move an entry to the front of
+    the LRU list
+-------------------------------------------------*/
+
+static void lru_touch(chd_file *chd, lru_entry *entry)
+{
+	if (entry == chd->lruhead)
+		return;
+
+	/* unlink */
+	entry->prev->next = entry->next;
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	else
+		chd->lrutail = entry->prev;
+
+	/* relink at the head */
+	entry->prev = NULL;
+	entry->next = chd->lruhead;
+	chd->lruhead->prev = entry;
+	chd->lruhead = entry;
+}
+
+
+/*-------------------------------------------------
+    lru_find - find the entry holding (or
+    loading) a hunk; called with the cache lock
+    held
+-------------------------------------------------*/
+
+static lru_entry *lru_find(chd_file *chd, UINT32 hunknum)
+{
+	lru_entry *entry;
+
+	for (entry = chd->lruhead; entry != NULL; entry = entry->next)
+		if (entry->hunknum == hunknum && entry->state != LRU_STATE_EMPTY)
+			return entry;
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    lru_reserve - claim the least recently used
+    idle entry for a hunk and mark it loading;
+    called with the cache lock held
+-------------------------------------------------*/
+
+static lru_entry *lru_reserve(chd_file *chd, UINT32 hunknum)
+{
+	lru_entry *entry;
+
+	/* find the oldest entry nobody is filling */
+	for (entry = chd->lrutail; entry != NULL; entry = entry->prev)
+		if (entry->state != LRU_STATE_LOADING)
+			break;
+	if (entry == NULL)
+		return NULL;
+
+	/* make sure it has somewhere to put the data */
+	if (entry->data == NULL)
+	{
+		entry->data = (UINT8 *)malloc(chd->header.hunkbytes);
+		if (entry->data == NULL)
+			return NULL;
+	}
+
+	entry->hunknum = hunknum;
+	entry->state = LRU_STATE_LOADING;
+	entry->prefetched = FALSE;
+	lru_touch(chd, entry);
+	return entry;
+}
+
+
+/*-------------------------------------------------
+    lru_load - decompress a hunk into a reserved
+    entry; called with the cache lock held, which
+    is dropped while decompressing
+-------------------------------------------------*/
+
+static chd_error lru_load(chd_file *chd, lru_entry *entry, UINT32 hunknum)
+{
+	chd_error err;
+
+	/* take the file before letting go of the cache, so anyone who */
+	/* finds the entry loading can wait for it on the file lock */
+	osd_lock_acquire(chd->filelock);
+	osd_lock_release(chd->lrulock);
+	err = hunk_read_into_memory(chd, hunknum, entry->data);
+	osd_lock_release(chd->filelock);
+	osd_lock_acquire(chd->lrulock);
+
+	/* mark the result */
+	if (err == CHDERR_NONE)
+		entry->state = LRU_STATE_VALID;
+	else
+	{
+		entry->hunknum = ~0;
+		entry->state = LRU_STATE_EMPTY;
+	}
+	return err;
+}
+
+
+/*-------------------------------------------------
+    readahead_schedule - extend the read-ahead
+    window after a read; called with the cache
+    lock held
+-------------------------------------------------*/
+
+static void readahead_schedule(chd_file *chd, UINT32 hunknum)
+{
+	UINT32 remaining = chd->header.totalhunks - 1 - hunknum;
+	UINT32 last;
+
+	/* random access stops read-ahead */
+	if (hunknum != chd->lastread + 1)
+	{
+		chd->aheadnext = chd->aheadlast + 1;
+		return;
+	}
+
+	/* slide the window along, restarting it if we've jumped; a live window is */
+	/* only ever extended, so a prefetched range isn't cut short */
+	last = hunknum + MIN(remaining, chd->readahead);
+	if (chd->aheadnext <= hunknum || chd->aheadnext > chd->aheadlast + 1)
+		chd->aheadnext = hunknum + 1;
+	if (chd->aheadnext > chd->aheadlast || last > chd->aheadlast)
+		chd->aheadlast = last;
+	readahead_start(chd);
+}
+
+
+/*-------------------------------------------------
+    readahead_start - queue the read-ahead worker
+    if there is anything left in the window;
+    called with the cache lock held
+-------------------------------------------------*/
+
+static void readahead_start(chd_file *chd)
+{
+	if (chd->aheadactive || chd->aheadnext > chd->aheadlast)
+		return;
+
+	/* if no queue yet, create one on the fly */
+	if (chd->aheadqueue == NULL)
+	{
+		chd->aheadqueue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+		if (chd->aheadqueue == NULL)
+			return;
+	}
+
+	/* one work item walks the whole window */
+	chd->aheadactive = TRUE;
+	osd_work_item_queue(chd->aheadqueue, readahead_callback, chd, WORK_ITEM_FLAG_AUTO_RELEASE);
+}
+
+
+/*-------------------------------------------------
+    lru_read - read a hunk through the LRU cache
+-------------------------------------------------*/
+
+static chd_error lru_read(chd_file *chd, UINT32 hunknum, UINT8 *dest)
+{
+	chd_error err = CHDERR_NONE;
+	lru_entry *entry;
+
+	/* without a cache or a destination (A/V hunks), go straight to the file */
+	if (chd->lrulist == NULL || dest == NULL)
+		return hunk_read_into_memory(chd, hunknum, dest);
+
+	osd_lock_acquire(chd->lrulock);
+
+	/* if someone is decompressing this hunk, wait on the file lock they hold */
+	entry = lru_find(chd, hunknum);
+	while (entry != NULL && entry->state == LRU_STATE_LOADING)
+	{
+		osd_lock_release(chd->lrulock);
+		osd_lock_acquire(chd->filelock);
+		osd_lock_release(chd->filelock);
+		osd_lock_acquire(chd->lrulock);
+		entry = lru_find(chd, hunknum);
+	}
+
+	/* a hit just moves to the front */
+	if (entry != NULL)
+	{
+		chd->stats.hits++;
+		if (entry->prefetched)
+		{
+			chd->stats.prefetch_hits++;
+			entry->prefetched = FALSE;
+		}
+		lru_touch(chd, entry);
+	}
+
+	/* a miss decompresses into the oldest entry */
+	else
+	{
+		chd->stats.misses++;
+		entry = lru_reserve(chd, hunknum);
+		if (entry == NULL)
+		{
+			osd_lock_release(chd->lrulock);
+			return hunk_read_into_memory(chd, hunknum, dest);
+		}
+		err = lru_load(chd, entry, hunknum);
+	}
+
+	/* copy out while we still hold the lock, so the entry can't be reused under us */
+	if (err == CHDERR_NONE)
+		memcpy(dest, entry->data, chd->header.hunkbytes);
+
+	/* keep read-ahead going while reads are sequential */
+	if (chd->readahead > 0)
+		readahead_schedule(chd, hunknum);
+	chd->lastread = hunknum;
+
+	osd_lock_release(chd->lrulock);
+	return err;
+}
+
+
+
 /***************************************************************************
     INTERNAL MAP ACCESS
 ***************************************************************************/
@@ -3087,3 +3968,77 @@ static chd_error av_codec_postinit(chd_file *chd)
 	avcomp_config_decompress(data->compstate, &data->decompress);
 	return CHDERR_NONE;
 }
+
+
+/*-------------------------------------------------
+    av_codec_pack - pack the frame described by
+    the compression configuration into raw form,
+    so it can be compressed after the caller's
+    buffers have moved on; returns FALSE if it
+    won't fit
+-------------------------------------------------*/
+
+static int av_codec_pack(chd_file *chd, UINT8 *dest)
+{
+	av_codec_data *data = (av_codec_data *)chd->codecdata;
+	const av_codec_compress_config *config = &data->compress;
+	UINT32 width = 0, height = 0, size, x, y, chnum, sampnum;
+	UINT8 *out;
+
+	/* anything odd is left for the serial path to accept or reject */
+	if (config->video != NULL)
+	{
+		width = config->video->width;
+		height = config->video->height;
+	}
+	if (config->metalength > 255 || (config->metadata == NULL) != (config->metalength == 0))
+		return FALSE;
+	if (config->channels > ARRAY_LENGTH(config->audio) || config->samples > 65535 || width > 65535 || height > 65535)
+		return FALSE;
+	size = 12 + config->metalength + 2 * config->channels * config->samples + 2 * width * height;
+	if (size > chd->header.hunkbytes)
+		return FALSE;
+
+	/* header */
+	dest[0] = 'c';
+	dest[1] = 'h';
+	dest[2] = 'a';
+	dest[3] = 'v';
+	dest[4] = config->metalength;
+	dest[5] = config->channels;
+	dest[6] = config->samples >> 8;
+	dest[7] = config->samples;
+	dest[8] = width >> 8;
+	dest[9] = width;
+	dest[10] = height >> 8;
+	dest[11] = height;
+	out = &dest[12];
+
+	/* metadata */
+	if (config->metalength > 0)
+		memcpy(out, config->metadata, config->metalength);
+	out += config->metalength;
+
+	/* audio, big-endian */
+	for (chnum = 0; chnum < config->channels; chnum++)
+		for (sampnum = 0; sampnum < config->samples; sampnum++)
+		{
+			*out++ = config->audio[chnum][sampnum] >> 8;
+			*out++ = config->audio[chnum][sampnum];
+		}
+
+	/* video, big-endian */
+	for (y = 0; y < height; y++)
+	{
+		const UINT16 *src = (const UINT16 *)config->video->base + y * config->video->rowpixels;
+		for (x = 0; x < width; x++)
+		{
+			*out++ = src[x] >> 8;
+			*out++ = src[x];
+		}
+	}
+
+	/* short frames must be padded with 0 */
+	memset(out, 0, chd->header.hunkbytes - size);
+	return TRUE;
+}
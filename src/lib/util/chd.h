@@ -196,6 +196,11 @@
 #define CHD_OPEN_READ				1
 #define CHD_OPEN_READWRITE			2
 
+/* decompressed hunk cache defaults */
+#define CHD_DEFAULT_CACHE_HUNKS		16			/* hunks kept decompressed */
+#define CHD_DEFAULT_READAHEAD		4			/* hunks decompressed ahead of sequential reads */
+#define CHD_MAX_CACHE_HUNKS			256
+
 /* error types */
 enum _chd_error
 {
@@ -276,6 +281,17 @@ struct _chd_verify_result
 };
 
 
+/* structure for returning hunk cache statistics */
+typedef struct _chd_stats chd_stats;
+struct _chd_stats
+{
+	UINT64		hits;						/* reads satisfied from the cache */
+	UINT64		misses;						/* reads that had to decompress */
+	UINT64		prefetched;					/* hunks decompressed by read-ahead */
+	UINT64		prefetch_hits;				/* hits on hunks that read-ahead brought in */
+};
+
+
 
 /***************************************************************************
     FUNCTION PROTOTYPES
@@ -337,6 +353,15 @@ chd_error chd_write_async(chd_file *chd, UINT32 hunknum, const void *buffer);
 /* wait for a previously issued async read/write to complete and return the error */
 chd_error chd_async_complete(chd_file *chd);
 
+/* size the decompressed hunk cache and the sequential read-ahead depth; 0 hunks disables caching */
+chd_error chd_set_cache(chd_file *chd, UINT32 hunks, UINT32 readahead);
+
+/* start decompressing a range of hunks into the cache ahead of reads that are known to be coming */
+chd_error chd_prefetch(chd_file *chd, UINT32 hunknum, UINT32 count);
+
+/* return hit/miss statistics for the hunk cache */
+void chd_get_stats(chd_file *chd, chd_stats *stats);
+
 
 
 /* ----- metadata management ----- */
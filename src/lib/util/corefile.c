@@ -715,6 +715,24 @@ const void *core_fbuffer(core_file *file)
 }
 
 
+/*-------------------------------------------------
+    core_fmap - map the file data into memory
+    in place of reading it; only plain files on
+    disk can be mapped
+-------------------------------------------------*/
+
+file_error core_fmap(core_file *file, osd_file_mapping **mapping, void **base)
+{
+	/* RAM-based, compressed and already-buffered files have nothing to map */
+	if (file->file == NULL || file->zdata != NULL || file->data != NULL)
+		return FILERR_FAILURE;
+	if (file->length > 0xffffffff)
+		return FILERR_FAILURE;
+
+	return osd_map(file->file, 0, file->length, mapping, base);
+}
+
+
 /*-------------------------------------------------
     core_fload - open a file with the specified
     filename, read it into memory, and return a
@@ -0,0 +1,676 @@
+/***************************************************************************
+
+    flacenc.c
+
+    Simple lossless FLAC encoder for 16-bit audio.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************
+
+    The encoder produces a standard FLAC stream using only the simple
+    tools of the format: constant, verbatim and fixed-predictor
+    subframes, Rice-coded residuals with partitioning, and left/side,
+    side/right or mid/side decorrelation for stereo. That gets most of
+    the compression of a full encoder on emulated audio (which tends to
+    be quiet, band-limited or outright silent) at a fraction of the cost.
+
+    For each channel, every fixed predictor order is tried, and for each
+    order the best partitioning and Rice parameters are chosen from the
+    residual sums. The cost estimates are upper bounds on the real coded
+    size, so the cheapest plan never ends up bigger than storing the
+    samples verbatim.
+
+***************************************************************************/
+
+#include "flacenc.h"
+#include "md5.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define MAX_CHANNELS			8
+#define MAX_FIXED_ORDER			4
+#define MAX_PARTITION_ORDER		8
+#define MAX_RICE_PARAM			14
+
+/* subframe types */
+#define SUBFRAME_CONSTANT		0x00
+#define SUBFRAME_VERBATIM		0x01
+#define SUBFRAME_FIXED			0x08
+
+/* stereo channel assignments */
+#define ASSIGN_LEFT_SIDE		8
+#define ASSIGN_SIDE_RIGHT		9
+#define ASSIGN_MID_SIDE			10
+
+/* indexes of the extra stereo channels in the work buffers */
+#define CHANNEL_MID				MAX_CHANNELS
+#define CHANNEL_SIDE			(MAX_CHANNELS + 1)
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _bit_writer bit_writer;
+struct _bit_writer
+{
+	UINT8 *				dest;				/* output buffer */
+	UINT32				offset;				/* bytes written so far */
+	UINT64				accum;				/* pending bits */
+	int					bits;				/* number of pending bits */
+};
+
+
+typedef struct _subframe_plan subframe_plan;
+struct _subframe_plan
+{
+	UINT64				bits;				/* coded size, including the subframe header */
+	int					type;				/* one of the SUBFRAME_* types */
+	int					order;				/* predictor order */
+	int					partition_order;	/* log2 of the number of residual partitions */
+	UINT8				param[1 << MAX_PARTITION_ORDER]; /* Rice parameter per partition */
+};
+
+
+struct _flac_encoder
+{
+	int					sample_rate;		/* sample rate in Hz */
+	int					channels;			/* number of interleaved channels */
+	int					blocksize;			/* nominal block size */
+	UINT32				frames;				/* number of frames encoded */
+	UINT64				total_samples;		/* samples per channel encoded */
+	UINT32				min_frame_bytes;	/* smallest frame so far */
+	UINT32				max_frame_bytes;	/* largest frame so far */
+	struct MD5Context	md5;				/* signature of the raw audio */
+	INT32 *				sample[MAX_CHANNELS + 2]; /* deinterleaved channels, then mid and side */
+	INT32 *				residual;			/* predictor output */
+	UINT8 *				raw;				/* little-endian copy of the input for the signature */
+	subframe_plan		plan[MAX_CHANNELS + 2];
+};
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+static UINT8 crc8_table[256];
+static UINT16 crc16_table[256];
+
+
+
+/***************************************************************************
+    BIT WRITER
+***************************************************************************/
+
+/*-------------------------------------------------
+    bits_put - append the low 'count' bits of
+    'value', most significant first; count must
+    be 32 or less
+-------------------------------------------------*/
+
+INLINE void bits_put(bit_writer *writer, UINT32 value, int count)
+{
+	if (count == 0)
+		return;
+	writer->accum = (writer->accum << count) | (value & (0xffffffffU >> (32 - count)));
+	writer->bits += count;
+	while (writer->bits >= 8)
+	{
+		writer->bits -= 8;
+		writer->dest[writer->offset++] = writer->accum >> writer->bits;
+	}
+}
+
+
+/*-------------------------------------------------
+    bits_put_zeros - append a run of zero bits
+-------------------------------------------------*/
+
+INLINE void bits_put_zeros(bit_writer *writer, UINT32 count)
+{
+	for ( ; count > 32; count -= 32)
+		bits_put(writer, 0, 32);
+	bits_put(writer, 0, count);
+}
+
+
+/*-------------------------------------------------
+    bits_flush - pad with zeros to a byte
+    boundary
+-------------------------------------------------*/
+
+INLINE void bits_flush(bit_writer *writer)
+{
+	if (writer->bits != 0)
+		bits_put(writer, 0, 8 - writer->bits);
+}
+
+
+
+/***************************************************************************
+    CHECKSUMS
+***************************************************************************/
+
+/*-------------------------------------------------
+    build_crc_tables - build the CRC-8 (poly 0x07)
+    and CRC-16 (poly 0x8005) tables used by the
+    frame headers and footers
+-------------------------------------------------*/
+
+static void build_crc_tables(void)
+{
+	int byte, bit;
+
+	for (byte = 0; byte < 256; byte++)
+	{
+		UINT8 value8 = byte;
+		UINT16 value16 = byte << 8;
+		for (bit = 0; bit < 8; bit++)
+		{
+			value8 = (value8 & 0x80) ? ((value8 << 1) ^ 0x07) : (value8 << 1);
+			value16 = (value16 & 0x8000) ? ((value16 << 1) ^ 0x8005) : (value16 << 1);
+		}
+		crc8_table[byte] = value8;
+		crc16_table[byte] = value16;
+	}
+}
+
+
+static UINT8 crc8(const UINT8 *data, UINT32 length)
+{
+	UINT8 crc = 0;
+	while (length--)
+		crc = crc8_table[crc ^ *data++];
+	return crc;
+}
+
+
+static UINT16 crc16(const UINT8 *data, UINT32 length)
+{
+	UINT16 crc = 0;
+	while (length--)
+		crc = (crc << 8) ^ crc16_table[(crc >> 8) ^ *data++];
+	return crc;
+}
+
+
+
+/***************************************************************************
+    PREDICTION AND PLANNING
+***************************************************************************/
+
+/*-------------------------------------------------
+    fixed_residual - compute the residual of one
+    of the fixed polynomial predictors
+-------------------------------------------------*/
+
+static void fixed_residual(const INT32 *x, int samples, int order, INT32 *residual)
+{
+	int i;
+
+	switch (order)
+	{
+		case 0:
+			for (i = 0; i < samples; i++)
+				residual[i] = x[i];
+			break;
+
+		case 1:
+			for (i = 1; i < samples; i++)
+				residual[i] = x[i] - x[i - 1];
+			break;
+
+		case 2:
+			for (i = 2; i < samples; i++)
+				residual[i] = x[i] - 2 * x[i - 1] + x[i - 2];
+			break;
+
+		case 3:
+			for (i = 3; i < samples; i++)
+				residual[i] = x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+			break;
+
+		case 4:
+			for (i = 4; i < samples; i++)
+				residual[i] = x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4];
+			break;
+	}
+}
+
+
+/*-------------------------------------------------
+    rice_fold - map a signed residual onto the
+    unsigned values Rice coding works with
+-------------------------------------------------*/
+
+INLINE UINT32 rice_fold(INT32 value)
+{
+	return ((UINT32)value << 1) ^ (UINT32)(value >> 31);
+}
+
+
+/*-------------------------------------------------
+    rice_cost - pick the Rice parameter for a
+    partition of 'count' values summing to 'sum';
+    the returned size bounds the real one since
+    the sum of the quotients is at most sum >> k
+-------------------------------------------------*/
+
+static UINT64 rice_cost(UINT64 sum, UINT32 count, UINT8 *param)
+{
+	UINT64 best = ~(UINT64)0;
+	int k;
+
+	for (k = 0; k <= MAX_RICE_PARAM; k++)
+	{
+		UINT64 bits = (UINT64)count * (k + 1) + (sum >> k);
+		if (bits < best)
+		{
+			best = bits;
+			*param = k;
+		}
+	}
+	return best + 4;
+}
+
+
+/*-------------------------------------------------
+    plan_subframe - choose the cheapest way to
+    code one channel
+-------------------------------------------------*/
+
+static void plan_subframe(flac_encoder *encoder, const INT32 *x, int samples, int bps, subframe_plan *plan)
+{
+	UINT64 sums[2 << MAX_PARTITION_ORDER];
+	subframe_plan trial;
+	int i, order;
+
+	/* silence and DC are common enough to special-case */
+	for (i = 1; i < samples; i++)
+		if (x[i] != x[0])
+			break;
+	if (i == samples)
+	{
+		plan->type = SUBFRAME_CONSTANT;
+		plan->bits = 8 + bps;
+		return;
+	}
+
+	/* fall back to verbatim if nothing beats it */
+	plan->type = SUBFRAME_VERBATIM;
+	plan->bits = 8 + (UINT64)samples * bps;
+
+	for (order = 0; order <= MAX_FIXED_ORDER && order < samples; order++)
+	{
+		int maxporder, porder, part;
+
+		fixed_residual(x, samples, order, encoder->residual);
+
+		/* find the finest legal partitioning */
+		for (maxporder = 0; maxporder < MAX_PARTITION_ORDER; maxporder++)
+			if ((samples & ((2 << maxporder) - 1)) != 0 || (samples >> (maxporder + 1)) <= order)
+				break;
+
+		/* sum the folded residuals per partition at that level... */
+		for (part = 0; part < (1 << maxporder); part++)
+		{
+			int start = (part == 0) ? order : part * (samples >> maxporder);
+			int end = (part + 1) * (samples >> maxporder);
+			UINT64 sum = 0;
+			for (i = start; i < end; i++)
+				sum += rice_fold(encoder->residual[i]);
+			sums[(1 << maxporder) + part] = sum;
+		}
+
+		/* ...then merge pairs to get the coarser levels, stored heap-style */
+		for (part = (1 << maxporder) - 1; part > 0; part--)
+			sums[part] = sums[part * 2] + sums[part * 2 + 1];
+
+		/* cost each partitioning */
+		for (porder = 0; porder <= maxporder; porder++)
+		{
+			UINT64 bits = 8 + (UINT64)order * bps + 6;
+			for (part = 0; part < (1 << porder); part++)
+			{
+				UINT32 count = (samples >> porder) - ((part == 0) ? order : 0);
+				bits += rice_cost(sums[(1 << porder) + part], count, &trial.param[part]);
+			}
+			if (bits < plan->bits)
+			{
+				trial.bits = bits;
+				trial.type = SUBFRAME_FIXED;
+				trial.order = order;
+				trial.partition_order = porder;
+				*plan = trial;
+			}
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+    write_subframe - code one channel according
+    to its plan
+-------------------------------------------------*/
+
+static void write_subframe(flac_encoder *encoder, bit_writer *writer, const INT32 *x, int samples, int bps, const subframe_plan *plan)
+{
+	int i, part;
+
+	switch (plan->type)
+	{
+		case SUBFRAME_CONSTANT:
+			bits_put(writer, SUBFRAME_CONSTANT << 1, 8);
+			bits_put(writer, x[0], bps);
+			break;
+
+		case SUBFRAME_VERBATIM:
+			bits_put(writer, SUBFRAME_VERBATIM << 1, 8);
+			for (i = 0; i < samples; i++)
+				bits_put(writer, x[i], bps);
+			break;
+
+		case SUBFRAME_FIXED:
+			bits_put(writer, (SUBFRAME_FIXED | plan->order) << 1, 8);
+			for (i = 0; i < plan->order; i++)
+				bits_put(writer, x[i], bps);
+
+			/* residual: 4-bit Rice parameters, then the partitions */
+			fixed_residual(x, samples, plan->order, encoder->residual);
+			bits_put(writer, 0, 2);
+			bits_put(writer, plan->partition_order, 4);
+			for (part = 0; part < (1 << plan->partition_order); part++)
+			{
+				int k = plan->param[part];
+				int start = (part == 0) ? plan->order : part * (samples >> plan->partition_order);
+				int end = (part + 1) * (samples >> plan->partition_order);
+
+				bits_put(writer, k, 4);
+				for (i = start; i < end; i++)
+				{
+					UINT32 value = rice_fold(encoder->residual[i]);
+					UINT32 quotient = value >> k;
+
+					/* unary quotient, stop bit and the low bits, in one go when they fit */
+					if (quotient + 1 + k <= 32)
+						bits_put(writer, (1 << k) | (value & ((1 << k) - 1)), quotient + 1 + k);
+					else
+					{
+						bits_put_zeros(writer, quotient);
+						bits_put(writer, (1 << k) | (value & ((1 << k) - 1)), 1 + k);
+					}
+				}
+			}
+			break;
+	}
+}
+
+
+
+/***************************************************************************
+    PUBLIC INTERFACE
+***************************************************************************/
+
+/*-------------------------------------------------
+    flac_encoder_alloc - create an encoder for
+    interleaved 16-bit samples
+-------------------------------------------------*/
+
+flac_encoder *flac_encoder_alloc(int sample_rate, int channels, int blocksize)
+{
+	flac_encoder *encoder;
+	int chnum;
+
+	if (channels < 1 || channels > MAX_CHANNELS || blocksize < 16 || blocksize > FLACENC_MAX_BLOCK || sample_rate <= 0 || sample_rate >= (1 << 20))
+		return NULL;
+
+	encoder = (flac_encoder *)malloc(sizeof(*encoder));
+	if (encoder == NULL)
+		return NULL;
+	memset(encoder, 0, sizeof(*encoder));
+
+	encoder->sample_rate = sample_rate;
+	encoder->channels = channels;
+	encoder->blocksize = blocksize;
+	MD5Init(&encoder->md5);
+
+	/* allocate the work buffers */
+	for (chnum = 0; chnum < MAX_CHANNELS + 2; chnum++)
+		if (chnum < channels || (channels == 2 && chnum >= MAX_CHANNELS))
+		{
+			encoder->sample[chnum] = (INT32 *)malloc(blocksize * sizeof(INT32));
+			if (encoder->sample[chnum] == NULL)
+				goto error;
+		}
+	encoder->residual = (INT32 *)malloc(blocksize * sizeof(INT32));
+	encoder->raw = (UINT8 *)malloc(blocksize * channels * 2);
+	if (encoder->residual == NULL || encoder->raw == NULL)
+		goto error;
+
+	/* the tables are constant, so rebuilding them is harmless */
+	build_crc_tables();
+	return encoder;
+
+error:
+	flac_encoder_free(encoder);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    flac_encoder_free - free an encoder
+-------------------------------------------------*/
+
+void flac_encoder_free(flac_encoder *encoder)
+{
+	int chnum;
+
+	for (chnum = 0; chnum < MAX_CHANNELS + 2; chnum++)
+		if (encoder->sample[chnum] != NULL)
+			free(encoder->sample[chnum]);
+	if (encoder->residual != NULL)
+		free(encoder->residual);
+	if (encoder->raw != NULL)
+		free(encoder->raw);
+	free(encoder);
+}
+
+
+/*-------------------------------------------------
+    flac_encoder_max_frame_bytes - return the
+    worst-case size of an encoded frame: header,
+    verbatim subframes (one bit wider for side
+    channels) and footer
+-------------------------------------------------*/
+
+UINT32 flac_encoder_max_frame_bytes(flac_encoder *encoder)
+{
+	return 16 + encoder->channels * (2 + (encoder->blocksize * 17 + 7) / 8) + 2;
+}
+
+
+/*-------------------------------------------------
+    flac_encoder_header - build the "fLaC" marker
+    and STREAMINFO block describing what has been
+    encoded so far
+-------------------------------------------------*/
+
+void flac_encoder_header(flac_encoder *encoder, UINT8 *dest)
+{
+	bit_writer writer = { dest, 0, 0, 0 };
+
+	memcpy(dest, "fLaC", 4);
+	writer.offset = 4;
+
+	/* metadata block header: last block, STREAMINFO, 34 bytes */
+	bits_put(&writer, 0x80, 8);
+	bits_put(&writer, 34, 24);
+
+	bits_put(&writer, encoder->blocksize, 16);
+	bits_put(&writer, encoder->blocksize, 16);
+	bits_put(&writer, encoder->min_frame_bytes, 24);
+	bits_put(&writer, encoder->max_frame_bytes, 24);
+	bits_put(&writer, encoder->sample_rate, 20);
+	bits_put(&writer, encoder->channels - 1, 3);
+	bits_put(&writer, 16 - 1, 5);
+	bits_put(&writer, (UINT32)(encoder->total_samples >> 32), 4);
+	bits_put(&writer, (UINT32)encoder->total_samples, 32);
+
+	/* the signature is only meaningful once there is audio; zero means unknown */
+	if (encoder->total_samples != 0)
+	{
+		struct MD5Context md5 = encoder->md5;
+		MD5Final(&dest[writer.offset], &md5);
+	}
+	else
+		memset(&dest[writer.offset], 0, 16);
+}
+
+
+/*-------------------------------------------------
+    flac_encoder_frame - encode one block of
+    interleaved samples into a frame
+-------------------------------------------------*/
+
+UINT32 flac_encoder_frame(flac_encoder *encoder, const INT16 *data, int samples, UINT8 *dest)
+{
+	int channels = encoder->channels;
+	bit_writer writer = { dest, 0, 0, 0 };
+	int assignment = channels - 1;
+	int chnum, i, code;
+	UINT32 number, length;
+	UINT16 crc;
+
+	if (samples <= 0 || samples > encoder->blocksize)
+		return 0;
+
+	/* deinterleave, and keep a little-endian copy for the signature */
+	for (i = 0; i < samples; i++)
+		for (chnum = 0; chnum < channels; chnum++)
+		{
+			INT16 value = data[i * channels + chnum];
+			encoder->sample[chnum][i] = value;
+			encoder->raw[(i * channels + chnum) * 2 + 0] = value;
+			encoder->raw[(i * channels + chnum) * 2 + 1] = value >> 8;
+		}
+	MD5Update(&encoder->md5, encoder->raw, samples * channels * 2);
+
+	/* plan each channel; for stereo, also try the decorrelated pairs */
+	for (chnum = 0; chnum < channels; chnum++)
+		plan_subframe(encoder, encoder->sample[chnum], samples, 16, &encoder->plan[chnum]);
+	if (channels == 2)
+	{
+		INT32 *left = encoder->sample[0], *right = encoder->sample[1];
+		INT32 *mid = encoder->sample[CHANNEL_MID], *side = encoder->sample[CHANNEL_SIDE];
+		UINT64 best;
+
+		for (i = 0; i < samples; i++)
+		{
+			mid[i] = (left[i] + right[i]) >> 1;
+			side[i] = left[i] - right[i];
+		}
+		plan_subframe(encoder, mid, samples, 16, &encoder->plan[CHANNEL_MID]);
+		plan_subframe(encoder, side, samples, 17, &encoder->plan[CHANNEL_SIDE]);
+
+		best = encoder->plan[0].bits + encoder->plan[1].bits;
+		if (encoder->plan[0].bits + encoder->plan[CHANNEL_SIDE].bits < best)
+		{
+			best = encoder->plan[0].bits + encoder->plan[CHANNEL_SIDE].bits;
+			assignment = ASSIGN_LEFT_SIDE;
+		}
+		if (encoder->plan[CHANNEL_SIDE].bits + encoder->plan[1].bits < best)
+		{
+			best = encoder->plan[CHANNEL_SIDE].bits + encoder->plan[1].bits;
+			assignment = ASSIGN_SIDE_RIGHT;
+		}
+		if (encoder->plan[CHANNEL_MID].bits + encoder->plan[CHANNEL_SIDE].bits < best)
+			assignment = ASSIGN_MID_SIDE;
+	}
+
+	/* frame header: sync, fixed-blocksize stream */
+	bits_put(&writer, 0xfff8, 16);
+
+	/* block size code, using an explicit size for anything unusual */
+	if (samples == 192)
+		code = 1;
+	else if (samples == 576 || samples == 1152 || samples == 2304 || samples == 4608)
+		code = 2 + ((samples == 1152) ? 1 : (samples == 2304) ? 2 : (samples == 4608) ? 3 : 0);
+	else if ((samples & (samples - 1)) == 0 && samples >= 256 && samples <= 32768)
+	{
+		for (code = 8; (256 << (code - 8)) != samples; code++) ;
+	}
+	else
+		code = (samples <= 256) ? 6 : 7;
+	bits_put(&writer, code, 4);
+
+	/* sample rate comes from STREAMINFO; channels; 16 bits per sample */
+	bits_put(&writer, 0, 4);
+	bits_put(&writer, assignment, 4);
+	bits_put(&writer, 4, 3);
+	bits_put(&writer, 0, 1);
+
+	/* frame number, UTF-8 style */
+	number = encoder->frames;
+	if (number < 0x80)
+		bits_put(&writer, number, 8);
+	else
+	{
+		int extra = (number < 0x800) ? 1 : (number < 0x10000) ? 2 : (number < 0x200000) ? 3 : (number < 0x4000000) ? 4 : 5;
+		bits_put(&writer, (0xff00 >> (extra + 1)) | (number >> (6 * extra)), 8);
+		while (extra-- > 0)
+			bits_put(&writer, 0x80 | ((number >> (6 * extra)) & 0x3f), 8);
+	}
+	if (code == 6)
+		bits_put(&writer, samples - 1, 8);
+	else if (code == 7)
+		bits_put(&writer, samples - 1, 16);
+	bits_put(&writer, crc8(dest, writer.offset), 8);
+
+	/* subframes */
+	switch (assignment)
+	{
+		case ASSIGN_LEFT_SIDE:
+			write_subframe(encoder, &writer, encoder->sample[0], samples, 16, &encoder->plan[0]);
+			write_subframe(encoder, &writer, encoder->sample[CHANNEL_SIDE], samples, 17, &encoder->plan[CHANNEL_SIDE]);
+			break;
+
+		case ASSIGN_SIDE_RIGHT:
+			write_subframe(encoder, &writer, encoder->sample[CHANNEL_SIDE], samples, 17, &encoder->plan[CHANNEL_SIDE]);
+			write_subframe(encoder, &writer, encoder->sample[1], samples, 16, &encoder->plan[1]);
+			break;
+
+		case ASSIGN_MID_SIDE:
+			write_subframe(encoder, &writer, encoder->sample[CHANNEL_MID], samples, 16, &encoder->plan[CHANNEL_MID]);
+			write_subframe(encoder, &writer, encoder->sample[CHANNEL_SIDE], samples, 17, &encoder->plan[CHANNEL_SIDE]);
+			break;
+
+		default:
+			for (chnum = 0; chnum < channels; chnum++)
+				write_subframe(encoder, &writer, encoder->sample[chnum], samples, 16, &encoder->plan[chnum]);
+			break;
+	}
+
+	/* footer */
+	bits_flush(&writer);
+	crc = crc16(dest, writer.offset);
+	bits_put(&writer, crc, 16);
+	length = writer.offset;
+
+	/* update the stream totals */
+	if (encoder->frames == 0 || length < encoder->min_frame_bytes)
+		encoder->min_frame_bytes = length;
+	if (length > encoder->max_frame_bytes)
+		encoder->max_frame_bytes = length;
+	encoder->frames++;
+	encoder->total_samples += samples;
+	return length;
+}
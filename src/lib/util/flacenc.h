@@ -0,0 +1,59 @@
+/***************************************************************************
+
+    flacenc.h
+
+    Simple lossless FLAC encoder for 16-bit audio.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __FLACENC_H__
+#define __FLACENC_H__
+
+#include "osdcore.h"
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+/* size of the "fLaC" marker plus the STREAMINFO block */
+#define FLACENC_HEADER_BYTES		42
+
+/* largest block the encoder accepts, in samples per channel */
+#define FLACENC_MAX_BLOCK			65535
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _flac_encoder flac_encoder;
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+/* create an encoder for interleaved 16-bit samples; every block but the last must be 'blocksize' long */
+flac_encoder *flac_encoder_alloc(int sample_rate, int channels, int blocksize);
+
+/* free an encoder */
+void flac_encoder_free(flac_encoder *encoder);
+
+/* worst-case size of an encoded frame, for sizing the output buffer */
+UINT32 flac_encoder_max_frame_bytes(flac_encoder *encoder);
+
+/* build the stream header; written once up front and again at the end, when the totals are known */
+void flac_encoder_header(flac_encoder *encoder, UINT8 *dest);
+
+/* encode one block of 'samples' interleaved frames, returning the number of bytes written to 'dest' */
+UINT32 flac_encoder_frame(flac_encoder *encoder, const INT16 *data, int samples, UINT8 *dest);
+
+#endif /* __FLACENC_H__ */
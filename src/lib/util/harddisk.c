@@ -53,10 +53,49 @@ struct _hard_disk_file
 	UINT32				hunksectors;		/* sectors per hunk */
 	UINT32				cachehunk;			/* which hunk is cached */
 	UINT8 *				cache;				/* cache of the current hunk */
+	UINT32				pendinghunk;		/* which hunk is being read asynchronously */
+	UINT8 *				pending;			/* buffer for the asynchronous read */
 };
 
 
 
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    swap_in_pending - make the asynchronous read
+    buffer the cached hunk
+-------------------------------------------------*/
+
+INLINE void swap_in_pending(hard_disk_file *file, UINT32 hunknum)
+{
+	UINT8 *temp = file->cache;
+
+	file->cache = file->pending;
+	file->pending = temp;
+	file->cachehunk = hunknum;
+}
+
+
+/*-------------------------------------------------
+    finish_async_read - wait for any asynchronous
+    read to finish and make its hunk the cached
+    one
+-------------------------------------------------*/
+
+INLINE void finish_async_read(hard_disk_file *file)
+{
+	if (file->pendinghunk == ~0)
+		return;
+
+	if (chd_async_complete(file->chd) == CHDERR_NONE)
+		swap_in_pending(file, file->pendinghunk);
+	file->pendinghunk = ~0;
+}
+
+
+
 /***************************************************************************
     CORE IMPLEMENTATION
 ***************************************************************************/
@@ -99,11 +138,17 @@ hard_disk_file *hard_disk_open(chd_file *chd)
 	file->info.sectorbytes = sectorbytes;
 	file->hunksectors = chd_get_header(chd)->hunkbytes / file->info.sectorbytes;
 	file->cachehunk = -1;
+	file->pendinghunk = ~0;
 
-	/* allocate a cache */
+	/* allocate a cache, and a second hunk for asynchronous reads */
 	file->cache = (UINT8 *)malloc(chd_get_header(chd)->hunkbytes);
-	if (file->cache == NULL)
+	file->pending = (UINT8 *)malloc(chd_get_header(chd)->hunkbytes);
+	if (file->cache == NULL || file->pending == NULL)
 	{
+		if (file->cache != NULL)
+			free(file->cache);
+		if (file->pending != NULL)
+			free(file->pending);
 		free(file);
 		return NULL;
 	}
@@ -118,9 +163,14 @@ hard_disk_file *hard_disk_open(chd_file *chd)
 
 void hard_disk_close(hard_disk_file *file)
 {
+	/* let any read in flight land before freeing its buffer */
+	finish_async_read(file);
+
 	/* free the cache */
 	if (file->cache != NULL)
 		free(file->cache);
+	if (file->pending != NULL)
+		free(file->pending);
 	free(file);
 }
 
@@ -157,6 +207,9 @@ UINT32 hard_disk_read(hard_disk_file *file, UINT32 lbasector, void *buffer)
 	UINT32 hunknum = lbasector / file->hunksectors;
 	UINT32 sectoroffs = lbasector % file->hunksectors;
 
+	/* collect any asynchronous read first; it may well be the hunk we want */
+	finish_async_read(file);
+
 	/* if we haven't cached this hunk, read it now */
 	if (file->cachehunk != hunknum)
 	{
@@ -183,6 +236,9 @@ UINT32 hard_disk_write(hard_disk_file *file, UINT32 lbasector, const void *buffe
 	UINT32 sectoroffs = lbasector % file->hunksectors;
 	chd_error err;
 
+	/* collect any asynchronous read first, so it can't land on top of this write */
+	finish_async_read(file);
+
 	/* if we haven't cached this hunk, read it now */
 	if (file->cachehunk != hunknum)
 	{
@@ -199,3 +255,54 @@ UINT32 hard_disk_write(hard_disk_file *file, UINT32 lbasector, const void *buffe
 	err = chd_write(file->chd, hunknum, file->cache);
 	return (err == CHDERR_NONE) ? 1 : 0;
 }
+
+
+/*-------------------------------------------------
+    hard_disk_read_async - start reading the hunk
+    holding a sector in the background; the next
+    hard_disk_read() collects it
+-------------------------------------------------*/
+
+UINT32 hard_disk_read_async(hard_disk_file *file, UINT32 lbasector)
+{
+	UINT32 hunknum = lbasector / file->hunksectors;
+	chd_error err;
+
+	/* nothing to do if it's already here or on its way */
+	if (file->cachehunk == hunknum || file->pendinghunk == hunknum)
+		return 1;
+
+	/* only one asynchronous read may be in flight */
+	finish_async_read(file);
+	if (file->cachehunk == hunknum)
+		return 1;
+
+	err = chd_read_async(file->chd, hunknum, file->pending);
+	if (err == CHDERR_OPERATION_PENDING)
+	{
+		file->pendinghunk = hunknum;
+		return 1;
+	}
+
+	/* if the CHD fell back on a synchronous read, the data is already here */
+	if (err != CHDERR_NONE)
+		return 0;
+	swap_in_pending(file, hunknum);
+	return 1;
+}
+
+
+/*-------------------------------------------------
+    hard_disk_prefetch - hint that a run of
+    sectors is about to be read
+-------------------------------------------------*/
+
+void hard_disk_prefetch(hard_disk_file *file, UINT32 lbasector, UINT32 count)
+{
+	UINT32 firsthunk = lbasector / file->hunksectors;
+	UINT32 lasthunk = (lbasector + count - 1) / file->hunksectors;
+
+	if (count == 0)
+		return;
+	chd_prefetch(file->chd, firsthunk, lasthunk - firsthunk + 1);
+}
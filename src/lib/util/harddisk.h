@@ -76,4 +76,7 @@ hard_disk_info *hard_disk_get_info(hard_disk_file *file);
 UINT32 hard_disk_read(hard_disk_file *file, UINT32 lbasector, void *buffer);
 UINT32 hard_disk_write(hard_disk_file *file, UINT32 lbasector, const void *buffer);
 
+UINT32 hard_disk_read_async(hard_disk_file *file, UINT32 lbasector);
+void hard_disk_prefetch(hard_disk_file *file, UINT32 lbasector, UINT32 count);
+
 #endif	/* __HARDDISK_H__ */
@@ -50,8 +50,8 @@
     CONSTANTS
 ***************************************************************************/
 
-/* number of open files to cache */
-#define ZIP_CACHE_SIZE	8
+/* marks the end of an index chain */
+#define ZIP_INDEX_NONE	0xffffffff
 
 /* offsets in end of central directory structure */
 #define ZIPESIG			0x00
@@ -102,6 +102,25 @@
 
 
 
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* hashed index of a central directory; chains run in directory order */
+struct _zip_index
+{
+	UINT32			entries;				/* number of entries */
+	UINT32			mask;					/* mask for the hash buckets */
+	UINT32 *		offset;					/* central directory offset of each entry */
+	UINT32 *		namehash;				/* hash of each entry's leaf name */
+	UINT32 *		namenext;				/* next entry in the same name bucket */
+	UINT32 *		crcnext;				/* next entry in the same CRC bucket */
+	UINT32 *		namehead;				/* first entry in each name bucket */
+	UINT32 *		crchead;				/* first entry in each CRC bucket */
+};
+
+
+
 /***************************************************************************
     INLINE FUNCTIONS
 ***************************************************************************/
@@ -116,13 +135,38 @@ INLINE UINT32 read_dword(UINT8 *buf)
 	return (buf[3] << 24) | (buf[2] << 16) | (buf[1] << 8) | buf[0];
 }
 
+INLINE UINT32 entry_length(UINT8 *raw)
+{
+	return ZIPCFN + read_word(raw + ZIPCFNL) + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+}
+
+/* hash the part of a name after the last '/', ignoring case */
+INLINE UINT32 leaf_hash(const char *name, int length)
+{
+	UINT32 hash = 0;
+	int start;
+
+	for (start = length; start > 0 && name[start - 1] != '/'; start--) ;
+	for ( ; start < length; start++)
+		hash = hash * 31 + tolower((UINT8)name[start]);
+	return hash;
+}
+
 
 
 /***************************************************************************
     GLOBAL VARIABLES
 ***************************************************************************/
 
-static zip_file *zip_cache[ZIP_CACHE_SIZE];
+/* closed files, most recently closed first */
+static zip_file **zip_cache;
+static int zip_cache_count;
+static int zip_cache_alloc;
+static UINT32 zip_cache_bytes;
+
+/* limits on what the cache keeps */
+static int zip_cache_maxfiles = ZIP_CACHE_DEFAULT_FILES;
+static UINT32 zip_cache_maxbytes = ZIP_CACHE_DEFAULT_BYTES;
 
 
 
@@ -132,9 +176,13 @@ static zip_file *zip_cache[ZIP_CACHE_SIZE];
 
 /* cache management */
 static void free_zip_file(zip_file *zip);
+static UINT32 zip_file_bytes(zip_file *zip);
+static void trim_cache(void);
 
 /* ZIP file parsing */
 static zip_error read_ecd(zip_file *zip);
+static const zip_file_header *read_header(zip_file *zip, UINT32 pos);
+static zip_error build_index(zip_file *zip);
 static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
 
 /* decompression interfaces */
@@ -164,15 +212,16 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 	*zip = NULL;
 
 	/* see if we are in the cache, and reopen if so */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
+	for (cachenum = 0; cachenum < zip_cache_count; cachenum++)
 	{
 		zip_file *cached = zip_cache[cachenum];
 
 		/* if we have a valid entry and it matches our filename, use it and remove from the cache */
-		if (cached != NULL && cached->filename != NULL && strcmp(filename, cached->filename) == 0)
+		if (cached->filename != NULL && strcmp(filename, cached->filename) == 0)
 		{
 			*zip = cached;
-			zip_cache[cachenum] = NULL;
+			zip_cache_bytes -= zip_file_bytes(cached);
+			memmove(&zip_cache[cachenum], &zip_cache[cachenum + 1], (--zip_cache_count - cachenum) * sizeof(zip_cache[0]));
 			return ZIPERR_NONE;
 		}
 	}
@@ -244,26 +293,33 @@ error:
 
 void zip_file_close(zip_file *zip)
 {
-	int cachenum;
-
 	/* close the open files */
 	if (zip->file != NULL)
 		osd_close(zip->file);
 	zip->file = NULL;
 
-	/* find the first NULL entry in the cache */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
-		if (zip_cache[cachenum] == NULL)
-			break;
-
-	/* if no room left in the cache, free the bottommost entry */
-	if (cachenum == ARRAY_LENGTH(zip_cache))
-		free_zip_file(zip_cache[--cachenum]);
+	/* make room for one more entry; if we can't, just free the file */
+	if (zip_cache_count == zip_cache_alloc)
+	{
+		int newalloc = zip_cache_alloc + 16;
+		zip_file **newcache = (zip_file **)realloc(zip_cache, newalloc * sizeof(zip_cache[0]));
+		if (newcache == NULL)
+		{
+			free_zip_file(zip);
+			return;
+		}
+		zip_cache = newcache;
+		zip_cache_alloc = newalloc;
+	}
 
 	/* move everyone else down and place us at the top */
-	if (cachenum != 0)
-		memmove(&zip_cache[1], &zip_cache[0], cachenum * sizeof(zip_cache[0]));
+	memmove(&zip_cache[1], &zip_cache[0], zip_cache_count * sizeof(zip_cache[0]));
 	zip_cache[0] = zip;
+	zip_cache_count++;
+	zip_cache_bytes += zip_file_bytes(zip);
+
+	/* then drop the least recently used files until we fit */
+	trim_cache();
 }
 
 
@@ -277,12 +333,28 @@ void zip_file_cache_clear(void)
 	int cachenum;
 
 	/* clear call cache entries */
-	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
-		if (zip_cache[cachenum] != NULL)
-		{
-			free_zip_file(zip_cache[cachenum]);
-			zip_cache[cachenum] = NULL;
-		}
+	for (cachenum = 0; cachenum < zip_cache_count; cachenum++)
+		free_zip_file(zip_cache[cachenum]);
+
+	if (zip_cache != NULL)
+		free(zip_cache);
+	zip_cache = NULL;
+	zip_cache_count = zip_cache_alloc = 0;
+	zip_cache_bytes = 0;
+}
+
+
+/*-------------------------------------------------
+    zip_file_cache_set_limits - set how many
+    closed ZIP files the cache keeps, and how much
+    memory they may hold between them
+-------------------------------------------------*/
+
+void zip_file_cache_set_limits(int maxfiles, UINT32 maxbytes)
+{
+	zip_cache_maxfiles = MAX(maxfiles, 0);
+	zip_cache_maxbytes = maxbytes;
+	trim_cache();
 }
 
 
@@ -311,56 +383,88 @@ const zip_file_header *zip_file_first_file(zip_file *zip)
 
 const zip_file_header *zip_file_next_file(zip_file *zip)
 {
-	/* fix up any modified data */
-	if (zip->header.raw != NULL)
+	return read_header(zip, zip->cd_pos);
+}
+
+
+/*-------------------------------------------------
+    zip_file_first_named - return the first file
+    whose leaf name matches that of the given
+    filename, using the index
+-------------------------------------------------*/
+
+const zip_file_header *zip_file_first_named(zip_file *zip, const char *filename)
+{
+	/* build the index the first time it is needed */
+	if (zip->index == NULL && build_index(zip) != ZIPERR_NONE)
+		return NULL;
+
+	/* start at the head of the matching bucket */
+	zip->find_key = leaf_hash(filename, strlen(filename));
+	zip->find_entry = zip->index->namehead[zip->find_key & zip->index->mask];
+	return zip_file_next_named(zip);
+}
+
+
+/*-------------------------------------------------
+    zip_file_next_named - return the next file
+    matching an earlier zip_file_first_named
+-------------------------------------------------*/
+
+const zip_file_header *zip_file_next_named(zip_file *zip)
+{
+	zip_index *index = zip->index;
+
+	/* walk the bucket, skipping other names that share it */
+	while (index != NULL && zip->find_entry != ZIP_INDEX_NONE)
 	{
-		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
-		zip->header.raw = NULL;
+		UINT32 entry = zip->find_entry;
+		zip->find_entry = index->namenext[entry];
+		if (index->namehash[entry] == zip->find_key)
+			return read_header(zip, index->offset[entry]);
 	}
+	return NULL;
+}
 
-	/* if we're at or past the end, we're done */
-	if (zip->cd_pos >= zip->ecd.cd_size)
-		return NULL;
 
-	/* extract file header info */
-	zip->header.raw                 = zip->cd + zip->cd_pos;
-	zip->header.rawlength           = ZIPCFN;
-	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
-	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
-	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
-	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
-	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
-	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
-	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
-	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
-	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
-	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
-	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
-	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
-	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
-	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
-	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
-	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
-	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
-	zip->header.filename            = (char *)zip->header.raw + ZIPCFN;
-
-	/* make sure we have enough data */
-	zip->header.rawlength += zip->header.filename_length;
-	zip->header.rawlength += zip->header.extra_field_length;
-	zip->header.rawlength += zip->header.file_comment_length;
-	if (zip->cd_pos + zip->header.rawlength > zip->ecd.cd_size)
-		return NULL;
+/*-------------------------------------------------
+    zip_file_first_crc - return the first file
+    with the given CRC, using the index
+-------------------------------------------------*/
 
-	/* NULL terminate the filename */
-	zip->header.saved = zip->header.raw[ZIPCFN + zip->header.filename_length];
-	zip->header.raw[ZIPCFN + zip->header.filename_length] = 0;
+const zip_file_header *zip_file_first_crc(zip_file *zip, UINT32 crc)
+{
+	/* build the index the first time it is needed */
+	if (zip->index == NULL && build_index(zip) != ZIPERR_NONE)
+		return NULL;
 
-	/* advance the position */
-	zip->cd_pos += zip->header.rawlength;
-	return &zip->header;
+	/* start at the head of the matching bucket */
+	zip->find_key = crc;
+	zip->find_entry = zip->index->crchead[crc & zip->index->mask];
+	return zip_file_next_crc(zip);
 }
 
 
+/*-------------------------------------------------
+    zip_file_next_crc - return the next file
+    matching an earlier zip_file_first_crc
+-------------------------------------------------*/
+
+const zip_file_header *zip_file_next_crc(zip_file *zip)
+{
+	zip_index *index = zip->index;
+
+	/* walk the bucket, skipping other CRCs that share it */
+	while (index != NULL && zip->find_entry != ZIP_INDEX_NONE)
+	{
+		UINT32 entry = zip->find_entry;
+		zip->find_entry = index->crcnext[entry];
+		if (read_dword(zip->cd + index->offset[entry] + ZIPCCRC) == zip->find_key)
+			return read_header(zip, index->offset[entry]);
+	}
+	return NULL;
+}
+
 /*-------------------------------------------------
     zip_file_decompress - decompress a file
     from a ZIP into the target buffer
@@ -404,6 +508,39 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
 
 
 
+/*-------------------------------------------------
+    zip_file_map - map a stored (uncompressed)
+    file from a ZIP straight into memory
+-------------------------------------------------*/
+
+zip_error zip_file_map(zip_file *zip, osd_file_mapping **mapping, void **base)
+{
+	zip_error ziperr;
+	UINT64 offset;
+
+	/* only stored data can be used in place */
+	if (zip->header.compression != 0 || zip->header.compressed_length != zip->header.uncompressed_length)
+		return ZIPERR_UNSUPPORTED;
+
+	/* make sure the info in the header aligns with what we know */
+	if (zip->header.start_disk_number != zip->ecd.disk_number)
+		return ZIPERR_UNSUPPORTED;
+
+	/* get the data offset */
+	ziperr = get_compressed_data_offset(zip, &offset);
+	if (ziperr != ZIPERR_NONE)
+		return ziperr;
+
+	/* the data must lie entirely within the file */
+	if (offset + zip->header.compressed_length > zip->length)
+		return ZIPERR_FILE_TRUNCATED;
+
+	if (osd_map(zip->file, offset, zip->header.compressed_length, mapping, base) != FILERR_NONE)
+		return ZIPERR_FILE_ERROR;
+	return ZIPERR_NONE;
+}
+
+
 /***************************************************************************
     CACHE MANAGEMENT
 ***************************************************************************/
@@ -425,11 +562,43 @@ static void free_zip_file(zip_file *zip)
 			free(zip->ecd.raw);
 		if (zip->cd != NULL)
 			free(zip->cd);
+		if (zip->index != NULL)
+			free(zip->index);
 		free(zip);
 	}
 }
 
 
+/*-------------------------------------------------
+    zip_file_bytes - return roughly how much
+    memory a zip_file holds
+-------------------------------------------------*/
+
+static UINT32 zip_file_bytes(zip_file *zip)
+{
+	UINT32 bytes = sizeof(*zip) + zip->ecd.rawlength + zip->ecd.cd_size;
+	if (zip->index != NULL)
+		bytes += sizeof(*zip->index) + (4 * zip->index->entries + 2 * (zip->index->mask + 1)) * sizeof(UINT32);
+	return bytes;
+}
+
+
+/*-------------------------------------------------
+    trim_cache - free the least recently closed
+    files until the cache is within its limits
+-------------------------------------------------*/
+
+static void trim_cache(void)
+{
+	while (zip_cache_count > 0 && (zip_cache_count > zip_cache_maxfiles || zip_cache_bytes > zip_cache_maxbytes))
+	{
+		zip_file *zip = zip_cache[--zip_cache_count];
+		zip_cache_bytes -= zip_file_bytes(zip);
+		free_zip_file(zip);
+	}
+}
+
+
 
 /***************************************************************************
     ZIP FILE PARSING
@@ -508,6 +677,118 @@ static zip_error read_ecd(zip_file *zip)
 }
 
 
+/*-------------------------------------------------
+    read_header - extract the central directory
+    entry at the given position into the current
+    header
+-------------------------------------------------*/
+
+static const zip_file_header *read_header(zip_file *zip, UINT32 pos)
+{
+	UINT8 *raw;
+
+	/* fix up any modified data */
+	if (zip->header.raw != NULL)
+	{
+		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
+		zip->header.raw = NULL;
+	}
+
+	/* if we're at or past the end, or the entry doesn't fit, we're done */
+	if (pos + ZIPCFN > zip->ecd.cd_size)
+		return NULL;
+	raw = zip->cd + pos;
+	if (pos + entry_length(raw) > zip->ecd.cd_size)
+		return NULL;
+
+	/* extract file header info */
+	zip->header.raw                 = raw;
+	zip->header.rawlength           = entry_length(raw);
+	zip->header.signature           = read_dword(raw + ZIPCENSIG);
+	zip->header.version_created     = read_word (raw + ZIPCVER);
+	zip->header.version_needed      = read_word (raw + ZIPCVXT);
+	zip->header.bit_flag            = read_word (raw + ZIPCFLG);
+	zip->header.compression         = read_word (raw + ZIPCMTHD);
+	zip->header.file_time           = read_word (raw + ZIPCTIM);
+	zip->header.file_date           = read_word (raw + ZIPCDAT);
+	zip->header.crc                 = read_dword(raw + ZIPCCRC);
+	zip->header.compressed_length   = read_dword(raw + ZIPCSIZ);
+	zip->header.uncompressed_length = read_dword(raw + ZIPCUNC);
+	zip->header.filename_length     = read_word (raw + ZIPCFNL);
+	zip->header.extra_field_length  = read_word (raw + ZIPCXTL);
+	zip->header.file_comment_length = read_word (raw + ZIPCCML);
+	zip->header.start_disk_number   = read_word (raw + ZIPDSK);
+	zip->header.internal_attributes = read_word (raw + ZIPINT);
+	zip->header.external_attributes = read_dword(raw + ZIPEXT);
+	zip->header.local_header_offset = read_dword(raw + ZIPOFST);
+	zip->header.filename            = (char *)raw + ZIPCFN;
+
+	/* NULL terminate the filename */
+	zip->header.saved = raw[ZIPCFN + zip->header.filename_length];
+	raw[ZIPCFN + zip->header.filename_length] = 0;
+
+	/* advance the position */
+	zip->cd_pos = pos + zip->header.rawlength;
+	return &zip->header;
+}
+
+
+/*-------------------------------------------------
+    build_index - hash the central directory by
+    leaf name and by CRC, so lookups don't have to
+    scan it
+-------------------------------------------------*/
+
+static zip_error build_index(zip_file *zip)
+{
+	UINT32 pos, entries, buckets, entry;
+	zip_index *index;
+
+	/* count the entries */
+	entries = 0;
+	for (pos = 0; pos + ZIPCFN <= zip->ecd.cd_size && pos + entry_length(zip->cd + pos) <= zip->ecd.cd_size; pos += entry_length(zip->cd + pos))
+		entries++;
+
+	/* aim for about one entry per bucket */
+	for (buckets = 16; buckets < entries; buckets <<= 1) ;
+
+	/* allocate everything in one block */
+	index = (zip_index *)malloc(sizeof(*index) + (4 * entries + 2 * buckets) * sizeof(UINT32));
+	if (index == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	index->entries = entries;
+	index->mask = buckets - 1;
+	index->offset = (UINT32 *)(index + 1);
+	index->namehash = index->offset + entries;
+	index->namenext = index->namehash + entries;
+	index->crcnext = index->namenext + entries;
+	index->namehead = index->crcnext + entries;
+	index->crchead = index->namehead + buckets;
+
+	/* record where each entry starts */
+	for (pos = 0, entry = 0; entry < entries; pos += entry_length(zip->cd + pos))
+		index->offset[entry++] = pos;
+
+	/* link the entries into their buckets back to front, so chains run in directory order */
+	for (entry = 0; entry < buckets; entry++)
+		index->namehead[entry] = index->crchead[entry] = ZIP_INDEX_NONE;
+	for (entry = entries; entry-- > 0; )
+	{
+		UINT8 *raw = zip->cd + index->offset[entry];
+		UINT32 crc = read_dword(raw + ZIPCCRC);
+
+		index->namehash[entry] = leaf_hash((const char *)raw + ZIPCFN, read_word(raw + ZIPCFNL));
+		index->namenext[entry] = index->namehead[index->namehash[entry] & index->mask];
+		index->namehead[index->namehash[entry] & index->mask] = entry;
+		index->crcnext[entry] = index->crchead[crc & index->mask];
+		index->crchead[crc & index->mask] = entry;
+	}
+
+	zip->index = index;
+	return ZIPERR_NONE;
+}
+
+
 /*-------------------------------------------------
     get_compressed_data_offset - return the
     offset of the compressed data
@@ -51,6 +51,10 @@
 
 #define ZIP_DECOMPRESS_BUFSIZE	16384
 
+/* default limits for the cache of closed ZIP files */
+#define ZIP_CACHE_DEFAULT_FILES	64
+#define ZIP_CACHE_DEFAULT_BYTES	(16 * 1024 * 1024)
+
 /* Error types */
 enum _zip_error
 {
@@ -120,6 +124,10 @@ struct _zip_ecd
 };
 
 
+/* hashed index of a central directory (opaque) */
+typedef struct _zip_index zip_index;
+
+
 /* describes an open ZIP file */
 typedef struct _zip_file zip_file;
 struct _zip_file
@@ -134,6 +142,10 @@ struct _zip_file
 	UINT32			cd_pos;					/* position in central directory */
 	zip_file_header	header;					/* current file header */
 
+	zip_index *		index;					/* index of the central directory, built on first lookup */
+	UINT32			find_entry;				/* next index entry to consider in a lookup */
+	UINT32			find_key;				/* name hash or CRC being looked up */
+
 	UINT8			buffer[ZIP_DECOMPRESS_BUFSIZE];	/* buffer for decompression */
 };
 
@@ -155,6 +167,9 @@ void zip_file_close(zip_file *zip);
 /* clear out all open ZIP files from the cache */
 void zip_file_cache_clear(void);
 
+/* limit how many closed ZIP files the cache keeps, and how much memory they may hold */
+void zip_file_cache_set_limits(int maxfiles, UINT32 maxbytes);
+
 
 /* ----- contained file access ----- */
 
@@ -164,8 +179,20 @@ const zip_file_header *zip_file_first_file(zip_file *zip);
 /* find the next file in the ZIP */
 const zip_file_header *zip_file_next_file(zip_file *zip);
 
+/* find the files whose names end in the same leaf name as 'filename', ignoring case; */
+/* candidates come back in directory order and may still need checking by the caller */
+const zip_file_header *zip_file_first_named(zip_file *zip, const char *filename);
+const zip_file_header *zip_file_next_named(zip_file *zip);
+
+/* find the files with the given CRC, in directory order */
+const zip_file_header *zip_file_first_crc(zip_file *zip, UINT32 crc);
+const zip_file_header *zip_file_next_crc(zip_file *zip);
+
 /* decompress the most recently found file in the ZIP */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
+/* map the most recently found file into memory, if it is stored uncompressed */
+zip_error zip_file_map(zip_file *zip, osd_file_mapping **mapping, void **base);
+
 
 #endif	/* __UNZIP_H__ */
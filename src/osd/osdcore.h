@@ -89,6 +89,9 @@ typedef enum _file_error file_error;
 /* osd_file is an opaque type which represents an open file */
 typedef struct _osd_file osd_file;
 
+/* osd_file_mapping is an opaque type which represents a view of a file mapped into memory */
+typedef struct _osd_file_mapping osd_file_mapping;
+
 /*-----------------------------------------------------------------------------
     osd_open: open a new file.
 
@@ -196,6 +199,57 @@ file_error osd_read(osd_file *file, void *buffer, UINT64 offset, UINT32 length,
 file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 length, UINT32 *actual);
 
 
+/*-----------------------------------------------------------------------------
+    osd_map: map part of an open file into memory
+
+    Parameters:
+
+        file - handle to a file previously opened via osd_open
+
+        offset - offset within the file where the view should start; this
+            need not be aligned in any way
+
+        length - number of bytes to map
+
+        mapping - pointer to an osd_file_mapping * to receive the mapping,
+            which must later be released via osd_unmap
+
+        base - pointer to a void * to receive the address of the data at
+            'offset'
+
+    Return value:
+
+        a file_error describing any error that occurred while mapping the
+        file, or FILERR_NONE if no error occurred
+
+    Notes:
+
+        The view is private and copy-on-write: it may be written freely,
+        but changes are never written back to the file. Pages that are
+        not written are backed by the file itself, so they can be shared
+        with other processes mapping the same file.
+
+        The view remains valid after the file is closed. Implementations
+        that cannot map files should return FILERR_FAILURE; callers are
+        expected to fall back to osd_read.
+-----------------------------------------------------------------------------*/
+file_error osd_map(osd_file *file, UINT64 offset, UINT32 length, osd_file_mapping **mapping, void **base);
+
+
+/*-----------------------------------------------------------------------------
+    osd_unmap: release a view created via osd_map
+
+    Parameters:
+
+        mapping - the mapping to release
+
+    Return value:
+
+        None
+-----------------------------------------------------------------------------*/
+void osd_unmap(osd_file_mapping *mapping);
+
+
 /*-----------------------------------------------------------------------------
     osd_rmfile: deletes a file
 
@@ -287,6 +341,7 @@ struct _osd_directory_entry
 	const char *		name;			/* name of the entry */
 	osd_dir_entry_type	type;			/* type of the entry */
 	UINT64				size;			/* size of the entry */
+	UINT64				modified;		/* opaque last-modified stamp, compared only for equality; 0 if unknown */
 };
 
 
@@ -134,6 +134,26 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 l
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+file_error osd_map(osd_file *file, UINT64 offset, UINT32 length, osd_file_mapping **mapping, void **base)
+{
+	// no mapping support; callers fall back to osd_read
+	return FILERR_FAILURE;
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(osd_file_mapping *mapping)
+{
+}
+
+
 //============================================================
 //  osd_rmfile
 //============================================================
@@ -183,6 +203,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = (char *)(result + 1);
 	result->type = ENTTYPE_NONE;
 	result->size = 0;
+	result->modified = 0;
 
 	FILE *f = fopen(path, "rb");
 	if (f != NULL)
@@ -50,6 +50,7 @@
 
 #define SDLOPTION_INIPATH				"inipath"
 #define SDLOPTION_AUDIO_LATENCY			"audio_latency"
+#define SDLOPTION_AUDIO_LOWLATENCY		"audio_lowlatency"
 #define SDLOPTION_SCREEN(x)				"screen" x
 #define SDLOPTION_ASPECT(x)				"aspect" x
 #define SDLOPTION_RESOLUTION(x)			"resolution" x
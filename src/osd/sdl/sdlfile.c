@@ -24,6 +24,9 @@
 #endif
 
 #include <sys/stat.h>
+#if !defined(SDLMAME_WIN32) && !defined(SDLMAME_OS2)
+#include <sys/mman.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -54,6 +57,16 @@ extern const char *sdlfile_ptty_identifier;
 
 #define NO_ERROR	(0)
 
+//============================================================
+//  TYPE DEFINITIONS
+//============================================================
+
+struct _osd_file_mapping
+{
+	void *	view;		// start of the mapped pages
+	size_t	length;		// length of the mapped pages
+};
+
 //============================================================
 //  Prototypes
 //============================================================
@@ -359,6 +372,64 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 c
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+file_error osd_map(osd_file *file, UINT64 offset, UINT32 length, osd_file_mapping **mapping, void **base)
+{
+#if defined(SDLMAME_WIN32) || defined(SDLMAME_OS2)
+	// no mmap here; callers fall back to reading
+	return FILERR_FAILURE;
+#else
+	UINT64 pagemask = sysconf(_SC_PAGESIZE) - 1;
+	UINT64 start = offset & ~pagemask;
+	void *view;
+
+	// only plain files can be mapped
+	if (file->type != SDLFILE_FILE || length == 0)
+		return FILERR_FAILURE;
+
+	// map whole pages around the requested range, copy-on-write; note that
+	// touching pages past the end of a file truncated meanwhile raises SIGBUS
+	*mapping = (osd_file_mapping *) osd_malloc(sizeof(**mapping));
+	if (*mapping == NULL)
+		return FILERR_OUT_OF_MEMORY;
+	(*mapping)->length = offset + length - start;
+#if defined(SDLMAME_DARWIN) || defined(SDLMAME_BSD) || defined(SDLMAME_NO64BITIO)
+	view = mmap(NULL, (*mapping)->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->handle, start);
+#elif defined(SDLMAME_UNIX)
+	view = mmap64(NULL, (*mapping)->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->handle, start);
+#else
+#error Unknown SDL SUBARCH!
+#endif
+	if (view == MAP_FAILED)
+	{
+		osd_free(*mapping);
+		*mapping = NULL;
+		return error_to_file_error(errno);
+	}
+
+	(*mapping)->view = view;
+	*base = (UINT8 *)view + (offset - start);
+	return FILERR_NONE;
+#endif
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(osd_file_mapping *mapping)
+{
+#if !defined(SDLMAME_WIN32) && !defined(SDLMAME_OS2)
+	munmap(mapping->view, mapping->length);
+	osd_free(mapping);
+#endif
+}
+
+
 //============================================================
 //  osd_close
 //============================================================
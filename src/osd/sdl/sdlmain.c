@@ -190,6 +190,7 @@ static const options_entry mame_sdl_options[] =
 	// sound options
 	{ NULL,                                   NULL,  OPTION_HEADER,     "SOUND OPTIONS" },
 	{ SDLOPTION_AUDIO_LATENCY,                "3",   0,                 "set audio latency (increase to reduce glitches, decrease for responsiveness)" },
+	{ SDLOPTION_AUDIO_LOWLATENCY,             "0",   0,                 "target audio latency in milliseconds, steered by rate control (0 = use audio_latency)" },
 
 	// keyboard mapping
 	{ NULL, 		                          NULL,  OPTION_HEADER,     "SDL KEYBOARD MAPPING" },
@@ -39,6 +39,13 @@ static int stream_loop = 0;
 // maximum audio latency
 #define MAX_AUDIO_LATENCY		10
 
+// low-latency mode: limits on the target latency in milliseconds, the largest
+// rate adjustment the control loop may apply, and how fast it tracks the fill level
+#define MIN_LOWLATENCY_MS		5
+#define MAX_LOWLATENCY_MS		200
+#define MAX_RATE_ADJUST			0.005
+#define FILL_SMOOTHING			0.05
+
 //============================================================
 //  LOCAL VARIABLES
 //============================================================
@@ -65,6 +72,16 @@ static FILE *sound_log;
 // sound enable
 static int snd_enabled;
 
+// low-latency mode
+static int				lowlatency_ms;				// target latency, or 0 if disabled
+static int				target_fill;				// target buffer fill, in bytes
+static double			fill_average;				// smoothed buffer fill, in bytes
+static double			rate_adjust;				// current ratio of input to output samples
+static double			resample_pos;				// fractional input position carried between updates
+static INT16			resample_last[2];			// last input sample of the previous update
+static INT16 *			resample_buffer;			// output of the rate control resampler
+static int				resample_buffer_samples;	// size of the resample buffer, in stereo samples
+
 //============================================================
 //  PROTOTYPES
 //============================================================
@@ -75,6 +92,7 @@ static int			sdl_create_buffers(void);
 static void			sdl_destroy_buffers(void);
 static void			sdl_cleanup_audio(running_machine &machine);
 static void			sdl_callback(void *userdata, Uint8 *stream, int len);
+static const INT16 *	rate_control(const INT16 *buffer, int *samples);
 
 
 
@@ -266,18 +284,27 @@ void sdl_osd_interface::update_audio_stream(const INT16 *buffer, int samples_thi
 	// if nothing to do, don't do it
 	if (machine().sample_rate != 0 && stream_buffer)
 	{
-		int bytes_this_frame = samples_this_frame * sizeof(INT16) * 2;
+		int bytes_this_frame;
 		int play_position, write_position, stream_in;
 		int orig_write; // used in LOG
 
+		// in low-latency mode, nudge the sample count to steer the buffer fill level
+		if (lowlatency_ms != 0 && stream_in_initialized)
+			buffer = rate_control(buffer, &samples_this_frame);
+		bytes_this_frame = samples_this_frame * sizeof(INT16) * 2;
+
 		play_position = stream_playpos;
 
-		write_position = stream_playpos + ((machine().sample_rate / 50) * sizeof(INT16) * 2);
+		write_position = stream_playpos + ((machine().sample_rate / machine().sound().update_frequency()) * sizeof(INT16) * 2);
 		orig_write = write_position;
 
 		if (!stream_in_initialized)
 		{
-			stream_in = stream_buffer_in = (write_position + stream_buffer_size) / 2;
+			// low-latency mode starts right at the target fill; otherwise start halfway round
+			if (lowlatency_ms != 0)
+				stream_in = stream_buffer_in = play_position + target_fill;
+			else
+				stream_in = stream_buffer_in = (write_position + stream_buffer_size) / 2;
 
 			if (LOG_SOUND)
 			{
@@ -339,6 +366,69 @@ void sdl_osd_interface::update_audio_stream(const INT16 *buffer, int samples_thi
 
 
 
+//============================================================
+//  rate_control - stretch or squeeze the incoming samples
+//  by a fraction of a percent so that the buffer fill
+//  level converges on the low-latency target instead of
+//  drifting into an underflow or overflow
+//============================================================
+
+static const INT16 *rate_control(const INT16 *buffer, int *samples)
+{
+	int sb_in = stream_buffer_in + (stream_loop ? stream_buffer_size : 0);
+	int fill = sb_in - stream_playpos;
+	int outsamples = 0;
+	int maxout;
+	double error;
+
+	// track the fill level and steer the ratio in proportion to the error
+	fill_average += (fill - fill_average) * FILL_SMOOTHING;
+	error = (fill_average - target_fill) / target_fill * MAX_RATE_ADJUST;
+	rate_adjust = 1.0 + ((error < -MAX_RATE_ADJUST) ? -MAX_RATE_ADJUST : (error > MAX_RATE_ADJUST) ? MAX_RATE_ADJUST : error);
+
+	// make sure we have room for the output
+	maxout = (int)(*samples / (1.0 - MAX_RATE_ADJUST)) + 2;
+	if (maxout > resample_buffer_samples)
+	{
+		if (resample_buffer != NULL)
+			global_free(resample_buffer);
+		resample_buffer = global_alloc_array(INT16, maxout * 2);
+		resample_buffer_samples = maxout;
+	}
+
+	// linearly interpolate; position 0 is the last sample of the previous
+	// update and position N is the last sample of this one
+	while (resample_pos < *samples)
+	{
+		int index = (int)resample_pos;
+		double frac = resample_pos - index;
+		const INT16 *s0 = (index == 0) ? resample_last : &buffer[(index - 1) * 2];
+		const INT16 *s1 = &buffer[index * 2];
+
+		resample_buffer[outsamples * 2 + 0] = (INT16)(s0[0] + (s1[0] - s0[0]) * frac);
+		resample_buffer[outsamples * 2 + 1] = (INT16)(s0[1] + (s1[1] - s0[1]) * frac);
+		outsamples++;
+		resample_pos += rate_adjust;
+	}
+	resample_pos -= *samples;
+
+	// remember where we left off
+	if (*samples > 0)
+	{
+		resample_last[0] = buffer[(*samples - 1) * 2 + 0];
+		resample_last[1] = buffer[(*samples - 1) * 2 + 1];
+	}
+
+	if (LOG_SOUND)
+		fprintf(sound_log, "rate control: fill %d (avg %.0f, target %d), ratio %.5f, %d -> %d samples\n",
+				fill, fill_average, target_fill, rate_adjust, *samples, outsamples);
+
+	*samples = outsamples;
+	return resample_buffer;
+}
+
+
+
 //============================================================
 //  set_mastervolume
 //============================================================
@@ -445,6 +535,18 @@ static int sdl_init(running_machine *machine)
 	stream_in_initialized = 0;
 	stream_loop = 0;
 
+	// in low-latency mode, ask SDL for transfers of no more than half the target
+	lowlatency_ms = options_get_int(&machine->options(), SDLOPTION_AUDIO_LOWLATENCY);
+	if (lowlatency_ms != 0)
+	{
+		if (lowlatency_ms < MIN_LOWLATENCY_MS)
+			lowlatency_ms = MIN_LOWLATENCY_MS;
+		else if (lowlatency_ms > MAX_LOWLATENCY_MS)
+			lowlatency_ms = MAX_LOWLATENCY_MS;
+		while (sdl_xfer_samples > 64 && sdl_xfer_samples * 2000 > machine->sample_rate * lowlatency_ms)
+			sdl_xfer_samples /= 2;
+	}
+
 	// set up the audio specs
 	aspec.freq = machine->sample_rate;
 	aspec.format = AUDIO_S16SYS;	// keep endian independent
@@ -482,6 +584,19 @@ static int sdl_init(running_machine *machine)
 	if (stream_buffer_size < 1024)
 		stream_buffer_size = 1024;
 
+	// in low-latency mode the buffer only needs to absorb a few video frames'
+	// worth of bursts around the target fill
+	if (lowlatency_ms != 0)
+	{
+		target_fill = machine->sample_rate * lowlatency_ms / 1000 * 2 * sizeof(INT16);
+		stream_buffer_size = (4 * target_fill + 4 * sdl_xfer_samples * 2 * sizeof(INT16) + 1023) / 1024 * 1024;
+		fill_average = target_fill;
+		rate_adjust = 1.0;
+		resample_pos = 0;
+		resample_last[0] = resample_last[1] = 0;
+		mame_printf_verbose("Audio: low-latency mode, target %d ms (%d bytes)\n", lowlatency_ms, target_fill);
+	}
+
 	// create the buffers
 	if (sdl_create_buffers())
 		goto cant_create_buffers;
@@ -541,5 +656,11 @@ static void sdl_destroy_buffers(void)
 	if (stream_buffer)
 		global_free(stream_buffer);
 	stream_buffer = NULL;
+
+	// release the rate control buffer
+	if (resample_buffer)
+		global_free(resample_buffer);
+	resample_buffer = NULL;
+	resample_buffer_samples = 0;
 }
 
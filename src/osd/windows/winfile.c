@@ -65,6 +65,11 @@ struct _osd_file
 	TCHAR		filename[1];
 };
 
+struct _osd_file_mapping
+{
+	void *		view;
+};
+
 
 
 //============================================================
@@ -241,6 +246,60 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 l
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+file_error osd_map(osd_file *file, UINT64 offset, UINT32 length, osd_file_mapping **mapping, void **base)
+{
+	SYSTEM_INFO info;
+	UINT64 start;
+	HANDLE section;
+	void *view;
+
+	if (length == 0)
+		return FILERR_FAILURE;
+
+	// views must start on an allocation granularity boundary
+	GetSystemInfo(&info);
+	start = offset - (offset % info.dwAllocationGranularity);
+
+	// create a copy-on-write section; the view keeps it alive once mapped
+	section = CreateFileMapping(file->handle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (section == NULL)
+		return win_error_to_file_error(GetLastError());
+	view = MapViewOfFile(section, FILE_MAP_COPY, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)(offset + length - start));
+	if (view == NULL)
+	{
+		DWORD error = GetLastError();
+		CloseHandle(section);
+		return win_error_to_file_error(error);
+	}
+	CloseHandle(section);
+
+	*mapping = (osd_file_mapping *)malloc(sizeof(**mapping));
+	if (*mapping == NULL)
+	{
+		UnmapViewOfFile(view);
+		return FILERR_OUT_OF_MEMORY;
+	}
+	(*mapping)->view = view;
+	*base = (UINT8 *)view + (offset - start);
+	return FILERR_NONE;
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(osd_file_mapping *mapping)
+{
+	UnmapViewOfFile(mapping->view);
+	free(mapping);
+}
+
+
 //============================================================
 //  osd_close
 //============================================================
@@ -455,6 +514,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = win_attributes_to_entry_type(find_data.dwFileAttributes);
 	result->size = find_data.nFileSizeLow | ((UINT64) find_data.nFileSizeHigh << 32);
+	result->modified = find_data.ftLastWriteTime.dwLowDateTime | ((UINT64) find_data.ftLastWriteTime.dwHighDateTime << 32);
 
 done:
 	if (t_path != NULL)
@@ -31,6 +31,7 @@
 
 // MAME/MAMEUI headers
 #include "unzip.h"
+#include "infocache.h"
 #include "sound/samples.h"
 #include "winutf8.h"
 #include "strconv.h"
@@ -522,83 +523,149 @@ int numberOfSpeakers(const machine_config *config)
 	return config->m_devicelist.count(SPEAKER);
 }
 
+static void GetDriversInfoFromConfig(const game_driver *gamedrv, struct DriversInfo *gameinfo)
+{
+	const rom_entry *region, *rom;
+	machine_config config(*gamedrv);
+	const rom_source *source;
+	int num_speakers;
+
+	gameinfo->isHarddisk = FALSE;
+	for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
+	{
+		for (region = rom_first_region(*source); region; region = rom_next_region(region))
+		{
+			if (ROMREGION_ISDISKDATA(region))
+				gameinfo->isHarddisk = TRUE;
+		}
+	}
+	gameinfo->hasOptionalBIOS = FALSE;
+	if (gamedrv->rom != NULL)
+	{
+		for (rom = gamedrv->rom; !ROMENTRY_ISEND(rom); rom++)
+		{
+			if (ROMENTRY_ISSYSTEM_BIOS(rom))
+			{
+				gameinfo->hasOptionalBIOS = TRUE;
+				break;
+			}
+		}
+	}
+
+	num_speakers = numberOfSpeakers(&config);
+
+	gameinfo->isStereo = (num_speakers > 1);
+	gameinfo->screenCount = numberOfScreens(&config);
+	gameinfo->isVector = isDriverVector(&config); // ((drv.video_attributes & VIDEO_TYPE_VECTOR) != 0);
+	gameinfo->usesRoms = FALSE;
+	for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
+	{
+		for (region = rom_first_region(*source); region; region = rom_next_region(region))
+		{
+			for (rom = rom_first_file(region); rom; rom = rom_next_file(rom))
+			{
+				gameinfo->usesRoms = TRUE; 
+				break; 
+			}
+		}
+	}
+	gameinfo->usesSamples = FALSE;
+	
+	{
+		const device_config_sound_interface *sound = NULL;
+		const char * const * samplenames = NULL;
+		for (bool gotone = config.m_devicelist.first(sound); gotone; gotone = sound->next(sound)) {
+			if (sound->devconfig().type() == SAMPLES)
+			{
+				const samples_interface *intf = (const samples_interface *)sound->devconfig().static_config();
+				samplenames = intf->samplenames;
+
+				if (samplenames != 0 && samplenames[0] != 0)
+				{
+					gameinfo->usesSamples = TRUE;
+					break;
+				}			
+			}				
+		}
+	}
+
+	gameinfo->usesTrackball = FALSE;
+	gameinfo->usesLightGun = FALSE;
+	gameinfo->usesMouse = FALSE;
+	if (gamedrv->ipt != NULL)
+	{
+		const input_port_config *port;
+		ioport_list portlist;
+		
+		input_port_list_init(portlist, gamedrv->ipt, NULL, 0, FALSE, NULL);
+		for (device_config *cfg = config.m_devicelist.first(); cfg != NULL; cfg = cfg->next())
+		{
+			if (cfg->input_ports()!=NULL) {
+				input_port_list_init(portlist, cfg->input_ports(), NULL, 0, FALSE, cfg);
+			}
+		}
+
+		for (port = portlist.first(); port != NULL; port = port->next())
+		{
+			const input_field_config *field;
+			for (field = port->fieldlist; field != NULL; field = field->next)
+ 			{
+				UINT32 type;
+				type = field->type;
+				if (type == IPT_END)
+					break;
+				if (type == IPT_DIAL || type == IPT_PADDLE || 
+					type == IPT_TRACKBALL_X || type == IPT_TRACKBALL_Y ||
+					type == IPT_AD_STICK_X || type == IPT_AD_STICK_Y)
+					gameinfo->usesTrackball = TRUE;
+				if (type == IPT_LIGHTGUN_X || type == IPT_LIGHTGUN_Y)
+					gameinfo->usesLightGun = TRUE;
+				if (type == IPT_MOUSE_X || type == IPT_MOUSE_Y)
+					gameinfo->usesMouse = TRUE;
+			}
+		}
+	}
+}
+
+// mamep: the same from the precompiled driver info, without instantiating the machine config
+static void GetDriversInfoFromCache(const infocache_driver *cached, struct DriversInfo *gameinfo)
+{
+	gameinfo->isHarddisk = (cached->flags & INFOCACHE_FLAG_DISKS) ? TRUE : FALSE;
+	gameinfo->hasOptionalBIOS = (cached->flags & INFOCACHE_FLAG_BIOS_SETS) ? TRUE : FALSE;
+	gameinfo->isStereo = (cached->speakers > 1);
+	gameinfo->screenCount = cached->screens;
+	gameinfo->isVector = (cached->screens > 0 && cached->screentype == SCREEN_TYPE_VECTOR);
+	gameinfo->usesRoms = (cached->romcount > 0);
+	gameinfo->usesSamples = (cached->samples > 0);
+	gameinfo->usesTrackball = (cached->flags & (INFOCACHE_FLAG_DIAL | INFOCACHE_FLAG_PADDLE | INFOCACHE_FLAG_TRACKBALL | INFOCACHE_FLAG_AD_STICK)) ? TRUE : FALSE;
+	gameinfo->usesLightGun = (cached->flags & INFOCACHE_FLAG_LIGHTGUN) ? TRUE : FALSE;
+	gameinfo->usesMouse = (cached->flags & INFOCACHE_FLAG_MOUSE) ? TRUE : FALSE;
+}
+
 static struct DriversInfo* GetDriversInfo(int driver_index)
 {
 	if (drivers_info == NULL)
 	{
 		int ndriver;
 		drivers_info = (DriversInfo*)malloc(sizeof(struct DriversInfo) * GetNumGames());
+
+		// mamep: load (or build) the precompiled driver info
+		infocache_init(*MameUIGlobal(), TRUE);
+
 		for (ndriver = 0; ndriver < GetNumGames(); ndriver++)
 		{
 			const game_driver *gamedrv = drivers[ndriver];
 			struct DriversInfo *gameinfo = &drivers_info[ndriver];
-			const rom_entry *region, *rom;
-			machine_config config(*gamedrv);
-			const rom_source *source;
-			int num_speakers;
+			const infocache_driver *cached = infocache_get(ndriver);
 
 			gameinfo->isClone = (GetParentRomSetIndex(gamedrv) != -1);
 			gameinfo->isBroken = ((gamedrv->flags & GAME_NOT_WORKING) != 0);
 			gameinfo->supportsSaveState = ((gamedrv->flags & GAME_SUPPORTS_SAVE) != 0);
-			gameinfo->isHarddisk = FALSE;
 			gameinfo->isVertical = (gamedrv->flags & ORIENTATION_SWAP_XY) ? TRUE : FALSE;
-			for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
-			{
-				for (region = rom_first_region(*source); region; region = rom_next_region(region))
-				{
-					if (ROMREGION_ISDISKDATA(region))
-						gameinfo->isHarddisk = TRUE;
-				}
-			}
-			gameinfo->hasOptionalBIOS = FALSE;
-			if (gamedrv->rom != NULL)
-			{
-				for (rom = gamedrv->rom; !ROMENTRY_ISEND(rom); rom++)
-				{
-					if (ROMENTRY_ISSYSTEM_BIOS(rom))
-					{
-						gameinfo->hasOptionalBIOS = TRUE;
-						break;
-					}
-				}
-			}
-
-			num_speakers = numberOfSpeakers(&config);
-
-			gameinfo->isStereo = (num_speakers > 1);
-			gameinfo->screenCount = numberOfScreens(&config);
-			gameinfo->isVector = isDriverVector(&config); // ((drv.video_attributes & VIDEO_TYPE_VECTOR) != 0);
-			gameinfo->usesRoms = FALSE;
-			for (source = rom_first_source(config); source != NULL; source = rom_next_source(*source))
-			{
-				for (region = rom_first_region(*source); region; region = rom_next_region(region))
-				{
-					for (rom = rom_first_file(region); rom; rom = rom_next_file(rom))
-					{
-						gameinfo->usesRoms = TRUE; 
-						break; 
-					}
-				}
-			}
-			gameinfo->usesSamples = FALSE;
-			
-			{
-				const device_config_sound_interface *sound = NULL;
-				const char * const * samplenames = NULL;
-				for (bool gotone = config.m_devicelist.first(sound); gotone; gotone = sound->next(sound)) {
-					if (sound->devconfig().type() == SAMPLES)
-					{
-						const samples_interface *intf = (const samples_interface *)sound->devconfig().static_config();
-						samplenames = intf->samplenames;
-
-						if (samplenames != 0 && samplenames[0] != 0)
-						{
-							gameinfo->usesSamples = TRUE;
-							break;
-						}			
-					}				
-				}
-			}
+			if (cached != NULL)
+				GetDriversInfoFromCache(cached, gameinfo);
+			else
+				GetDriversInfoFromConfig(gamedrv, gameinfo);
 			gameinfo->numPlayers = 0;
 			gameinfo->numButtons = 0;
 			memset(gameinfo->usesController, 0, sizeof gameinfo->usesController);
@@ -668,42 +735,6 @@ static struct DriversInfo* GetDriversInfo(int driver_index)
 					}
 				}
 			}
-
-			gameinfo->usesTrackball = FALSE;
-			gameinfo->usesLightGun = FALSE;
-			if (gamedrv->ipt != NULL)
-			{
-				const input_port_config *port;
-				ioport_list portlist;
-				
-				input_port_list_init(portlist, gamedrv->ipt, NULL, 0, FALSE, NULL);
-				for (device_config *cfg = config.m_devicelist.first(); cfg != NULL; cfg = cfg->next())
-				{
-					if (cfg->input_ports()!=NULL) {
-						input_port_list_init(portlist, cfg->input_ports(), NULL, 0, FALSE, cfg);
-					}
-				}
-
-				for (port = portlist.first(); port != NULL; port = port->next())
-				{
-					const input_field_config *field;
-					for (field = port->fieldlist; field != NULL; field = field->next)
- 					{
-						UINT32 type;
-						type = field->type;
-						if (type == IPT_END)
-							break;
-						if (type == IPT_DIAL || type == IPT_PADDLE || 
-							type == IPT_TRACKBALL_X || type == IPT_TRACKBALL_Y ||
-							type == IPT_AD_STICK_X || type == IPT_AD_STICK_Y)
-							gameinfo->usesTrackball = TRUE;
-						if (type == IPT_LIGHTGUN_X || type == IPT_LIGHTGUN_Y)
-							gameinfo->usesLightGun = TRUE;
-						if (type == IPT_MOUSE_X || type == IPT_MOUSE_Y)
-							gameinfo->usesMouse = TRUE;
-					}
-				}
-			}
 		}
 		UpdateController();
 	}
@@ -49,6 +49,8 @@
 // MAME/MAMEUI headers
 #include "emu.h"
 #include "emuopts.h"
+#include "hashcache.h"
+#include "infocache.h"
 #include "osdepend.h"
 #include "unzip.h"
 #include "winutf8.h"
@@ -2886,6 +2888,10 @@ static void Win32UI_exit()
 	//mamep: in datafile.c
 	winui_datafile_exit();
 
+	/* write out any hashes verified by audits */
+	hashcache_exit();
+	infocache_exit();
+
 	if (g_bDoBroadcast == TRUE)
 	{
         ATOM a = GlobalAddAtomA("");
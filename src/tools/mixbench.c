@@ -0,0 +1,541 @@
+/***************************************************************************
+
+    mixbench.c
+
+    Benchmark for the sound core's gain/mix/clamp helpers, and for the
+    voice loops of the sample-playback chips that use sound/sampvoice.h;
+    those are checked bit-exact against the per-sample loops the chips
+    had before they were ported.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "osdcore.h"
+#include "mixutil.h"
+#include "sound/sampvoice.h"
+
+#define NUM_INPUTS				32
+#define UPDATES_PER_SECOND		50
+#define DEFAULT_SECONDS			10
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _mix_functions mix_functions;
+struct _mix_functions
+{
+	const char *	name;
+	void			(*scale)(INT32 *dest, const INT32 *src, INT32 gain, int count);
+	void			(*add)(INT32 *dest, const INT32 *src, int count);
+	void			(*clamp)(INT16 *dest, const INT32 *left, const INT32 *right, int count);
+};
+
+
+
+/***************************************************************************
+    CORE IMPLEMENTATION
+***************************************************************************/
+
+/* wrappers so that both versions can be called through pointers */
+static void generic_scale(INT32 *dest, const INT32 *src, INT32 gain, int count) { mix_scale_generic(dest, src, gain, count); }
+static void generic_add(INT32 *dest, const INT32 *src, int count) { mix_add_generic(dest, src, count); }
+static void generic_clamp(INT16 *dest, const INT32 *left, const INT32 *right, int count) { mix_clamp_interleave_generic(dest, left, right, count); }
+static void native_scale(INT32 *dest, const INT32 *src, INT32 gain, int count) { mix_scale(dest, src, gain, count); }
+static void native_add(INT32 *dest, const INT32 *src, int count) { mix_add(dest, src, count); }
+static void native_clamp(INT16 *dest, const INT32 *left, const INT32 *right, int count) { mix_clamp_interleave(dest, left, right, count); }
+
+static const mix_functions functions[] =
+{
+	{ "generic", generic_scale, generic_add, generic_clamp },
+	{ MIXUTIL_SSE2 ? "sse2" : "native", native_scale, native_add, native_clamp }
+};
+
+
+/*-------------------------------------------------
+    run_mix - mix 'seconds' worth of NUM_INPUTS
+    inputs at the given rate the way the sound
+    core does: scale each input by its gain, sum
+    them into the left or right bus, then clamp;
+    returns the elapsed ticks and fills in a
+    checksum of the output
+-------------------------------------------------*/
+
+static osd_ticks_t run_mix(const mix_functions *funcs, INT32 **inputs, int rate, int seconds, UINT32 *checksum)
+{
+	int samples = rate / UPDATES_PER_SECOND;
+	INT32 *scaled = (INT32 *)malloc(samples * sizeof(*scaled));
+	INT32 *left = (INT32 *)malloc(samples * sizeof(*left));
+	INT32 *right = (INT32 *)malloc(samples * sizeof(*right));
+	INT16 *final = (INT16 *)malloc(samples * 2 * sizeof(*final));
+	osd_ticks_t start;
+	int update, inpnum, sampnum;
+
+	*checksum = 0;
+	start = osd_ticks();
+	for (update = 0; update < seconds * UPDATES_PER_SECOND; update++)
+	{
+		memset(left, 0, samples * sizeof(*left));
+		memset(right, 0, samples * sizeof(*right));
+		for (inpnum = 0; inpnum < NUM_INPUTS; inpnum++)
+		{
+			(*funcs->scale)(scaled, inputs[inpnum] + (update % UPDATES_PER_SECOND) * samples, 0x40 + inpnum * 4, samples);
+			(*funcs->add)((inpnum & 1) ? right : left, scaled, samples);
+		}
+		(*funcs->clamp)(final, left, right, samples);
+
+		/* fold the output into the checksum so the work can't be optimized away */
+		for (sampnum = 0; sampnum < samples * 2; sampnum++)
+			*checksum = *checksum * 31 + (UINT16)final[sampnum];
+	}
+	start = osd_ticks() - start;
+
+	free(final);
+	free(right);
+	free(left);
+	free(scaled);
+	return start;
+}
+
+
+/*-------------------------------------------------
+    print_result - print one timing line and
+    compare the checksum against the generic one
+-------------------------------------------------*/
+
+static int print_result(const char *name, osd_ticks_t ticks, int rate, int seconds, UINT32 checksum, UINT32 reference)
+{
+	double secs = (double)ticks / (double)osd_ticks_per_second();
+	printf("  %-14s %8.3f ms  %6.2f ns/sample  %7.1fx realtime  (checksum %08X)\n", name,
+			secs * 1000.0, secs * 1e9 / ((double)rate * seconds), (double)seconds / secs, checksum);
+	if (checksum != reference)
+	{
+		printf("  ** output differs from the generic version **\n");
+		return 1;
+	}
+	return 0;
+}
+
+
+/***************************************************************************
+    SAMPLE VOICE CHECKS
+
+    Each chip ported to the sampvoice.h kernels has two copies of its
+    voice loop below: the per-sample loop as it was before the port,
+    and the block loop the chip uses now. Both are run from the same
+    random voice state and sample ROM over random update lengths, and
+    their output and final voice state must match exactly. Keep the
+    "new" copies in step with the chips when changing them.
+***************************************************************************/
+
+#define VOICE_ROM_SIZE			0x10000
+#define VOICE_ROM_MASK			(VOICE_ROM_SIZE - 1)
+#define VOICE_TRIALS			256
+#define VOICE_TRIAL_SAMPLES		4800
+#define VOICE_MAX_UPDATE		2000
+
+typedef struct _voice_check voice_check;
+struct _voice_check
+{
+	const char *	name;
+	size_t			statesize;				/* size of the voice state */
+	void			(*randomize)(void *state, UINT32 *seed);
+	void			(*render_old)(void *state, INT32 *left, INT32 *right, int samples);
+	void			(*render_new)(void *state, INT32 *left, INT32 *right, int samples);
+};
+
+/* sample ROM shared by all voices, with some slack for reads just past the end */
+static UINT8 voice_rom[VOICE_ROM_SIZE + 16];
+
+
+/*-------------------------------------------------
+    voice_random - next value from a simple LCG
+-------------------------------------------------*/
+
+INLINE UINT32 voice_random(UINT32 *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+
+/*-------------------------------------------------
+    OKIM6295: 4-bit ADPCM, mono, volume / 2
+-------------------------------------------------*/
+
+typedef struct _oki_voice oki_voice;
+struct _oki_voice
+{
+	INT32			signal;
+	INT32			step;
+	int				playing;
+	UINT32			base_offset;
+	UINT32			sample;
+	UINT32			count;
+	INT8			volume;
+};
+
+static int oki_diff_lookup[49*16];
+static const INT8 oki_index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static void oki_compute_tables(void)
+{
+	static const INT8 nbl2bit[16][4] =
+	{
+		{ 1, 0, 0, 0}, { 1, 0, 0, 1}, { 1, 0, 1, 0}, { 1, 0, 1, 1},
+		{ 1, 1, 0, 0}, { 1, 1, 0, 1}, { 1, 1, 1, 0}, { 1, 1, 1, 1},
+		{-1, 0, 0, 0}, {-1, 0, 0, 1}, {-1, 0, 1, 0}, {-1, 0, 1, 1},
+		{-1, 1, 0, 0}, {-1, 1, 0, 1}, {-1, 1, 1, 0}, {-1, 1, 1, 1}
+	};
+	int step, nib;
+
+	for (step = 0; step <= 48; step++)
+	{
+		int stepval = floor(16.0 * pow(11.0 / 10.0, (double)step));
+		for (nib = 0; nib < 16; nib++)
+			oki_diff_lookup[step*16 + nib] = nbl2bit[nib][0] *
+				(stepval   * nbl2bit[nib][1] +
+				 stepval/2 * nbl2bit[nib][2] +
+				 stepval/4 * nbl2bit[nib][3] +
+				 stepval/8);
+	}
+}
+
+INLINE INT16 oki_clock(oki_voice *voice, UINT8 nibble)
+{
+	voice->signal += oki_diff_lookup[voice->step * 16 + (nibble & 15)];
+	if (voice->signal > 2047)
+		voice->signal = 2047;
+	else if (voice->signal < -2048)
+		voice->signal = -2048;
+
+	voice->step += oki_index_shift[nibble & 7];
+	if (voice->step > 48)
+		voice->step = 48;
+	else if (voice->step < 0)
+		voice->step = 0;
+	return voice->signal;
+}
+
+static void oki_randomize(void *state, UINT32 *seed)
+{
+	static const UINT8 volumes[] = { 0x20, 0x16, 0x10, 0x0b, 0x08, 0x06, 0x04, 0x03, 0x02 };
+	oki_voice *voice = (oki_voice *)state;
+
+	voice->signal = (voice_random(seed) & 0xfff) - 0x800;
+	voice->step = voice_random(seed) % 49;
+	voice->playing = (voice_random(seed) & 7) != 0;
+	voice->base_offset = voice_random(seed);
+	voice->count = voice_random(seed) % (VOICE_TRIAL_SAMPLES * 2);
+	voice->sample = voice_random(seed) % (voice->count + 2);
+	voice->volume = volumes[voice_random(seed) % ARRAY_LENGTH(volumes)];
+}
+
+static void oki_render_old(void *state, INT32 *buffer, INT32 *right, int samples)
+{
+	oki_voice *voice = (oki_voice *)state;
+
+	if (!voice->playing)
+		return;
+
+	while (samples-- != 0)
+	{
+		int nibble = voice_rom[(voice->base_offset + voice->sample / 2) & VOICE_ROM_MASK] >> (((voice->sample & 1) << 2) ^ 4);
+		*buffer++ += oki_clock(voice, nibble) * voice->volume / 2;
+		if (++voice->sample >= voice->count)
+		{
+			voice->playing = 0;
+			break;
+		}
+	}
+}
+
+static void oki_render_new(void *state, INT32 *buffer, INT32 *right, int samples)
+{
+	oki_voice *voice = (oki_voice *)state;
+
+	if (!voice->playing)
+		return;
+
+	while (samples != 0)
+	{
+		INT32 decoded[SAMPVOICE_BLOCK_SAMPLES];
+		UINT32 remaining = (voice->sample < voice->count) ? voice->count - voice->sample : 1;
+		int count = MIN(samples, SAMPVOICE_BLOCK_SAMPLES);
+		int sampnum;
+		if (count > (int)remaining)
+			count = remaining;
+
+		for (sampnum = 0; sampnum < count; sampnum++, voice->sample++)
+			decoded[sampnum] = oki_clock(voice, voice_rom[(voice->base_offset + voice->sample / 2) & VOICE_ROM_MASK] >> (((voice->sample & 1) << 2) ^ 4));
+
+		sampvoice_mix_mono(buffer, decoded, voice->volume, 1, count);
+		buffer += count;
+		samples -= count;
+
+		if (voice->sample >= voice->count)
+		{
+			voice->playing = 0;
+			break;
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+    SegaPCM: 8-bit PCM, stereo pan
+-------------------------------------------------*/
+
+typedef struct _segapcm_voice segapcm_voice;
+struct _segapcm_voice
+{
+	UINT8			regs[0x88];
+	UINT32			low;
+};
+
+static void segapcm_randomize(void *state, UINT32 *seed)
+{
+	segapcm_voice *voice = (segapcm_voice *)state;
+
+	memset(voice, 0, sizeof(*voice));
+	voice->regs[0x02] = voice_random(seed) & 0x7f;
+	voice->regs[0x03] = voice_random(seed) & 0x7f;
+	voice->regs[0x04] = voice_random(seed);
+	voice->regs[0x05] = voice_random(seed);
+	voice->regs[0x06] = voice_random(seed);
+	voice->regs[0x07] = voice_random(seed);
+	voice->regs[0x84] = voice_random(seed);
+	voice->regs[0x85] = voice->regs[0x06] - (voice_random(seed) & 3);
+	voice->regs[0x86] = voice_random(seed) & 3;
+	voice->low = voice_random(seed) & 0xff;
+}
+
+static void segapcm_render_old(void *state, INT32 *left, INT32 *right, int samples)
+{
+	segapcm_voice *voice = (segapcm_voice *)state;
+	UINT8 *regs = voice->regs;
+
+	if (!(regs[0x86]&1))
+	{
+		const UINT8 *rom = voice_rom;
+		UINT32 addr = (regs[0x85] << 16) | (regs[0x84] << 8) | voice->low;
+		UINT32 loop = (regs[0x05] << 16) | (regs[0x04] << 8);
+		UINT8 end = regs[6] + 1;
+		int i;
+
+		for (i = 0; i < samples; i++)
+		{
+			INT8 v = 0;
+
+			if ((addr >> 16) == end)
+			{
+				if (regs[0x86] & 2)
+				{
+					regs[0x86] |= 1;
+					break;
+				}
+				else addr = loop;
+			}
+
+			v = rom[(addr >> 8) & VOICE_ROM_MASK] - 0x80;
+
+			left[i] += v * regs[2];
+			right[i] += v * regs[3];
+			addr = (addr + regs[7]) & 0xffffff;
+		}
+
+		regs[0x84] = addr >> 8;
+		regs[0x85] = addr >> 16;
+		voice->low = regs[0x86] & 1 ? 0 : addr;
+	}
+}
+
+static void segapcm_render_new(void *state, INT32 *left, INT32 *right, int samples)
+{
+	segapcm_voice *voice = (segapcm_voice *)state;
+	UINT8 *regs = voice->regs;
+
+	if (!(regs[0x86]&1))
+	{
+		const UINT8 *rom = voice_rom;
+		UINT32 addr = (regs[0x85] << 16) | (regs[0x84] << 8) | voice->low;
+		UINT32 loop = (regs[0x05] << 16) | (regs[0x04] << 8);
+		UINT8 end = regs[6] + 1;
+		int i;
+
+		for (i = 0; i < samples && !(regs[0x86] & 1); )
+		{
+			INT32 pcm[SAMPVOICE_BLOCK_SAMPLES];
+			int count, blocksize = MIN(samples - i, SAMPVOICE_BLOCK_SAMPLES);
+
+			for (count = 0; count < blocksize; count++)
+			{
+				if ((addr >> 16) == end)
+				{
+					if (regs[0x86] & 2)
+					{
+						regs[0x86] |= 1;
+						break;
+					}
+					else addr = loop;
+				}
+
+				pcm[count] = (INT8)(rom[(addr >> 8) & VOICE_ROM_MASK] - 0x80);
+				addr = (addr + regs[7]) & 0xffffff;
+			}
+
+			sampvoice_mix_stereo(&left[i], &right[i], pcm, regs[2], regs[3], count);
+			i += count;
+		}
+
+		regs[0x84] = addr >> 8;
+		regs[0x85] = addr >> 16;
+		voice->low = regs[0x86] & 1 ? 0 : addr;
+	}
+}
+
+
+static const voice_check voice_checks[] =
+{
+	{ "okim6295", sizeof(oki_voice), oki_randomize, oki_render_old, oki_render_new },
+	{ "segapcm", sizeof(segapcm_voice), segapcm_randomize, segapcm_render_old, segapcm_render_new }
+};
+
+
+/*-------------------------------------------------
+    run_voice_check - run a chip's old and new
+    voice loops side by side from the same random
+    states over random update lengths; returns
+    non-zero if their output or state ever differ
+-------------------------------------------------*/
+
+static int run_voice_check(const voice_check *check, UINT32 *seed)
+{
+	void *oldstate = malloc(check->statesize);
+	void *newstate = malloc(check->statesize);
+	INT32 *oldbuf = (INT32 *)malloc(VOICE_MAX_UPDATE * 2 * sizeof(*oldbuf));
+	INT32 *newbuf = (INT32 *)malloc(VOICE_MAX_UPDATE * 2 * sizeof(*newbuf));
+	osd_ticks_t oldticks = 0, newticks = 0, start;
+	UINT64 total = 0;
+	int trial, mismatch = 0;
+
+	for (trial = 0; trial < VOICE_TRIALS && !mismatch; trial++)
+	{
+		int done = 0;
+
+		memset(oldstate, 0, check->statesize);
+		(*check->randomize)(oldstate, seed);
+		memcpy(newstate, oldstate, check->statesize);
+
+		while (done < VOICE_TRIAL_SAMPLES && !mismatch)
+		{
+			int samples = 1 + voice_random(seed) % VOICE_MAX_UPDATE;
+			int sampnum;
+
+			/* the voices accumulate, so start from something other than silence */
+			for (sampnum = 0; sampnum < samples * 2; sampnum++)
+				oldbuf[sampnum] = newbuf[sampnum] = (INT16)voice_random(seed);
+
+			start = osd_ticks();
+			(*check->render_old)(oldstate, oldbuf, oldbuf + samples, samples);
+			oldticks += osd_ticks() - start;
+
+			start = osd_ticks();
+			(*check->render_new)(newstate, newbuf, newbuf + samples, samples);
+			newticks += osd_ticks() - start;
+
+			if (memcmp(oldbuf, newbuf, samples * 2 * sizeof(*oldbuf)) != 0)
+			{
+				printf("  ** %s: output differs from the old voice loop in trial %d **\n", check->name, trial);
+				mismatch = 1;
+			}
+			else if (memcmp(oldstate, newstate, check->statesize) != 0)
+			{
+				printf("  ** %s: voice state differs from the old voice loop in trial %d **\n", check->name, trial);
+				mismatch = 1;
+			}
+			done += samples;
+		}
+		total += done;
+	}
+
+	printf("  %-14s old %6.2f ns/sample  new %6.2f ns/sample  (%s)\n", check->name,
+			(double)oldticks * 1e9 / ((double)osd_ticks_per_second() * total),
+			(double)newticks * 1e9 / ((double)osd_ticks_per_second() * total),
+			mismatch ? "DIFFERENT" : "identical");
+
+	free(newbuf);
+	free(oldbuf);
+	free(newstate);
+	free(oldstate);
+	return mismatch;
+}
+
+
+
+/*-------------------------------------------------
+    main - main entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	static const int rates[] = { 48000, 96000 };
+	int seconds = (argc > 1) ? atoi(argv[1]) : DEFAULT_SECONDS;
+	INT32 *inputs[NUM_INPUTS];
+	UINT32 seed = 0x12345678;
+	int result = 0;
+	unsigned int ratenum, funcnum, checknum;
+	int inpnum, sampnum;
+
+	if (seconds <= 0)
+	{
+		fprintf(stderr, "Usage:\n  mixbench [seconds]\n");
+		return 1;
+	}
+
+	for (ratenum = 0; ratenum < ARRAY_LENGTH(rates); ratenum++)
+	{
+		int rate = rates[ratenum];
+		UINT32 checksum[ARRAY_LENGTH(functions)];
+
+		/* one second of pseudo-random full-scale audio per input */
+		for (inpnum = 0; inpnum < NUM_INPUTS; inpnum++)
+		{
+			inputs[inpnum] = (INT32 *)malloc(rate * sizeof(INT32));
+			for (sampnum = 0; sampnum < rate; sampnum++)
+			{
+				seed = seed * 1103515245 + 12345;
+				inputs[inpnum][sampnum] = (INT16)(seed >> 16);
+			}
+		}
+
+		printf("%d Hz, %d inputs, %d seconds:\n", rate, NUM_INPUTS, seconds);
+		for (funcnum = 0; funcnum < ARRAY_LENGTH(functions); funcnum++)
+		{
+			osd_ticks_t ticks = run_mix(&functions[funcnum], inputs, rate, seconds, &checksum[funcnum]);
+			result |= print_result(functions[funcnum].name, ticks, rate, seconds, checksum[funcnum], checksum[0]);
+		}
+
+		for (inpnum = 0; inpnum < NUM_INPUTS; inpnum++)
+			free(inputs[inpnum]);
+	}
+
+	/* random sample ROM for the voice checks */
+	for (sampnum = 0; sampnum < (int)sizeof(voice_rom); sampnum++)
+		voice_rom[sampnum] = voice_random(&seed);
+	oki_compute_tables();
+
+	printf("Sample voices, %d trials of %d samples:\n", VOICE_TRIALS, VOICE_TRIAL_SAMPLES);
+	for (checknum = 0; checknum < ARRAY_LENGTH(voice_checks); checknum++)
+		result |= run_voice_check(&voice_checks[checknum], &seed);
+
+	return result;
+}
@@ -0,0 +1,599 @@
+/***************************************************************************
+
+    soundbench.c
+
+    Sound chip benchmark: replays a register write log recorded with
+    -soundlog through one of the Yamaha FM cores, outside of a running
+    machine, and reports how fast the core renders it. The output can
+    be written to a WAV file, and a checksum of it is printed so that
+    optimizations to a core can be verified bit-exact.
+
+    To check a change to a core, write a WAV file with the build before
+    it (-wav) and compare the build after it against that (-compare);
+    any differing sample is reported and the tool exits with an error.
+
+    The cores are compiled for this tool with FM_EMU defined, which
+    builds them without a machine behind them: chips are allocated from
+    the global pool, and there are no save states or machine timers.
+
+    Copyright Nicola Salmoria and the MAME Team.
+    Visit http://mamedev.org for licensing and usage restrictions.
+
+****************************************************************************/
+
+#include "emu.h"
+#include "sound/soundlog.h"
+#include "sound/wavwrite.h"
+#include "sound/ym2151.h"
+#include "sound/fm.h"
+#include "sound/fmopl.h"
+#include "sound/ymf262.h"
+
+#define MAX_OUTPUTS				4
+#define RENDER_CHUNK			1024
+#define DEFAULT_PASSES			3
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _replay_chip replay_chip;
+
+typedef struct _chip_interface chip_interface;
+struct _chip_interface
+{
+	const char *	name;					/* device name, as recorded in the log */
+	int				divider;				/* sample rate is clock / divider, as in the interface */
+	int				outputs;				/* number of stream outputs */
+	void *			(*start)(int clock, int rate);
+	void			(*reset)(void *chip);
+	void			(*stop)(void *chip);
+	void			(*write)(replay_chip *replay, offs_t offset, UINT8 data);
+	void			(*update)(void *chip, stream_sample_t **outputs, int samples);
+};
+
+struct _replay_chip
+{
+	const chip_interface *intf;				/* the core being replayed */
+	void *			chip;					/* its state */
+	UINT8			latch;					/* register latch for cores that don't keep one */
+};
+
+typedef struct _wav_compare wav_compare;
+struct _wav_compare
+{
+	const UINT8 *	data;					/* reference samples, 16-bit little-endian, interleaved */
+	UINT32			total;					/* number of samples there */
+	UINT32			position;				/* index of the next one to compare */
+	UINT32			mismatches;				/* number of samples that differ */
+	UINT32			first;					/* index of the first one that does */
+};
+
+typedef struct _replay_write replay_write;
+struct _replay_write
+{
+	UINT64			sample;					/* stream sample index at which the write happens */
+	offs_t			offset;					/* handler offset */
+	UINT8			data;					/* data written */
+};
+
+
+
+/***************************************************************************
+    CORE SUPPORT
+***************************************************************************/
+
+/*-------------------------------------------------
+    logerror - the cores log unimplemented
+    features as they run into them; a replay has
+    nowhere to send that
+-------------------------------------------------*/
+
+void CLIB_DECL logerror(const char *format, ...)
+{
+}
+
+
+
+/***************************************************************************
+    CHIP INTERFACES
+***************************************************************************/
+
+/* the YM2203's SSG half lives in a separate core; the replay leaves it silent */
+static void ssg_set_clock(void *param, int clock) { }
+static void ssg_write(void *param, int address, int data) { }
+static int ssg_read(void *param) { return 0; }
+static void ssg_reset(void *param) { }
+static const ssg_callbacks ssg_silent = { ssg_set_clock, ssg_write, ssg_read, ssg_reset };
+
+static void *ym2151_start(int clock, int rate) { return ym2151_init(NULL, clock, rate); }
+static void ym2151_bench_write(replay_chip *replay, offs_t offset, UINT8 data)
+{
+	if (offset & 1)
+		ym2151_write_reg(replay->chip, replay->latch, data);
+	else
+		replay->latch = data;
+}
+static void ym2151_update(void *chip, stream_sample_t **outputs, int samples) { ym2151_update_one(chip, outputs, samples); }
+
+static void *ym2203_start(int clock, int rate) { return ym2203_init(NULL, NULL, clock, rate, NULL, NULL, &ssg_silent); }
+static void ym2203_bench_write(replay_chip *replay, offs_t offset, UINT8 data) { ym2203_write(replay->chip, offset & 1, data); }
+static void ym2203_update(void *chip, stream_sample_t **outputs, int samples) { ym2203_update_one(chip, outputs[0], samples); }
+
+static void *ym2612_start(int clock, int rate) { return ym2612_init(NULL, NULL, clock, rate, NULL, NULL); }
+static void ym2612_bench_write(replay_chip *replay, offs_t offset, UINT8 data) { ym2612_write(replay->chip, offset & 3, data); }
+static void ym2612_update(void *chip, stream_sample_t **outputs, int samples) { ym2612_update_one(chip, outputs, samples); }
+
+static void *ym3526_start(int clock, int rate) { return ym3526_init(NULL, clock, rate); }
+static void ym3526_bench_write(replay_chip *replay, offs_t offset, UINT8 data) { ym3526_write(replay->chip, offset & 1, data); }
+static void ym3526_update(void *chip, stream_sample_t **outputs, int samples) { ym3526_update_one(chip, outputs[0], samples); }
+
+static void *ym3812_start(int clock, int rate) { return ym3812_init(NULL, clock, rate); }
+static void ym3812_bench_write(replay_chip *replay, offs_t offset, UINT8 data) { ym3812_write(replay->chip, offset & 1, data); }
+static void ym3812_update(void *chip, stream_sample_t **outputs, int samples) { ym3812_update_one(chip, outputs[0], samples); }
+
+static void *ymf262_start(int clock, int rate) { return ymf262_init(NULL, clock, rate); }
+static void ymf262_bench_write(replay_chip *replay, offs_t offset, UINT8 data) { ymf262_write(replay->chip, offset & 3, data); }
+static void ymf262_update(void *chip, stream_sample_t **outputs, int samples) { ymf262_update_one(chip, outputs, samples); }
+
+static const chip_interface chips[] =
+{
+	{ "YM2151", 64,  2, ym2151_start, ym2151_reset_chip, ym2151_shutdown, ym2151_bench_write, ym2151_update },
+	{ "YM2203", 72,  1, ym2203_start, ym2203_reset_chip, ym2203_shutdown, ym2203_bench_write, ym2203_update },
+	{ "YM2612", 72,  2, ym2612_start, ym2612_reset_chip, ym2612_shutdown, ym2612_bench_write, ym2612_update },
+	{ "YM3438", 72,  2, ym2612_start, ym2612_reset_chip, ym2612_shutdown, ym2612_bench_write, ym2612_update },
+	{ "YM3526", 72,  1, ym3526_start, ym3526_reset_chip, ym3526_shutdown, ym3526_bench_write, ym3526_update },
+	{ "YM3812", 72,  1, ym3812_start, ym3812_reset_chip, ym3812_shutdown, ym3812_bench_write, ym3812_update },
+	{ "YMF262", 288, 4, ymf262_start, ymf262_reset_chip, ymf262_shutdown, ymf262_bench_write, ymf262_update }
+};
+
+
+
+/***************************************************************************
+    LOG PARSING
+***************************************************************************/
+
+/*-------------------------------------------------
+    find_chip - return the interface for a
+    logged device name, or NULL
+-------------------------------------------------*/
+
+static const chip_interface *find_chip(const char *name)
+{
+	int chipnum;
+
+	for (chipnum = 0; chipnum < ARRAY_LENGTH(chips); chipnum++)
+		if (strcmp(chips[chipnum].name, name) == 0)
+			return &chips[chipnum];
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    time_to_sample - convert an emulated time to
+    a stream sample index, rounding the way
+    sound_stream does
+-------------------------------------------------*/
+
+static UINT64 time_to_sample(const UINT8 *record, int rate)
+{
+	UINT32 seconds = soundlog_get_32(&record[8]);
+	attoseconds_t attoseconds = soundlog_get_64(&record[12]);
+	return (UINT64)seconds * rate + attoseconds / (ATTOSECONDS_PER_SECOND / rate);
+}
+
+
+/*-------------------------------------------------
+    parse_log - pick a device out of the log and
+    extract its writes; returns the number of
+    writes or -1 on error
+-------------------------------------------------*/
+
+static int parse_log(const UINT8 *log, UINT32 length, const char *wanttag, const chip_interface **intf, UINT32 *clock, char *tag, replay_write **writes, UINT64 *endsample)
+{
+	const UINT8 *record = log + SOUNDLOG_HEADER_SIZE;
+	const UINT8 *end = log + length;
+	int devindex = -1, rate = 0, count = 0;
+
+	if (length < SOUNDLOG_HEADER_SIZE || memcmp(log, SOUNDLOG_MAGIC, 8) != 0 || soundlog_get_32(&log[8]) != SOUNDLOG_VERSION)
+	{
+		fprintf(stderr, "Not a version %d sound log\n", SOUNDLOG_VERSION);
+		return -1;
+	}
+
+	/* no device can have more writes than there are write records */
+	*writes = (replay_write *)malloc((length / SOUNDLOG_WRITE_SIZE + 1) * sizeof(**writes));
+	*endsample = 0;
+	while (record < end)
+	{
+		switch (record[0])
+		{
+			case SOUNDLOG_RECORD_DEVICE:
+			{
+				char devname[256], devtag[256];
+				const chip_interface *devintf;
+
+				if (end - record < SOUNDLOG_DEVICE_SIZE || end - record < SOUNDLOG_DEVICE_SIZE + record[2] + record[3])
+					goto truncated;
+				memcpy(devname, &record[SOUNDLOG_DEVICE_SIZE], record[2]);
+				devname[record[2]] = 0;
+				memcpy(devtag, &record[SOUNDLOG_DEVICE_SIZE + record[2]], record[3]);
+				devtag[record[3]] = 0;
+
+				/* take the requested device, or else the first one we can replay */
+				devintf = find_chip(devname);
+				printf("Device %d: %s '%s' at %d Hz%s\n", record[1], devname, devtag, soundlog_get_32(&record[4]), (devintf == NULL) ? " (not supported)" : "");
+				if (devindex == -1 && devintf != NULL && (wanttag == NULL || strcmp(wanttag, devtag) == 0))
+				{
+					devindex = record[1];
+					*intf = devintf;
+					*clock = soundlog_get_32(&record[4]);
+					strcpy(tag, devtag);
+					rate = *clock / devintf->divider;
+				}
+				record += SOUNDLOG_DEVICE_SIZE + record[2] + record[3];
+				break;
+			}
+
+			case SOUNDLOG_RECORD_WRITE:
+				if (end - record < SOUNDLOG_WRITE_SIZE)
+					goto truncated;
+				if (record[1] == devindex)
+				{
+					(*writes)[count].sample = time_to_sample(record, rate);
+					(*writes)[count].offset = soundlog_get_32(&record[4]);
+					(*writes)[count].data = record[2];
+					*endsample = (*writes)[count++].sample;
+				}
+				record += SOUNDLOG_WRITE_SIZE;
+				break;
+
+			case SOUNDLOG_RECORD_END:
+				if (end - record < SOUNDLOG_WRITE_SIZE)
+					goto truncated;
+				if (devindex != -1)
+					*endsample = time_to_sample(record, rate);
+				record += SOUNDLOG_WRITE_SIZE;
+				break;
+
+			default:
+				fprintf(stderr, "Unknown record type %d at offset %d\n", record[0], (int)(record - log));
+				free(*writes);
+				return -1;
+		}
+	}
+
+	if (devindex == -1)
+	{
+		free(*writes);
+		fprintf(stderr, (wanttag != NULL) ? "No supported device '%s' in the log\n" : "No supported device in the log\n", wanttag);
+		return -1;
+	}
+	return count;
+
+truncated:
+	/* a session that crashed leaves a partial record; replay what we have */
+	fprintf(stderr, "Log is truncated; replaying up to offset %d\n", (int)(record - log));
+	if (devindex == -1)
+	{
+		free(*writes);
+		return -1;
+	}
+	return count;
+}
+
+
+
+/***************************************************************************
+    REPLAY
+***************************************************************************/
+
+/*-------------------------------------------------
+    compare_chunk - check a chunk of output
+    against the reference WAV, clamped to 16 bits
+    and interleaved the way the WAV writer does
+-------------------------------------------------*/
+
+static void compare_chunk(wav_compare *compare, stream_sample_t **outputs, int channels, int samples)
+{
+	int sampnum, channum;
+
+	for (sampnum = 0; sampnum < samples; sampnum++)
+		for (channum = 0; channum < channels; channum++)
+		{
+			INT32 val = outputs[channum][sampnum];
+			INT16 sample = (val < -32768) ? -32768 : (val > 32767) ? 32767 : val;
+
+			/* anything past the end of the reference counts as a difference */
+			if (compare->position >= compare->total ||
+				(INT16)(compare->data[compare->position * 2] | (compare->data[compare->position * 2 + 1] << 8)) != sample)
+			{
+				if (compare->mismatches++ == 0)
+					compare->first = compare->position;
+			}
+			compare->position++;
+		}
+}
+
+
+/*-------------------------------------------------
+    render - generate samples into the output
+    buffers, folding them into the checksum and
+    optionally the WAV file or the comparison
+-------------------------------------------------*/
+
+static void render(replay_chip *replay, stream_sample_t **outputs, UINT64 samples, UINT32 *checksum, wav_file *wav, wav_compare *compare)
+{
+	int outputs_used = replay->intf->outputs;
+
+	while (samples > 0)
+	{
+		int chunk = (samples < RENDER_CHUNK) ? (int)samples : RENDER_CHUNK;
+		int outnum, sampnum;
+
+		(*replay->intf->update)(replay->chip, outputs, chunk);
+
+		/* fold the output into the checksum so the work can't be optimized away */
+		for (outnum = 0; outnum < outputs_used; outnum++)
+			for (sampnum = 0; sampnum < chunk; sampnum++)
+				*checksum = *checksum * 31 + outputs[outnum][sampnum];
+
+		if (wav != NULL)
+		{
+			if (outputs_used == 1)
+				wav_add_data_32(wav, outputs[0], chunk, 0);
+			else
+				wav_add_data_32lr(wav, outputs[0], outputs[1], chunk, 0);
+		}
+		if (compare != NULL)
+			compare_chunk(compare, outputs, (outputs_used == 1) ? 1 : 2, chunk);
+		samples -= chunk;
+	}
+}
+
+
+/*-------------------------------------------------
+    replay - play the writes through a freshly
+    started chip; returns the elapsed ticks
+-------------------------------------------------*/
+
+static osd_ticks_t replay(const chip_interface *intf, UINT32 clock, const replay_write *writes, int count, UINT64 endsample, UINT32 *checksum, wav_file *wav, wav_compare *compare)
+{
+	int rate = clock / intf->divider;
+	stream_sample_t *outputs[MAX_OUTPUTS];
+	replay_chip chip;
+	UINT64 cursample = 0;
+	osd_ticks_t start;
+	int outnum, writenum;
+
+	for (outnum = 0; outnum < MAX_OUTPUTS; outnum++)
+		outputs[outnum] = (stream_sample_t *)osd_malloc(RENDER_CHUNK * sizeof(stream_sample_t));
+
+	/* start and reset the chip the way its device does */
+	chip.intf = intf;
+	chip.latch = 0;
+	chip.chip = (*intf->start)(clock, rate);
+	(*intf->reset)(chip.chip);
+
+	*checksum = 0;
+	start = osd_ticks();
+	for (writenum = 0; writenum < count; writenum++)
+	{
+		/* catch the stream up to the write, just as the handler's stream update would */
+		if (writes[writenum].sample > cursample)
+		{
+			render(&chip, outputs, writes[writenum].sample - cursample, checksum, wav, compare);
+			cursample = writes[writenum].sample;
+		}
+		(*intf->write)(&chip, writes[writenum].offset, writes[writenum].data);
+	}
+	if (endsample > cursample)
+		render(&chip, outputs, endsample - cursample, checksum, wav, compare);
+	start = osd_ticks() - start;
+
+	(*intf->stop)(chip.chip);
+	for (outnum = 0; outnum < MAX_OUTPUTS; outnum++)
+		osd_free(outputs[outnum]);
+	return start;
+}
+
+
+/*-------------------------------------------------
+    load_file - read a whole log or WAV file into
+    memory; the buffer comes from the tracked
+    allocator that emu.h maps malloc to, unlike
+    core_fload's
+-------------------------------------------------*/
+
+static void *load_file(const char *filename, UINT32 *length)
+{
+	core_file *file;
+	void *log;
+
+	if (core_fopen(filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return NULL;
+
+	*length = (UINT32)core_fsize(file);
+	log = malloc(*length);
+	if (core_fread(file, log, *length) != *length)
+	{
+		free(log);
+		log = NULL;
+	}
+	core_fclose(file);
+	return log;
+}
+
+
+/*-------------------------------------------------
+    find_wav_data - locate the samples of a 16-bit
+    PCM WAV file with the given format; returns
+    FALSE if it isn't one
+-------------------------------------------------*/
+
+static int find_wav_data(const UINT8 *wav, UINT32 length, int rate, int channels, wav_compare *compare)
+{
+	UINT32 offset = 12;
+	int formatok = FALSE;
+
+	if (length < 12 || memcmp(&wav[0], "RIFF", 4) != 0 || memcmp(&wav[8], "WAVE", 4) != 0)
+		return FALSE;
+
+	/* walk the chunks, checking the format before taking the data */
+	while (offset + 8 <= length)
+	{
+		const UINT8 *chunk = &wav[offset];
+		UINT32 size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | (chunk[7] << 24);
+
+		if (size > length - offset - 8)
+			size = length - offset - 8;
+		if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+			formatok = ((chunk[8] | (chunk[9] << 8)) == 1 && (chunk[10] | (chunk[11] << 8)) == channels &&
+						(UINT32)(chunk[12] | (chunk[13] << 8) | (chunk[14] << 16) | (chunk[15] << 24)) == (UINT32)rate &&
+						(chunk[22] | (chunk[23] << 8)) == 16);
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (!formatok)
+				return FALSE;
+			memset(compare, 0, sizeof(*compare));
+			compare->data = chunk + 8;
+			compare->total = size / 2;
+			return TRUE;
+		}
+		offset += 8 + size + (size & 1);
+	}
+	return FALSE;
+}
+
+
+/*-------------------------------------------------
+    main - main entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	const char *logname = NULL, *wantname = NULL, *wavname = NULL, *comparename = NULL;
+	int passes = DEFAULT_PASSES;
+	const chip_interface *intf = NULL;
+	replay_write *writes;
+	UINT32 clock = 0, checksum, reference = 0, length;
+	UINT64 endsample;
+	osd_ticks_t best = 0;
+	char tag[256];
+	void *log;
+	int argnum, count, passnum, rate, result = 0;
+
+	/* parse the command line */
+	for (argnum = 1; argnum < argc; argnum++)
+	{
+		if (strcmp(argv[argnum], "-tag") == 0 && argnum + 1 < argc)
+			wantname = argv[++argnum];
+		else if (strcmp(argv[argnum], "-wav") == 0 && argnum + 1 < argc)
+			wavname = argv[++argnum];
+		else if (strcmp(argv[argnum], "-compare") == 0 && argnum + 1 < argc)
+			comparename = argv[++argnum];
+		else if (strcmp(argv[argnum], "-passes") == 0 && argnum + 1 < argc)
+			passes = atoi(argv[++argnum]);
+		else if (argv[argnum][0] != '-' && logname == NULL)
+			logname = argv[argnum];
+		else
+			logname = NULL, argnum = argc;
+	}
+	if (logname == NULL || passes <= 0)
+	{
+		fprintf(stderr, "Usage:\n  soundbench <logfile> [-tag <device>] [-wav <wavfile>] [-compare <wavfile>] [-passes <count>]\n");
+		return 1;
+	}
+
+	/* load the log and pull out the device's writes */
+	log = load_file(logname, &length);
+	if (log == NULL)
+	{
+		fprintf(stderr, "Error reading '%s'\n", logname);
+		return 1;
+	}
+	count = parse_log((const UINT8 *)log, length, wantname, &intf, &clock, tag, &writes, &endsample);
+	free(log);
+	if (count < 0)
+		return 1;
+	rate = clock / intf->divider;
+	printf("Replaying %s '%s': %d writes, %d samples at %d Hz (%.2f seconds)\n", intf->name, tag, count, (int)endsample, rate, (double)endsample / rate);
+
+	/* render once to the WAV file and/or against the reference WAV if asked; this pass isn't timed */
+	if (wavname != NULL || comparename != NULL)
+	{
+		int channels = (intf->outputs == 1) ? 1 : 2;
+		wav_file *wav = NULL;
+		wav_compare compare;
+		void *comparewav = NULL;
+
+		if (comparename != NULL)
+		{
+			UINT32 comparelength;
+			comparewav = load_file(comparename, &comparelength);
+			if (comparewav == NULL || !find_wav_data((const UINT8 *)comparewav, comparelength, rate, channels, &compare))
+			{
+				fprintf(stderr, "'%s' is not a %d Hz, %d-channel 16-bit WAV file\n", comparename, rate, channels);
+				if (comparewav != NULL)
+					free(comparewav);
+				free(writes);
+				return 1;
+			}
+		}
+		if (wavname != NULL)
+		{
+			wav = wav_open(wavname, rate, channels);
+			if (wav == NULL)
+			{
+				fprintf(stderr, "Error creating '%s'\n", wavname);
+				if (comparewav != NULL)
+					free(comparewav);
+				free(writes);
+				return 1;
+			}
+		}
+		replay(intf, clock, writes, count, endsample, &reference, wav, (comparewav != NULL) ? &compare : NULL);
+		if (wav != NULL)
+			wav_close(wav);
+
+		/* report how the output compares */
+		if (comparewav != NULL)
+		{
+			if (compare.position != compare.total)
+				printf("Output has %u samples, '%s' has %u\n", compare.position, comparename, compare.total);
+			if (compare.mismatches != 0)
+				printf("Output differs from '%s' in %u samples, first at sample %u (channel %u)\n", comparename,
+						compare.mismatches, compare.first / channels, compare.first % channels);
+			else if (compare.position == compare.total)
+				printf("Output matches '%s'\n", comparename);
+			if (compare.mismatches != 0 || compare.position != compare.total)
+				result = 1;
+			free(comparewav);
+		}
+	}
+
+	/* then time the requested number of passes */
+	for (passnum = 0; passnum < passes; passnum++)
+	{
+		osd_ticks_t ticks = replay(intf, clock, writes, count, endsample, &checksum, NULL, NULL);
+		double secs = (double)ticks / (double)osd_ticks_per_second();
+
+		printf("  pass %-3d %9.3f ms  %12.0f samples/sec  %7.1fx realtime  (checksum %08X)\n", passnum + 1,
+				secs * 1000.0, (double)endsample / secs, (double)endsample / rate / secs, checksum);
+		if (wavname == NULL && comparename == NULL && passnum == 0)
+			reference = checksum;
+		if (checksum != reference)
+		{
+			printf("  ** output differs from the first pass **\n");
+			result = 1;
+		}
+		if (passnum == 0 || ticks < best)
+			best = ticks;
+	}
+	printf("Best: %.0f samples/sec\n", (double)endsample * (double)osd_ticks_per_second() / (double)best);
+
+	free(writes);
+	return result;
+}
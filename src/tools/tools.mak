@@ -43,6 +43,7 @@ TOOLSOBJ = $(OBJ)/tools
 
 OBJDIRS += \
 	$(TOOLSOBJ) \
+	$(TOOLSOBJ)/fmemu \
 
 
 
@@ -61,6 +62,8 @@ TOOLS += \
 	srcclean$(EXE) \
 	src2html$(EXE) \
 	split$(EXE) \
+	mixbench$(EXE) \
+	soundbench$(EXE) \
 
 
 
@@ -192,3 +195,43 @@ SPLITOBJS = \
 split$(EXE): $(SPLITOBJS) $(LIBUTIL) $(LIBOCORE) $(ZLIB) $(EXPAT)
 	@echo Linking $@...
 	$(LD) $(LDFLAGS) $^ $(LIBS) -o $@
+
+
+
+#-------------------------------------------------
+# mixbench
+#-------------------------------------------------
+
+MIXBENCHOBJS = \
+	$(TOOLSOBJ)/mixbench.o \
+
+mixbench$(EXE): $(MIXBENCHOBJS) $(LIBUTIL) $(LIBOCORE) $(ZLIB) $(EXPAT)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(LIBS) -o $@
+
+
+
+#-------------------------------------------------
+# soundbench
+#-------------------------------------------------
+
+SOUNDBENCHOBJS = \
+	$(TOOLSOBJ)/soundbench.o \
+	$(TOOLSOBJ)/fmemu/ym2151.o \
+	$(TOOLSOBJ)/fmemu/fm.o \
+	$(TOOLSOBJ)/fmemu/fm2612.o \
+	$(TOOLSOBJ)/fmemu/fmopl.o \
+	$(TOOLSOBJ)/fmemu/ymf262.o \
+	$(TOOLSOBJ)/fmemu/ymdeltat.o \
+	$(SOUNDOBJ)/wavwrite.o \
+	$(EMUOBJ)/attotime.o \
+	$(EMUOBJ)/emualloc.o \
+
+soundbench$(EXE): $(SOUNDBENCHOBJS) $(LIBUTIL) $(LIBOCORE) $(ZLIB) $(EXPAT)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(LIBS) -o $@
+
+# the FM cores, built without a machine behind them
+$(TOOLSOBJ)/fmemu/%.o: $(EMUSRC)/sound/%.c | $(OSPREBUILD)
+	@echo Compiling $< for soundbench...
+	$(CC) $(CDEFS) -DFM_EMU $(CFLAGS) -c $< -o $@
@@ -39,3 +39,8 @@
 
 extern const char build_version[];
 const char build_version[] = "0.141u3 ("__DATE__")";
+
+/* this file is recompiled whenever anything else in the executable is, so
+   this tells two links apart; caches of driver data are keyed by it */
+extern const char build_stamp[];
+const char build_stamp[] = __DATE__ " " __TIME__;